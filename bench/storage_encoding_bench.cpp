@@ -0,0 +1,170 @@
+// 存储编码基准测试：比较 json / cbor / msgpack 编码 1000 篇文献的任务时的编解码吞吐量与数据大小
+//
+// 编译：cmake -DBUILD_BENCHMARKS=ON ... 后运行 build/storage_encoding_bench [轮数]
+
+#include "storage_manager.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+static const int RECORD_COUNT = 1000;
+
+static std::string makeText(std::mt19937& rng, const std::vector<std::string>& words, int count) {
+    std::string text;
+    for (int i = 0; i < count; i++) {
+        if (i > 0) text += ' ';
+        text += words[rng() % words.size()];
+    }
+    return text;
+}
+
+// 与 WoS 导出的记录规模相当的文献：标题约 15 词，摘要约 250 词，译文为中文
+static std::vector<LiteratureData> makeLiteratures() {
+    std::mt19937 rng(42);
+    std::vector<std::string> words = {
+        "analysis", "of", "the", "neural", "network", "model", "for", "thermal", "transport",
+        "in", "graphene", "based", "composite", "materials", "under", "high", "pressure",
+        "experimental", "results", "show", "significant", "improvement", "with", "respect", "to",
+        "conventional", "methods", "and", "structure", "properties", "were", "characterized"
+    };
+    std::vector<std::string> chineseWords = {
+        "基于", "神经网络", "模型", "的", "热输运", "分析", "石墨烯", "复合材料", "在", "高压",
+        "条件下", "实验", "结果", "表明", "相比", "传统方法", "显著", "提高", "结构", "性能"
+    };
+    
+    std::vector<LiteratureData> literatures;
+    for (int i = 0; i < RECORD_COUNT; i++) {
+        LiteratureData data;
+        data.index = i + 1;
+        data.recordNumber = i + 1;
+        data.totalRecords = RECORD_COUNT;
+        data.sourceFileName = "savedrecs.html";
+        data.sourceFileIndex = 1;
+        data.indexInFile = i + 1;
+        data.originalTitle = makeText(rng, words, 15);
+        data.originalAbstract = makeText(rng, words, 250);
+        data.translatedTitle = makeText(rng, chineseWords, 12);
+        data.translatedAbstract = makeText(rng, chineseWords, 200);
+        data.authors = "Zhang, W; Li, X; Wang, Y; Smith, J";
+        data.source = "JOURNAL OF APPLIED PHYSICS";
+        data.volume = std::to_string(100 + i % 30);
+        data.issue = std::to_string(1 + i % 12);
+        data.pages = std::to_string(1000 + i) + "-" + std::to_string(1010 + i);
+        data.doi = "10.1000/jap." + std::to_string(100000 + i);
+        data.publishedDate = "MAR 2024";
+        data.accessionNumber = "WOS:" + std::to_string(1000000000000LL + i);
+        data.issn = "0021-8979";
+        data.eissn = "1089-7550";
+        data.translatedByModel = "gpt-4o-mini";
+        data.status = "completed";
+        literatures.push_back(data);
+    }
+    return literatures;
+}
+
+static TaskConfig makeTaskConfig() {
+    TaskConfig config;
+    config.taskId = "2026-01-01/0001";
+    config.taskName = "基准测试任务";
+    config.fileName = "savedrecs.html";
+    config.fileNames = {"savedrecs.html"};
+    config.translateTitle = true;
+    config.translateAbstract = true;
+    config.modelConfig.url = "https://api.example.com/v1";
+    config.modelConfig.apiKey = "sk-benchmark";
+    config.modelConfig.modelId = "gpt-4o-mini";
+    config.modelConfig.systemPrompt = "You are a professional academic translator.";
+    config.totalCount = RECORD_COUNT;
+    config.completedCount = RECORD_COUNT;
+    config.status = "completed";
+    config.createdAt = "2026-01-01 00:00:00";
+    config.updatedAt = "2026-01-01 01:00:00";
+    config.sourceHash = std::string(64, 'a');
+    return config;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+    std::vector<LiteratureData> literatures = makeLiteratures();
+    TaskConfig config = makeTaskConfig();
+    
+    struct Encoding {
+        const char* name;
+        StorageEncoding encoding;
+    };
+    const Encoding encodings[] = {
+        {"json", StorageEncoding::Json},
+        {"cbor", StorageEncoding::Cbor},
+        {"msgpack", StorageEncoding::MessagePack}
+    };
+    
+    std::cout << RECORD_COUNT << " literature records, " << rounds << " rounds\n\n";
+    std::cout << std::left << std::setw(10) << "encoding" << std::right
+              << std::setw(14) << "records (B)" << std::setw(14) << "encode rec/s" << std::setw(14) << "decode rec/s"
+              << std::setw(13) << "config (B)" << std::setw(14) << "encode cfg/s" << std::setw(14) << "decode cfg/s"
+              << "\n";
+    
+    for (const auto& item : encodings) {
+        // 文献记录
+        std::vector<std::string> encoded(literatures.size());
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            for (size_t i = 0; i < literatures.size(); i++) {
+                encoded[i] = StorageManager::encodeLiteratureData(literatures[i], item.encoding);
+            }
+        }
+        double encodeSeconds = secondsSince(start);
+        
+        size_t totalBytes = 0;
+        for (const auto& data : encoded) {
+            totalBytes += data.size();
+        }
+        
+        size_t checksum = 0;
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++) {
+            for (const auto& data : encoded) {
+                checksum += StorageManager::decodeLiteratureData(data).originalAbstract.size();
+            }
+        }
+        double decodeSeconds = secondsSince(start);
+        
+        // 任务配置（每篇文献翻译完成时都会更新进度并保存一次）
+        int configRounds = rounds * RECORD_COUNT;
+        std::string configData;
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < configRounds; round++) {
+            configData = StorageManager::encodeTaskConfig(config, item.encoding);
+        }
+        double configEncodeSeconds = secondsSince(start);
+        
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < configRounds; round++) {
+            checksum += StorageManager::decodeTaskConfig(configData).taskId.size();
+        }
+        double configDecodeSeconds = secondsSince(start);
+        
+        double recordOps = static_cast<double>(rounds) * RECORD_COUNT;
+        std::cout << std::left << std::setw(10) << item.name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << totalBytes
+                  << std::setw(14) << recordOps / encodeSeconds
+                  << std::setw(14) << recordOps / decodeSeconds
+                  << std::setw(13) << configData.size()
+                  << std::setw(14) << configRounds / configEncodeSeconds
+                  << std::setw(14) << configRounds / configDecodeSeconds
+                  << "\n";
+        
+        if (checksum == 0) {
+            std::cerr << "decode produced no data\n";
+            return 1;
+        }
+    }
+    return 0;
+}
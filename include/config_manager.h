@@ -20,6 +20,12 @@ struct SystemConfig {
     int maxModelsPerTask = 5;            // 单任务最多使用模型数
     int maxRetries = 3;                  // 翻译重试次数
     int consecutiveFailureThreshold = 5; // 连续失败阈值
+    int translationBatchSize = 1;        // 批量翻译：每个请求最多包含的标题/摘要条数（1 = 逐条翻译）
+    int translationBatchTokens = 2000;   // 批量翻译：每个请求中原文的估算 token 数上限
+    bool translationCombined = false;    // 标题与摘要在同一个请求中翻译（否则两个请求同时发送）
+    bool translationCacheEnabled = true; // 译文缓存：相同的原文不再重复请求
+    int translationCacheMemoryMB = 64;   // 译文缓存内存层上限（MB）
+    int translationCacheDiskMB = 256;    // 译文缓存文件上限（MB）
     std::string adminPasswordHash = "";  // SHA-256哈希
     std::string passwordSalt = "";       // 密码盐值
     int serverPort = 8080;
@@ -32,6 +38,23 @@ struct SystemConfig {
     LogManageMode logManageMode = LogManageMode::AutoDelete;  // 日志管理模式
     int logRetentionDays = 7;            // 日志保留天数（定时删除模式）
     int logArchiveIntervalDays = 30;     // 日志归档间隔天数（定时归档模式）
+    
+    // HTTP 服务器配置
+    int httpWorkerThreads = 0;           // 请求处理线程数（0 = 自动）
+    int httpMaxPendingRequests = 256;    // 等待处理的请求队列上限，超出返回 503
+    int httpMaxStaticRequests = 32;      // 静态文件并发请求上限（0 = 不限制）
+    int httpMaxApiRequests = 32;         // 普通 API 并发请求上限
+    int httpMaxUploadRequests = 2;       // 上传/创建任务并发请求上限
+    int httpMaxExportRequests = 2;       // 导出/下载并发请求上限
+    int httpMaxRequestBodyMB = 64;       // 单个请求体大小上限（MB），超出返回 413
+    int httpCompressionLevel = 6;        // API 响应 gzip/deflate 压缩级别（1-9，0 = 不压缩）
+    int httpCompressionMinBytes = 1024;  // 响应体小于该字节数时不压缩
+    
+    // 存储配置
+    std::string storageDurability = "batched";  // 文件写入落盘方式：always / batched / os
+    int storageSyncIntervalMs = 1000;           // batched 模式的批量落盘间隔（毫秒）
+    std::string storageCompression = "none";    // 任务文件压缩方式：none / zlib
+    std::string storageEncoding = "json";       // 文献记录与任务配置的编码：json / cbor / msgpack
 };
 
 struct ModelConfig {
@@ -0,0 +1,64 @@
+#ifndef CURL_POOL_H
+#define CURL_POOL_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <curl/curl.h>
+
+// 按端点（协议 + 主机 + 端口）缓存可复用的 curl easy 句柄，所有 Translator 与线程共用。
+// 句柄归还后保留其连接缓存，同一端点的下一次请求直接复用已建立的 TCP/TLS 连接；
+// DNS 缓存与 TLS 会话通过 curl share 对象在全部句柄间共享，新建连接时也可省去解析和完整握手
+class CurlPool {
+public:
+    static CurlPool& getInstance();
+
+    // 借出的句柄，析构时归还到池中
+    class Handle {
+    public:
+        explicit Handle(const std::string& url);
+        ~Handle();
+
+        CURL* get() const { return curl_; }
+
+        // 请求成功完成后调用：统计本次请求是否复用了已有连接
+        void recordTransfer();
+
+    private:
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        std::string endpoint_;
+        CURL* curl_;
+    };
+
+private:
+    CurlPool();
+    ~CurlPool();
+
+    CurlPool(const CurlPool&) = delete;
+    CurlPool& operator=(const CurlPool&) = delete;
+
+    CURL* acquire(const std::string& endpoint);
+    void release(const std::string& endpoint, CURL* curl);
+    void record(const std::string& endpoint, bool reused);
+
+    static std::string endpointOf(const std::string& url);
+    static void lockShare(CURL* curl, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlockShare(CURL* curl, curl_lock_data data, void* userptr);
+
+    struct Endpoint {
+        std::vector<CURL*> idle;
+        uint64_t requests = 0;
+        uint64_t reused = 0;
+    };
+
+    std::mutex mutex_;
+    std::map<std::string, Endpoint> endpoints_;
+    CURLSH* share_;
+    std::mutex shareMutexes_[CURL_LOCK_DATA_LAST];  // 按共享的数据类型分别加锁
+};
+
+#endif // CURL_POOL_H
@@ -19,11 +19,19 @@ public:
         ExportFormat format,
         const std::string& originalFileName);
     
+    // 分块导出：依次拼接 beginExport、每篇文献的 exportRecord 和 endExport，结果与 exportLiteratures 相同，
+    // 可边读取文献边输出，不需要一次性生成完整内容
+    static std::string beginExport(ExportFormat format, size_t totalCount);
+    static std::string exportRecord(ExportFormat format, const LiteratureData& lit,
+                                    size_t position, size_t totalCount);
+    static std::string endExport(ExportFormat format, size_t totalCount);
+
 private:
-    static std::string exportToTxt(const std::vector<LiteratureData>& literatures);
-    static std::string exportToJson(const std::vector<LiteratureData>& literatures);
-    static std::string exportToCsv(const std::vector<LiteratureData>& literatures);
-    static std::string exportToHtml(const std::vector<LiteratureData>& literatures);
+    static std::string txtRecord(const LiteratureData& lit);
+    static std::string jsonRecord(const LiteratureData& lit);
+    static std::string csvRecord(const LiteratureData& lit);
+    static std::string htmlHeader(size_t totalCount);
+    static std::string htmlRecord(const LiteratureData& lit);
     
     static std::string escapeHtml(const std::string& text);
     static std::string escapeCsv(const std::string& text);
@@ -49,4 +49,20 @@ private:
     std::string decodeHtmlEntities(const std::string& text);
 };
 
+// 增量格式校验：数据按块输入（如上传过程中），结果与 HTMLParser::validate 一致，
+// 但不需要把完整文件读入内存
+class HTMLStreamValidator {
+public:
+    void feed(const char* data, size_t size);
+    bool isValid() const;
+    bool hasBinaryContent() const { return binary_; }  // 出现 NUL 字节，不是文本文件
+
+private:
+    std::string window_;          // 上一块的末尾，保证跨块边界的标记也能匹配
+    bool matched_ = false;
+    bool hasZhDi_ = false;
+    bool hasZhTiaoGong_ = false;
+    bool binary_ = false;
+};
+
 #endif // HTML_PARSER_H
@@ -0,0 +1,104 @@
+#ifndef LITERATURE_STORE_H
+#define LITERATURE_STORE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+
+// 单个任务的文献存储：全部文献记录追加写入同一个段文件，内存中维护 文献序号 -> 最新记录位置 的索引。
+// 记录格式为 [长度 u32][CRC32 u32][文献序号 i32][数据]（小端）；同一文献的旧记录在过期数据
+// 超过一半时压缩清除。
+// 记录数据对存储本身不透明，由 StorageManager 负责编码；启用压缩时较大的记录以 zlib 压缩后写入，
+// 长度字段的最高位标记压缩记录，未压缩的旧记录照常读取
+//
+// 翻译过程中的状态与译文变化以增量记录写入同目录的日志文件（.journal，记录格式相同）：
+// 增量先进入内存缓冲区，由 commitJournal() 一次写入并 fdatasync，多个线程的更新合并为一次落盘；
+// 读取时增量合并到段文件中的记录上。打开存储时重放日志并折叠进段文件
+class LiteratureStore {
+public:
+    // 将增量合并到完整记录上，合并后的记录数据写入 merged；记录或增量无法解码时返回 false，
+    // 此时读取返回未合并的记录，折叠日志时该增量不折叠，继续保留在日志中
+    using MergeFunction = std::function<bool(const std::string& payload, const std::string& delta, std::string& merged)>;
+    
+    LiteratureStore(const std::string& path, MergeFunction merge);
+    ~LiteratureStore();
+    
+    // 打开段文件与日志文件（不存在时创建）并扫描重建索引，日志中的增量折叠进段文件；
+    // 末尾不完整或校验失败的记录（写入过程中断）会被截断丢弃
+    bool open();
+    
+    bool put(int index, const std::string& payload);
+    bool putBatch(const std::vector<std::pair<int, std::string>>& records);
+    bool get(int index, std::string& payload);
+    
+    // 读取多条记录：按文件中的位置顺序读取，结果按 indices 的顺序返回，不存在的记录为空字符串
+    bool getMany(const std::vector<int>& indices, std::vector<std::string>& payloads);
+    
+    // 将已写入的记录落盘
+    bool sync();
+
+    // 记录增量：只写入内存缓冲区，读取时立即可见，落盘由 commitJournal() 完成
+    bool putDelta(int index, const std::string& delta);
+    
+    // 将缓冲区中的增量一次写入日志文件并落盘
+    bool commitJournal();
+    
+    // 将全部增量合并进段文件并落盘，之后清空日志文件
+    bool compactJournal();
+    
+    uint64_t journalBytes();
+
+    // 之后写入段文件的记录是否压缩（已有记录在压缩段文件时按新设置重写）
+    void setCompression(bool enabled) { compress_ = enabled; }
+
+    // 段文件与日志文件占用的字节数变化时的回调（参数为变化量），需在 open() 之前设置；
+    // 在持有存储锁的线程中调用
+    using SizeListener = std::function<void(int64_t delta)>;
+    void setSizeListener(SizeListener listener) { sizeListener_ = std::move(listener); }
+
+private:
+    struct RecordLocation {
+        uint64_t offset;   // 数据（不含记录头）在文件中的偏移
+        uint32_t length;   // 记录头中的长度字段，含压缩标记
+    };
+    
+    LiteratureStore(const LiteratureStore&) = delete;
+    LiteratureStore& operator=(const LiteratureStore&) = delete;
+    
+    bool scan();
+    bool scanJournal();
+    bool append(const std::vector<std::pair<int, std::string>>& records);
+    bool readAt(const RecordLocation& location, std::string& payload);
+    bool writeJournal();
+    bool foldJournal();
+    bool rewriteJournal();
+    void maybeCompact();
+    void reportSize();
+    
+    std::string path_;
+    std::string journalPath_;
+    MergeFunction merge_;
+    std::atomic<bool> compress_;
+    std::FILE* file_;
+    std::FILE* journal_;
+    std::mutex mutex_;
+    std::unordered_map<int, RecordLocation> index_;
+    uint64_t fileBytes_;   // 段文件大小
+    uint64_t liveBytes_;   // 最新记录（含记录头）占用的字节数
+    
+    // 尚未折叠进段文件的增量（文献序号 -> 最新增量）及尚未写入日志文件的编码记录
+    std::unordered_map<int, std::string> deltas_;
+    std::string journalBuffer_;
+    uint64_t journalBytes_;  // 日志文件大小
+    
+    SizeListener sizeListener_;
+    uint64_t reportedBytes_;  // 上次通知时段文件与日志文件的总大小
+};
+
+#endif // LITERATURE_STORE_H
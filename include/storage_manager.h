@@ -3,6 +3,19 @@
 
 #include <string>
 #include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <map>
+#include <set>
+#include <atomic>
+#include <unordered_map>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <future>
 #include "config_manager.h"
 #include "html_parser.h"
 
@@ -20,13 +33,14 @@ struct TaskConfig {
     bool translateAbstract;
     ModelConfig modelConfig;              // 兼容旧数据：单模型
     std::vector<ModelWithThreads> modelConfigs;  // 多模型支持
-    int totalCount;
-    int completedCount;
-    int failedCount;
+    int totalCount = 0;
+    int completedCount = 0;
+    int failedCount = 0;
     std::string status;
     std::string createdAt;
     std::string updatedAt;
     bool deleted = false;                 // 软删除标志
+    std::string sourceHash;               // 原始 HTML 的内容哈希（见 storeSourceBlob），旧版任务为空
 };
 
 struct LiteratureData {
@@ -68,20 +82,170 @@ struct LiteratureData {
     std::string errorMessage;
 };
 
+struct evp_md_ctx_st;
+class LiteratureStore;
+
+// 上传文件的流式写入器：数据按块写入上传暂存区（data/.uploads）的临时文件，同时计算 SHA-256；
+// commit() 后以内容哈希作为上传ID，未提交即销毁时删除临时文件
+class UploadWriter {
+public:
+    UploadWriter();
+    ~UploadWriter();
+    
+    bool open();
+    bool write(const char* data, size_t size);
+    std::string commit();  // 落盘并返回上传ID，失败时返回空字符串
+    size_t size() const { return size_; }
+
+private:
+    UploadWriter(const UploadWriter&) = delete;
+    UploadWriter& operator=(const UploadWriter&) = delete;
+    
+    std::FILE* file_;
+    evp_md_ctx_st* hashCtx_;
+    std::string tempPath_;
+    size_t size_;
+};
+
+// 文件的只读内存映射视图，销毁时解除映射。任务文件都以 rename 原子替换（见 writeFileAtomic），
+// 替换后已打开的视图仍指向旧文件的完整内容，不会读到写入中途的数据
+class MappedFile {
+public:
+    ~MappedFile();
+    
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    int64_t mtime() const { return mtime_; }  // 打开时文件的修改时间（纳秒）
+
+    // 内容编码：压缩保存的文件为 "gzip"，未压缩时为空
+    const std::string& encoding() const { return encoding_; }
+
+private:
+    friend class StorageManager;
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    int64_t mtime_ = 0;
+    std::string encoding_;
+};
+
+// 文件写入的落盘方式
+enum class StorageDurability {
+    Always,   // 每次写入都 fsync 文件和所在目录
+    Batched,  // 写入后立即替换，按间隔批量 fsync
+    Os        // 不主动 fsync，由操作系统回写
+};
+
+// 文献记录与任务配置的存储编码：二进制编码的数据以一个格式字节开头，读取时据此识别格式，
+// 没有格式字节的数据（旧版本写入的数据）按 JSON 读取
+enum class StorageEncoding {
+    Json,
+    Cbor,
+    MessagePack
+};
+
 class StorageManager {
+    friend class UploadWriter;
+
 public:
     static StorageManager& getInstance();
     
+    // 设置文件写入的落盘方式（"always" / "batched" / "os"）与批量落盘间隔
+    void setDurability(const std::string& mode, int syncIntervalMs);
+    
+    // 设置任务文件的压缩方式（"none" / "zlib"）：启用后 original.html、translated.html 以 gzip 格式
+    // 保存为 .gz 文件，文献记录在段文件中逐条压缩。每个文件或记录只在压缩后变小时使用压缩形式，
+    // 读取时按实际格式解码，未压缩的已有文件照常读取
+    void setCompression(const std::string& mode);
+    
+    // 设置文献记录（段文件与日志中的记录数据）和任务配置（config.json）的编码
+    // （"json" / "cbor" / "msgpack"）：之后写入的数据使用新编码，已有数据按各自的格式读取
+    void setEncoding(const std::string& mode);
+    
+    // 按编码序列化；反序列化时按格式字节识别编码，失败时抛出异常
+    static std::string encodeDocument(const json& j, StorageEncoding encoding);
+    static json decodeDocument(const std::string& data);
+    static std::string encodeLiteratureData(const LiteratureData& data, StorageEncoding encoding);
+    static LiteratureData decodeLiteratureData(const std::string& data);
+    static std::string encodeTaskConfig(const TaskConfig& config, StorageEncoding encoding);
+    static TaskConfig decodeTaskConfig(const std::string& data);
+    
+    // 原子写入文件：先写同目录下的临时文件再 rename 替换，写入中断时目标文件保持原内容
+    bool writeFileAtomic(const std::string& path, const std::string& content);
+    
     bool createTaskDirectory(const std::string& taskId);
+    
+    // 任务配置缓存在内存中：保存时同时写入 config.json 和缓存，读取时直接返回缓存，
+    // 只在首次读取或 config.json 被外部修改（按间隔检查修改时间与大小）时读取文件
     bool saveTaskConfig(const TaskConfig& config);
     TaskConfig loadTaskConfig(const std::string& taskId);
     
-    bool saveOriginalHtml(const std::string& taskId, const std::string& content);
+    // 任务配置保存成功后的回调（创建、状态与进度变化、软删除），在保存配置的线程中调用；
+    // 同一任务的回调按写入文件的顺序依次调用，回调中不能保存同一任务的配置
+    void setTaskConfigListener(std::function<void(const TaskConfig&)> listener);
+    
+    // 任务被永久删除后的回调
+    void setTaskRemovedListener(std::function<void(const std::string&)> listener);
+    
+    // 原始 HTML 以内容寻址方式保存在 data/.blobs/<SHA-256>.html，内容相同的任务共用一份文件，
+    // 任务配置的 sourceHash 指向所用的文件（旧版任务的 original.html 仍在任务目录中）。
+    // 引用计数保存在 data/.blobs/refs.json，最后一个引用的任务被永久删除时删除文件及其解析结果缓存
+    static std::string sha256Hex(const std::string& content);
+    
+    // 保存原始 HTML（已有相同内容时不再写入）并增加引用，返回内容哈希，失败时返回空字符串
+    std::string storeSourceBlob(const std::string& content);
+    std::string loadSourceBlob(const std::string& hash);
+    void releaseSourceBlob(const std::string& hash);
+    
     std::string loadOriginalHtml(const std::string& taskId);
     
+    // 以只读内存映射打开 original.html / translated.html，下载时直接发送映射的内容
+    // （压缩保存时映射的是 gzip 数据，见 MappedFile::encoding）；文件不存在或无法映射时返回空指针
+    std::shared_ptr<MappedFile> mapOriginalHtml(const std::string& taskId);
+    std::shared_ptr<MappedFile> mapTranslatedHtml(const std::string& taskId);
+    
+    // 按内容编码解码映射的文件，得到原始内容
+    static bool decodeMappedFile(const MappedFile& mapped, std::string& content);
+    
+    // 上传暂存区，上传ID为文件内容 SHA-256 的十六进制表示
+    static bool isValidUploadId(const std::string& uploadId);
+    std::string getUploadPath(const std::string& uploadId);
+    bool hasUpload(const std::string& uploadId);
+    std::string loadUpload(const std::string& uploadId);
+    
+    // 将上传文件存为原始 HTML 并增加引用，返回内容哈希（同 storeSourceBlob）：单文件直接重命名，
+    // 内容已存在时只删除上传文件；多文件按块拼接，上传文件保留到调用者解析后以 removeUploads 删除
+    std::string adoptUploads(const std::vector<std::string>& uploadIds, const std::vector<std::string>& fileNames);
+    void removeUploads(const std::vector<std::string>& uploadIds);
+    
+    // 原始 HTML 的解析结果缓存（按来源文件分组），与原始 HTML 文件一同删除
+    bool loadParseCache(const std::string& hash, std::vector<std::vector<Literature>>& files);
+    void saveParseCache(const std::string& hash, const std::vector<std::vector<Literature>>& files);
+    
+    // 删除超过一天未被使用的上传文件；由任务调度线程定期调用，距上次清理不足清理间隔时直接返回
+    int cleanupStaleUploads();
+    
+    // 文献数据保存在任务目录的段文件 literatures.seg 中（见 LiteratureStore），
+    // 旧版任务的 list/<序号>.json 在首次访问时迁移
     bool saveLiteratureData(const std::string& taskId, int index, const LiteratureData& data);
     LiteratureData loadLiteratureData(const std::string& taskId, int index);
     
+    // 只更新文献的状态与译文（status、errorMessage、译文、翻译模型），用于翻译过程中的状态变化：
+    // 以增量写入任务日志 literatures.journal，后台线程按间隔合并各线程的更新一次落盘
+    bool updateLiteratureStatus(const std::string& taskId, int index, const LiteratureData& data);
+    
+    // 批量保存（一次写入），用于保存解析结果或批量重置文献状态
+    bool saveLiteratureBatch(const std::string& taskId, const std::vector<LiteratureData>& literatures);
+    
+    // 按 index.json 的顺序读取任务的全部文献
+    std::vector<LiteratureData> loadAllLiteratureData(const std::string& taskId);
+    
+    // 按给定顺序读取一批文献（段文件中按偏移顺序一次读取），用于分块输出
+    std::vector<LiteratureData> loadLiteratureDataBatch(const std::string& taskId, const std::vector<int>& indices);
+    
     bool saveTranslatedHtml(const std::string& taskId, const std::string& content);
     std::string loadTranslatedHtml(const std::string& taskId);
     
@@ -100,9 +264,25 @@ public:
     // 永久删除所有已软删除的任务
     int permanentDeleteAllDeleted();
     
-    // 获取存储使用情况（data文件夹大小，单位字节）
+    // 获取存储使用情况（data文件夹大小，单位字节）：由写入与删除时更新的用量计数直接得出，
+    // 计数按任务和共享文件（上传暂存区、原始 HTML、目录文件等）分别累计，随任务目录文件保存
     uint64_t getStorageUsage();
     
+    // 用量计数的快照，供任务目录文件保存与恢复
+    struct StorageUsageSnapshot {
+        std::unordered_map<std::string, int64_t> tasks;
+        int64_t shared = 0;
+    };
+    bool getUsageSnapshot(StorageUsageSnapshot& snapshot);  // 计数尚未建立时返回 false
+    uint64_t getUsageVersion();                             // 计数每次变化加一
+    
+    // 恢复保存的计数；stale 为 true（例如上次未正常退出）时尽快重新扫描校正
+    void restoreUsage(const StorageUsageSnapshot& snapshot, bool stale);
+    
+    // 全量扫描 data 目录校正用量计数，修正计数与实际占用的偏差；
+    // force 为 false 时距上次校正不足间隔则直接返回（由调度线程定期调用）
+    void reconcileStorageUsage(bool force = false);
+    
     // 格式化存储大小
     static std::string formatStorageSize(uint64_t bytes);
     
@@ -110,12 +290,92 @@ public:
     
 private:
     StorageManager() = default;
-    ~StorageManager() = default;
+    ~StorageManager();
     
     StorageManager(const StorageManager&) = delete;
     StorageManager& operator=(const StorageManager&) = delete;
     
     std::string getTaskPath(const std::string& taskId);
+    bool readTaskConfigFile(const std::string& path, TaskConfig& config);
+    std::shared_ptr<MappedFile> mapFile(const std::string& path);
+    std::string getOriginalHtmlPath(const std::string& taskId);
+    std::string getBlobPath(const std::string& hash);
+    void saveBlobRefs();
+    void loadBlobRefs();
+    bool writeArtifact(const std::string& path, const std::string& content);
+    bool loadArtifact(const std::string& path, std::string& content);
+    bool compressArtifactFile(const std::string& path);
+    
+    std::shared_ptr<LiteratureStore> getLiteratureStore(const std::string& taskId);
+    std::shared_ptr<LiteratureStore> openLiteratureStore(const std::string& taskId);
+    void closeLiteratureStore(const std::string& taskId);
+    void migrateLegacyLiteratures(const std::string& taskId, LiteratureStore& store);
+    LiteratureData loadLegacyLiteratureData(const std::string& taskId, int index);
+    bool installFile(const std::string& tempPath, const std::string& path);
+    bool removeFile(const std::string& path);
+    void accountBytes(const std::string& path, int64_t delta);
+    void dropTaskUsage(const std::string& taskId);
+    void startSyncThread();
+    void syncLoop();
+    
+    // 存储用量计数（字节）。data/<日期>/<任务>/ 下的文件计入该任务，data 下的其他文件计入共享用量；
+    // 需先于文献存储声明，关闭文献存储时仍会写入剩余的增量
+    std::mutex usageMutex_;
+    std::unordered_map<std::string, int64_t> taskUsage_;
+    int64_t sharedUsage_ = 0;
+    int64_t totalUsage_ = 0;
+    uint64_t usageVersion_ = 0;
+    bool usageKnown_ = false;     // 已从目录文件恢复或扫描过
+    std::chrono::steady_clock::time_point usageReconcileDue_;
+    
+    // 下次清理上传暂存区的时间（只在任务调度线程中访问）
+    std::chrono::steady_clock::time_point uploadCleanupDue_;
+    
+    // 已打开的文献存储，超过上限时关闭最久未使用的
+    struct OpenStore {
+        std::shared_ptr<LiteratureStore> store;
+        uint64_t lastUsed;
+    };
+    std::mutex storeMutex_;
+    std::map<std::string, OpenStore> literatureStores_;
+    std::map<std::string, std::shared_future<std::shared_ptr<LiteratureStore>>> openingStores_;  // 正在打开的存储
+    uint64_t storeClock_ = 0;
+    
+    // 后台落盘线程：成组提交文献日志，batched 模式下批量 fsync 已替换的文件
+    std::mutex syncMutex_;
+    std::condition_variable syncCv_;
+    std::thread syncThread_;
+    bool syncRunning_ = false;
+    bool syncStopped_ = false;
+    bool journalPending_ = false;
+    std::chrono::steady_clock::time_point journalDeadline_;
+    std::set<std::string> pendingFileSyncs_;
+    std::chrono::steady_clock::time_point nextFileSync_;
+    std::atomic<StorageDurability> durability_{StorageDurability::Batched};
+    std::atomic<int> syncIntervalMs_{1000};
+    std::atomic<bool> compressArtifacts_{false};
+    std::atomic<StorageEncoding> encoding_{StorageEncoding::Json};
+    
+    // 任务配置缓存，以 config.json 的修改时间与大小作为版本，版本变化时重新读取。
+    // configMutex_ 只保护缓存与写锁表，读写文件时不持有；同一任务的保存由该任务的写锁串行
+    struct CachedTaskConfig {
+        TaskConfig config;
+        int64_t mtime;   // 纳秒
+        int64_t size;
+        std::chrono::steady_clock::time_point checkedAt;
+    };
+    std::mutex configMutex_;
+    std::unordered_map<std::string, CachedTaskConfig> configCache_;
+    std::unordered_map<std::string, std::shared_ptr<std::mutex>> configWriteMutexes_;
+    
+    // 原始 HTML 的引用计数（内容哈希 -> 引用的任务数），首次使用时从 refs.json 读取
+    std::mutex blobMutex_;
+    std::map<std::string, int> blobRefs_;
+    bool blobRefsLoaded_ = false;
+    
+    std::mutex listenerMutex_;
+    std::function<void(const TaskConfig&)> taskConfigListener_;
+    std::function<void(const std::string&)> taskRemovedListener_;
 };
 
 #endif // STORAGE_MANAGER_H
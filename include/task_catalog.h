@@ -0,0 +1,93 @@
+#ifndef TASK_CATALOG_H
+#define TASK_CATALOG_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include "nlohmann/json.hpp"
+
+enum class TaskStatus {
+    Parsing,
+    Pending,
+    Running,
+    Paused,
+    Completed,
+    Failed
+};
+
+struct TaskInfo {
+    std::string taskId;
+    std::string taskName;    // 任务名称
+    std::string fileName;
+    std::string modelName;   // 翻译模型名称（单模型时显示名称）
+    int modelCount = 1;      // 使用的模型数量
+    TaskStatus status;
+    int totalCount;
+    int completedCount;
+    int failedCount;
+    std::string createdAt;
+    std::string updatedAt;
+    bool deleted = false;
+};
+
+// 全部任务的摘要目录：常驻内存，按创建时间和状态建立索引，列出任务时不再遍历 data 目录。
+// 目录保存在 data/.catalog.json，修改后按间隔写入；每条记录附带写入时 config.json 的
+// 修改时间与大小，启动时据此核对，只重新读取发生变化的任务。
+// StorageManager 的存储用量计数也随目录文件保存，启动时恢复
+class TaskCatalog {
+public:
+    explicit TaskCatalog(const std::string& dataDir);
+    
+    // 读取目录文件并与 data 下的任务目录核对；目录文件中没有或 config.json 已变化的任务
+    // 用 loadInfo 重新读取，已不存在的任务从目录中移除
+    void load(const std::function<TaskInfo(const std::string&)>& loadInfo);
+    
+    void update(const TaskInfo& info);
+    void remove(const std::string& taskId);
+    
+    // 全部任务，按创建时间倒序（最新的在前）
+    std::vector<TaskInfo> list(bool includeDeleted);
+    
+    // 指定状态的未删除任务，按创建时间升序
+    std::vector<TaskInfo> listByStatus(TaskStatus status);
+    
+    // 有修改（含存储用量计数的变化）且距上次写入超过间隔时写入目录文件；
+    // force 为 true 时只要有修改就立即写入
+    void persist(bool force = false);
+
+private:
+    struct Entry {
+        TaskInfo info;
+        int64_t configMtime = -1;  // config.json 的修改时间（纳秒）与大小，-1 表示未知
+        int64_t configSize = -1;
+    };
+    
+    using CreatedKey = std::pair<std::string, std::string>;  // (createdAt, taskId)
+    
+    void insertEntry(const std::string& taskId, Entry entry);
+    void eraseEntry(const std::string& taskId);
+    bool readFile(nlohmann::json& usage);
+    std::string configPath(const std::string& taskId) const;
+    
+    std::string dataDir_;
+    std::string path_;
+    std::mutex persistMutex_;  // 串行写入目录文件，写入期间不持有 mutex_
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::set<CreatedKey> byCreatedAt_;
+    std::map<TaskStatus, std::set<CreatedKey>> byStatus_;  // 不含已删除的任务
+    
+    // 上次写入后修改过的任务（写入时重新记录其 config.json 的修改时间与大小）
+    std::set<std::string> changed_;
+    bool dirty_;
+    std::chrono::steady_clock::time_point persistedAt_;
+    uint64_t persistedUsageVersion_;  // 上次写入时存储用量计数的版本（见 StorageManager::getUsageVersion）
+};
+
+#endif // TASK_CATALOG_H
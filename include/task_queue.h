@@ -9,33 +9,11 @@
 #include <map>
 #include <atomic>
 #include <set>
+#include <functional>
 #include "storage_manager.h"
+#include "task_catalog.h"
 #include "translator.h"
 
-enum class TaskStatus {
-    Parsing,
-    Pending,
-    Running,
-    Paused,
-    Completed,
-    Failed
-};
-
-struct TaskInfo {
-    std::string taskId;
-    std::string taskName;    // 任务名称
-    std::string fileName;
-    std::string modelName;   // 翻译模型名称（单模型时显示名称）
-    int modelCount = 1;      // 使用的模型数量
-    TaskStatus status;
-    int totalCount;
-    int completedCount;
-    int failedCount;
-    std::string createdAt;
-    std::string updatedAt;
-    bool deleted = false;
-};
-
 class TaskQueue {
 public:
     static TaskQueue& getInstance();
@@ -49,8 +27,19 @@ public:
                                     const std::vector<std::string>& htmlContents,
                                     const TaskConfig& config);
     
+    // 从上传暂存区创建任务（文件已通过 /api/uploads 流式写入磁盘）
+    std::string createTaskFromUploads(const std::vector<std::string>& fileNames,
+                                      const std::vector<std::string>& uploadIds,
+                                      const TaskConfig& config);
+    
+    // 从任务目录读取，不访问磁盘
     std::vector<TaskInfo> listTasks(bool includeDeleted = false);
     TaskInfo getTaskInfo(const std::string& taskId);
+    
+    // 订阅任务变化（创建、状态与进度变化、软删除），回调在保存任务配置的线程中调用，应尽快返回；
+    // 返回的订阅ID用于取消订阅，取消后不会再有回调在执行
+    int addTaskListener(std::function<void(const TaskInfo&)> listener);
+    void removeTaskListener(int listenerId);
     std::vector<LiteratureData> getTaskLiteratures(const std::string& taskId);
     
     std::string getOriginalHtml(const std::string& taskId);
@@ -72,9 +61,13 @@ private:
     
     void schedulerLoop();  // 调度器循环
     void executeTask(const std::string& taskId, const std::string& modelId);  // 执行单个任务
-    void parseAndSaveTask(const std::string& taskId, const std::string& htmlContent);
+    // 解析原始 HTML 的各来源文件；内容哈希相同的文件解析过时直接使用缓存的结果，
+    // 不调用 loadContents 读取文件
+    std::vector<std::vector<Literature>> parseSources(const std::string& sourceHash,
+                                                      const std::function<std::vector<std::string>()>& loadContents);
+    void parseAndSaveTask(const std::string& taskId, const std::vector<Literature>& literatures);
     void parseAndSaveTaskMultiFile(const std::string& taskId, 
-                                   const std::vector<std::string>& htmlContents);
+                                   const std::vector<std::vector<Literature>>& fileLiteratures);
     void translateTask(const std::string& taskId);
     void translateTaskMultiThread(const std::string& taskId, int numThreads);
     void translateTaskContinuous(const std::string& taskId);  // 连续调度翻译
@@ -87,6 +80,8 @@ private:
     int getTotalRunningTasks();
     
     std::string generateTaskId();
+    static TaskInfo makeTaskInfo(const TaskConfig& config);
+    void notifyTaskListeners(const TaskConfig& config);
     
     std::thread schedulerThread_;  // 调度器线程
     std::mutex mutex_;
@@ -107,6 +102,14 @@ private:
     // 已经在调度中的任务（防止重复调度）
     std::set<std::string> scheduledTasks_;
     std::mutex scheduledMutex_;
+    
+    // 任务变化订阅者：订阅ID -> 回调
+    std::map<int, std::function<void(const TaskInfo&)>> taskListeners_;
+    int nextListenerId_ = 1;
+    std::mutex listenerMutex_;
+    
+    // 任务摘要目录，随任务配置的保存与删除更新
+    TaskCatalog catalog_;
 };
 
 #endif // TASK_QUEUE_H
@@ -0,0 +1,44 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <vector>
+#include <atomic>
+
+// 固定大小的工作线程池
+class ThreadPool {
+public:
+    // maxQueue 为等待队列上限，0 表示不限制
+    explicit ThreadPool(size_t numThreads, size_t maxQueue = 0);
+    ~ThreadPool();
+    
+    // 提交任务；线程池已关闭或等待队列已满时返回 false
+    bool submit(std::function<void()> job);
+    
+    // 停止接收新任务，执行完已排队的任务后退出所有线程
+    void shutdown();
+    
+    size_t threadCount() const { return workers_.size(); }
+    size_t pendingCount();
+    size_t activeCount() const { return active_.load(); }
+
+private:
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    void workerLoop();
+    
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t maxQueue_;
+    bool stopping_;
+    std::atomic<size_t> active_;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,99 @@
+#ifndef TRANSLATION_CACHE_H
+#define TRANSLATION_CACHE_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include "config_manager.h"
+
+// 译文缓存：以 (厂商, 模型, 系统提示词, 温度, 上下文, 原文) 的 SHA-256 为键保存成功的译文，
+// 翻译前先查缓存，相同的原文不再重复请求（重叠的检索结果、重置后重新翻译的任务）。
+// 两级存储：内存中按 LRU 保留最近使用的译文；全部译文追加写入 data/.translation_cache，
+// 记录格式为 [长度 u32][CRC32 u32][键 64 字节][译文]（小端），超过容量上限时重写文件，保留最近写入的译文。
+// 写入文件与重写文件都在后台写入线程中进行，store() 只更新内存层并排队，可在翻译引擎的事件线程中调用
+class TranslationCache {
+public:
+    static TranslationCache& getInstance();
+
+    // 开关与两级的容量上限（MB，0 表示该级不保存）；首次启用磁盘缓存时打开并扫描缓存文件
+    void configure(bool enabled, int memoryMB, int diskMB);
+
+    static std::string makeKey(const ModelConfig& model, const std::string& context, const std::string& text);
+
+    // 命中时填入 translation 并返回 true；未启用时返回 false 且不计入统计。
+    // 内存层未命中时读取缓存文件（重写文件期间需等待），不应在翻译引擎的事件线程中调用
+    bool lookup(const std::string& key, std::string& translation);
+
+    // 放入内存层，并交给写入线程追加到缓存文件
+    void store(const std::string& key, const std::string& translation);
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t memoryEntries = 0;
+        uint64_t memoryBytes = 0;
+        uint64_t diskEntries = 0;
+        uint64_t diskBytes = 0;
+    };
+    Stats getStats();
+
+private:
+    TranslationCache();
+    ~TranslationCache();
+
+    TranslationCache(const TranslationCache&) = delete;
+    TranslationCache& operator=(const TranslationCache&) = delete;
+
+    struct DiskLocation {
+        uint64_t offset;   // 译文（不含记录头）在文件中的偏移
+        uint32_t length;
+    };
+
+    bool openFile();
+    bool readAt(const DiskLocation& location, std::string& translation);
+    void remember(const std::string& key, const std::string& translation);
+    void trimMemory();
+    void writeLoop();
+    void appendRecords(const std::vector<std::pair<std::string, std::string>>& entries);
+    bool compact(uint64_t targetBytes);
+
+    std::string path_;
+
+    // mutex_ 保护内存层、磁盘索引与统计；fileMutex_ 保护缓存文件的读写与重写。
+    // 需要同时持有时先取 fileMutex_；磁盘索引与文件大小只在持有两者时修改，持有任一即可读取
+    std::mutex mutex_;
+    std::mutex fileMutex_;
+    bool enabled_;
+    uint64_t memoryLimit_;
+    uint64_t diskLimit_;
+
+    // 内存层：最近使用的在前
+    std::list<std::pair<std::string, std::string>> lru_;
+    std::unordered_map<std::string, std::list<std::pair<std::string, std::string>>::iterator> memory_;
+    uint64_t memoryBytes_;
+
+    // 磁盘层：键 -> 译文在缓存文件中的位置
+    std::FILE* file_;
+    bool fileOpened_;  // 已尝试打开（失败后不再重试，只使用内存层）
+    bool diskReady_;   // 缓存文件可用且写入线程已启动（由 mutex_ 保护）
+    std::unordered_map<std::string, DiskLocation> disk_;
+    uint64_t fileBytes_;
+
+    // 等待写入文件的译文（键, 译文），由写入线程取出
+    std::vector<std::pair<std::string, std::string>> pendingWrites_;
+    std::condition_variable writeCv_;
+    std::thread writer_;
+    bool stopping_;
+
+    uint64_t hits_;
+    uint64_t misses_;
+};
+
+#endif // TRANSLATION_CACHE_H
@@ -0,0 +1,106 @@
+#ifndef TRANSLATION_ENGINE_H
+#define TRANSLATION_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <functional>
+#include <curl/curl.h>
+#include "translator.h"
+#include "curl_pool.h"
+
+// 基于 curl_multi 的异步翻译引擎：一个事件线程同时驱动全部在途的翻译请求，
+// 在途请求数不再受线程数限制。请求的构建、响应解析与重试策略与 Translator::translate 相同，
+// 失败后的重试由定时器调度，不占用线程等待。
+// 与 Translator::translate 一样先查译文缓存（TranslationCache），批量与合并翻译按条目查询和写入
+class TranslationEngine {
+public:
+    using Callback = std::function<void(const TranslationResult&)>;
+    using BatchCallback = std::function<void(const std::vector<TranslationResult>&)>;
+    using CombinedCallback = std::function<void(const std::vector<TranslationResult>& titles,
+                                                const std::vector<TranslationResult>& abstracts)>;
+
+    static TranslationEngine& getInstance();
+
+    // 提交一次翻译（含重试），完成后在引擎线程中调用 done。
+    // done 中不应执行耗时操作（会阻塞其他请求的收发）；submit 会查询译文缓存并可能读取缓存文件，
+    // 回调中需要重新翻译时由引擎内部直接发送请求，成功的译文交给缓存的写入线程保存
+    void submit(const ModelConfig& model, const std::string& text, const std::string& context, Callback done);
+
+    // 同上，通过 future 取得结果
+    std::future<TranslationResult> submit(const ModelConfig& model, const std::string& text,
+                                          const std::string& context);
+
+    // 批量翻译：texts 按系统配置的条数与 token 上限分批，各批并发发送，返回中未通过校验的条目改为逐条翻译。
+    // 全部条目完成后在引擎线程中以与 texts 一一对应的结果调用 done；texts 不能为空
+    void submitBatch(const ModelConfig& model, const std::vector<std::string>& texts, const std::string& context,
+                     BatchCallback done);
+
+    // 合并翻译：每篇文献的标题与摘要在同一个请求中翻译（按同样的规则分批），
+    // 未通过校验的文献改为同时发送标题和摘要两个请求；titles 不能为空
+    void submitCombined(const ModelConfig& model, const std::vector<std::string>& titles,
+                        const std::vector<std::string>& abstracts, CombinedCallback done);
+
+private:
+    TranslationEngine();
+    ~TranslationEngine();  // 停止事件线程，尚未完成的请求以失败结束
+
+    TranslationEngine(const TranslationEngine&) = delete;
+    TranslationEngine& operator=(const TranslationEngine&) = delete;
+
+    struct Request {
+        Translator translator;
+        std::string context;
+        std::string url;
+        std::string body;
+        Callback done;
+        int maxRetries = 0;
+        int attempt = 0;
+        bool ready = false;  // 结果已确定（命中缓存），不发送请求，直接回调
+        TranslationResult result;
+
+        // 当前这次传输
+        std::unique_ptr<CurlPool::Handle> handle;
+        curl_slist* headers = nullptr;
+        std::string response;
+
+        explicit Request(const ModelConfig& model) : translator(model) {}
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    // maxRetries 由调用者在提交线程中读取：回调（事件线程）中提交的请求不再读取配置文件
+    void submitRequest(const ModelConfig& model, const std::string& body, const std::string& context,
+                       int maxRetries, Callback done);
+    void post(const ModelConfig& model, const TranslationResult& result, Callback done);
+
+    // 发送单条翻译请求（不查缓存），成功的译文以 key 写入缓存
+    void requestTranslation(const ModelConfig& model, const std::string& text, const std::string& context,
+                            const std::string& key, int maxRetries, Callback done);
+    void eventLoop();
+    void startTransfer(Request* request);
+    void finishTransfer(Request* request, CURLcode code);
+    void endTransfer(Request* request);
+    void retryOrComplete(Request* request, bool retryable, bool backoff);
+    void complete(Request* request);
+
+    CURLM* multi_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+
+    std::mutex mutex_;
+    std::vector<Request*> submitted_;  // 等待事件线程发起的请求
+
+    // 以下仅由事件线程访问
+    std::set<Request*> transfers_;  // 正在传输的请求
+    std::multimap<Clock::time_point, Request*> retryTimers_;  // 等待重试的请求，按到期时间排序
+};
+
+#endif // TRANSLATION_ENGINE_H
@@ -2,13 +2,16 @@
 #define TRANSLATOR_H
 
 #include <string>
+#include <vector>
+#include <utility>
+#include <curl/curl.h>
 #include "config_manager.h"
 
 struct TranslationResult {
-    bool success;
+    bool success = false;
     std::string translatedText;
     std::string errorMessage;
-    int retryCount;
+    int retryCount = 0;
 };
 
 struct TestConnectionResult {
@@ -25,8 +28,47 @@ public:
     TestConnectionResult testConnection();
     void setConfig(const ModelConfig& config);
     
+    // 以下供同步的 translate 与异步的 TranslationEngine 共用
+    std::string requestUrl() const;
+    std::string buildRequestBody(const std::string& text, const std::string& context) const;
+    
+    // 批量请求：多条标题或摘要合并为一个请求，要求以 JSON 字符串数组返回译文
+    std::string buildBatchRequestBody(const std::vector<std::string>& texts, const std::string& context) const;
+    
+    // 合并请求：每篇文献的标题与摘要在同一个请求中翻译，要求以 {"title", "abstract"} 对象数组返回
+    std::string buildCombinedRequestBody(const std::vector<std::string>& titles,
+                                         const std::vector<std::string>& abstracts) const;
+    curl_slist* buildHeaders() const;  // 调用者负责 curl_slist_free_all
+    
+    // 设置一次翻译请求的选项（超时、请求体、响应写入 responseData），参数须在请求结束前保持有效
+    static void setupTransfer(CURL* curl, const std::string& url, curl_slist* headers,
+                              const std::string& requestBody, std::string* responseData);
+    
+    // 解析已完成的请求：成功时填入 result.translatedText 并返回 true；
+    // 失败时填入 result.errorMessage，retryable 表示该错误是否值得重试
+    bool parseResponse(long httpCode, const std::string& responseData,
+                       TranslationResult& result, bool& retryable) const;
+    
+    // 第 attempt 次（从 0 开始）失败后的重试等待时间
+    static int retryDelaySeconds(int attempt);
+    
+    // 将原文长度为 sizes 的各条分为连续的批次 [first, second)：每批不超过 maxItems 条，
+    // 估算 token 数不超过 tokenBudget（单条超出时独占一批）
+    static std::vector<std::pair<size_t, size_t>> planBatches(const std::vector<size_t>& sizes,
+                                                              int maxItems, int tokenBudget);
+    
+    // 校验批量请求返回的译文数组：数组长度须与 results 相同，非空字符串的条目写入对应的 results[i]
+    // 并置 success，返回通过校验的条数
+    static size_t parseBatchOutput(const std::string& content, std::vector<TranslationResult>& results);
+    
+    // 校验合并请求返回的对象数组：title 与 abstract 均为非空字符串的条目写入 titles[i]、abstracts[i]，
+    // 返回通过校验的条数（只有一篇文献时也接受单个对象）
+    static size_t parseCombinedOutput(const std::string& content, std::vector<TranslationResult>& titles,
+                                      std::vector<TranslationResult>& abstracts);
+
 private:
-    TranslationResult translateWithRetry(const std::string& text, 
+    std::string buildChatRequestBody(const std::string& userPrompt) const;
+    TranslationResult translateWithRetry(const std::string& requestBody,
                                         const std::string& context,
                                         int maxRetries);
     
@@ -3,22 +3,73 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
 #include <functional>
 #include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <string_view>
+
+struct stat;
+class MappedFile;
+
+// 流式请求体的接收端：请求体在接收过程中按块交给 write()，不在内存中缓存
+class RequestBodySink {
+public:
+    virtual ~RequestBodySink() = default;
+    
+    // 写入一块请求体数据；返回 false 时以 errorStatus() 拒绝请求，原因由 error() 给出。
+    // 在 I/O 线程中调用，不应执行磁盘读写等耗时操作
+    virtual bool write(const char* data, size_t size) = 0;
+    virtual std::string error() const = 0;
+    virtual int errorStatus() const { return 400; }
+};
 
 struct HttpRequest {
     std::string method;
     std::string path;
+    std::string version;
     std::map<std::string, std::string> headers;
     std::map<std::string, std::string> params;
     std::string body;
+    
+    // 流式路由的请求体接收端，此时 body 为空
+    std::shared_ptr<RequestBodySink> bodySink;
 };
 
+// 以文件作为响应体，析构时关闭文件
+struct ResponseFile {
+    int fd = -1;
+    size_t size = 0;
+    
+    ~ResponseFile();
+};
+
+// 流式响应体的生成器：每次调用把下一块数据写入 chunk，返回 false 表示数据已全部生成
+using ResponseProducer = std::function<bool(std::string& chunk)>;
+
 struct HttpResponse {
     int statusCode;
     std::map<std::string, std::string> headers;
     std::string body;
     
+    // 零拷贝响应体：静态数据（如嵌入式资源）或文件，设置后忽略 body；
+    // staticBodyOwner 持有 staticBody 指向的数据（如内存映射文件），保证发送完成前有效
+    const char* staticBody = nullptr;
+    size_t staticBodySize = 0;
+    std::shared_ptr<const void> staticBodyOwner;
+    std::shared_ptr<ResponseFile> file;
+    
+    // 流式响应体：设置后以 Transfer-Encoding: chunked 分块发送，按发送进度逐块生成
+    ResponseProducer producer;
+    
+    // 事件流响应（Server-Sent Events）：body 作为第一块发送后连接保持打开，
+    // 之后由服务器持续推送事件，直到客户端断开
+    bool eventStream = false;
+    
     HttpResponse() : statusCode(200) {
         headers["Content-Type"] = "text/html; charset=utf-8";
     }
@@ -26,6 +77,22 @@ struct HttpResponse {
 
 using RouteHandler = std::function<HttpResponse(const HttpRequest&)>;
 
+// 在请求头接收完整后创建请求体接收端；返回空指针时以 rejectResponse 拒绝请求
+using BodySinkFactory = std::function<std::shared_ptr<RequestBodySink>(const HttpRequest&, HttpResponse& rejectResponse)>;
+
+// 路由类别，每个类别有独立的并发请求上限
+enum class RouteClass {
+    Static = 0,  // 静态文件
+    Api,         // 普通 API（查询、设置等轻量请求）
+    Upload,      // 上传文件、创建任务等大请求体
+    Export,      // 导出、下载
+    Count
+};
+
+struct Connection;
+struct SystemConfig;
+class ThreadPool;
+
 class WebServer {
 public:
     WebServer(int port);
@@ -36,19 +103,110 @@ public:
     
     void registerRoute(const std::string& method, 
                       const std::string& path,
-                      RouteHandler handler);
+                      RouteHandler handler,
+                      RouteClass routeClass = RouteClass::Api);
+    
+    // 注册流式路由：请求体不缓存，接收时直接写入 sinkFactory 创建的接收端，
+    // 接收完整后再调用 handler（此时 request.bodySink 为该接收端）
+    void registerStreamingRoute(const std::string& method,
+                                const std::string& path,
+                                BodySinkFactory sinkFactory,
+                                RouteHandler handler,
+                                RouteClass routeClass = RouteClass::Upload);
     
     void serveStatic(const std::string& webRoot);
     
 private:
+    // 单个 I/O 线程的事件循环（epoll 实例 + 其拥有的连接）
+    struct IoLoop {
+        int epollFd = -1;
+        int wakeFd = -1;
+        std::mutex mutex;
+        std::unordered_map<int, std::shared_ptr<Connection>> connections;
+    };
+    
+    // 路由前缀树节点
+    struct RouteNode {
+        enum class ParamType { Path, Int };
+        
+        std::map<std::string, std::unique_ptr<RouteNode>, std::less<>> children;
+        std::unique_ptr<RouteNode> paramChild;
+        std::string paramName;
+        ParamType paramType = ParamType::Path;
+        RouteHandler handler;
+        BodySinkFactory sinkFactory;
+        RouteClass routeClass = RouteClass::Api;
+    };
+    
+    // 磁盘静态文件的 ETag 缓存，文件修改后重新计算
+    struct FileEtag {
+        time_t mtime;
+        size_t size;
+        std::string etag;
+    };
+    
+    // 参数捕获：参数名及其占用的路径段区间 [first, last)
+    struct RouteCapture {
+        const std::string* name;
+        size_t first;
+        size_t last;
+    };
+    
+    // 已接收完整、等待处理的请求：原始请求数据，或流式路由已解析的请求
+    struct PendingRequest {
+        std::string raw;
+        std::shared_ptr<HttpRequest> streamed;
+        RouteClass routeClass = RouteClass::Static;
+    };
+    
+    enum class RequestState { Incomplete, Ready, Rejected };
+    
     void run();
+    void ioLoop(size_t loopIndex);
+    void acceptConnections();
+    void handleReadable(const std::shared_ptr<Connection>& conn);
+    void scheduleNextRequest(const std::shared_ptr<Connection>& conn);
+    void closeIdleConnections(IoLoop& loop);
+    RequestState takeRequest(Connection& conn, PendingRequest& pending, HttpResponse& rejectResponse);
+    bool extractRequest(Connection& conn, std::string& requestStr);
+    void dispatchRequest(const std::shared_ptr<Connection>& conn, PendingRequest pending);
+    void rejectRequest(Connection& conn, HttpResponse& response);
+    void queueResponse(Connection& conn, HttpResponse& response);
+    void completeResponse(const std::shared_ptr<Connection>& conn);
+    void produceResponseChunks(const std::shared_ptr<Connection>& conn);
+    void resumeProducer(const std::shared_ptr<Connection>& conn);
+    bool flushConnection(Connection& conn);
+    void closeConnection(Connection& conn);
+#ifndef _WIN32
+    void addEventClient(const std::shared_ptr<Connection>& conn);
+    void eventLoop();
+#endif
+#ifdef _WIN32
     void handleClient(int clientSocket);
+    void sendResponse(int clientSocket, const HttpResponse& response);
+#endif
+    bool admitRequest(Connection& conn, HttpResponse& rejectResponse);
+    HttpResponse makeRejectResponse(int statusCode, const std::string& message = "");
+    void applyHttpLimits(const SystemConfig& config);
+    bool acquireRouteSlot(RouteClass routeClass);
+    void releaseRouteSlot(RouteClass routeClass);
+    RouteNode* insertRoute(const std::string& method, const std::string& path);
+    HttpResponse routeRequest(HttpRequest& request);
+    bool applyKeepAlive(const HttpRequest& request, HttpResponse& response, size_t requestCount);
+    void compressResponse(const HttpRequest& request, HttpResponse& response);
     HttpRequest parseRequest(const std::string& requestStr);
-    std::string buildResponse(const HttpResponse& response);
+    std::string buildResponseHeader(const HttpResponse& response);
     
-    bool matchRoute(const std::string& pattern, const std::string& path,
-                   std::map<std::string, std::string>& params);
-    HttpResponse serveStaticFile(const std::string& path);
+    const RouteNode* findRoute(const std::string& method, const std::string& path,
+                               std::map<std::string, std::string>* params);
+    const RouteNode* matchRouteNode(const RouteNode& node, const std::string_view* segments,
+                                    size_t count, size_t pos,
+                                    RouteCapture* captures, size_t& captureCount);
+    HttpResponse serveStaticFile(const HttpRequest& request);
+    std::string getFileEtag(const std::string& filePath, const struct stat& st);
+    bool applyCacheHeaders(const HttpRequest& request, HttpResponse& response, const std::string& etag);
+    void sendMappedFile(const HttpRequest& request, HttpResponse& response,
+                        const std::shared_ptr<MappedFile>& mapped);
     void parseQueryString(const std::string& query, 
                          std::map<std::string, std::string>& params);
     std::string urlDecode(const std::string& str);
@@ -60,11 +218,37 @@ private:
     
     int port_;
     int serverSocket_;
-    bool running_;
+    std::atomic<bool> running_;
     std::thread serverThread_;
     std::string webRoot_;
     
-    std::map<std::string, std::map<std::string, RouteHandler>> routes_;
+    std::vector<std::unique_ptr<IoLoop>> ioLoops_;
+    std::vector<std::thread> ioThreads_;
+    std::atomic<size_t> nextLoop_;
+    std::unique_ptr<ThreadPool> workerPool_;
+    
+    // 准入控制：各路由类别的并发上限与当前并发数
+    std::atomic<int> routeLimits_[static_cast<int>(RouteClass::Count)] = {};
+    std::atomic<int> routeActive_[static_cast<int>(RouteClass::Count)] = {};
+    std::atomic<size_t> maxRequestBodyBytes_;
+    
+    // 动态响应压缩
+    std::atomic<int> compressionLevel_;
+    std::atomic<size_t> compressionMinBytes_;
+    
+    std::map<std::string, std::unique_ptr<RouteNode>> routeTrie_;
+    
+    // 磁盘静态文件 ETag
+    std::mutex fileEtagMutex_;
+    std::unordered_map<std::string, FileEtag> fileEtags_;
+    
+    // 任务事件推送：事件流客户端、待推送的任务变化（taskId -> 最新数据）及推送线程
+    std::mutex eventMutex_;
+    std::condition_variable eventCv_;
+    std::vector<std::weak_ptr<Connection>> eventClients_;
+    std::map<std::string, std::string> pendingEvents_;
+    std::thread eventThread_;
+    int taskListenerId_;
     
     void registerDefaultRoutes();
 };
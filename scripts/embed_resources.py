@@ -6,8 +6,13 @@
 
 import os
 import sys
+import gzip
+import hashlib
 import mimetypes
 
+# 压缩后至少节省 10% 才嵌入 gzip 版本，否则嵌入原始内容
+GZIP_MIN_SAVING = 0.9
+
 def get_mime_type(filepath):
     """获取文件的 MIME 类型"""
     mime_type, _ = mimetypes.guess_type(filepath)
@@ -40,6 +45,27 @@ def sanitize_name(path):
     name = path.replace('/', '_').replace('.', '_').replace('-', '_')
     return 'res_' + name
 
+def compress_resource(data):
+    """gzip 压缩资源内容；mtime 固定为 0，保证相同输入生成相同输出"""
+    compressed = gzip.compress(data, compresslevel=9, mtime=0)
+    if len(compressed) < len(data) * GZIP_MIN_SAVING:
+        return compressed
+    return None
+
+def content_hash(data):
+    """资源内容哈希，用作 ETag"""
+    return hashlib.sha256(data).hexdigest()[:16]
+
+def append_byte_array(source_lines, varname, data):
+    """生成字节数组定义，每行 16 个字节"""
+    source_lines.append(f"const uint8_t {varname}[] = {{")
+    for i in range(0, len(data), 16):
+        chunk = data[i:i+16]
+        hex_str = ', '.join(f'0x{b:02x}' for b in chunk)
+        source_lines.append(f"    {hex_str},")
+    source_lines.append("};")
+    source_lines.append("")
+
 def collect_files(web_dir):
     """收集 web 目录下的所有文件"""
     files = []
@@ -77,17 +103,19 @@ def generate_header(files, output_dir):
 
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <cstdint>
 
 struct EmbeddedResource {
     const uint8_t* data;
     size_t size;
     const char* mimeType;
+    const char* contentEncoding;  // "gzip" 或 nullptr（未压缩）
+    const char* etag;             // 基于内容哈希的 ETag，不同编码的 ETag 不同
 };
 
-// 获取嵌入式资源
-const EmbeddedResource* getEmbeddedResource(const std::string& path);
+// 获取嵌入式资源；acceptGzip 为 true 时优先返回 gzip 压缩版本，
+// 否则返回原始内容（只嵌入了压缩版本的资源在首次访问时解压）
+const EmbeddedResource* getEmbeddedResource(const std::string& path, bool acceptGzip = false);
 
 // 检查是否有嵌入式资源
 bool hasEmbeddedResources();
@@ -111,82 +139,136 @@ def generate_source(files, output_dir):
         '// 由 scripts/embed_resources.py 生成',
         '',
         '#include "embedded_resources.h"',
-        '#include <vector>',
+        '#include <memory>',
+        '#include <mutex>',
+        '#include <unordered_map>',
+        '#include <zlib.h>',
         '',
         'namespace {',
         ''
     ]
     
-    # 生成每个文件的字节数组
+    # 生成每个文件的字节数组：可压缩的资源只嵌入 gzip 版本
+    entries = []
     for f in files:
         with open(f['filepath'], 'rb') as fp:
             data = fp.read()
         
-        source_lines.append(f"// {f['relpath']} ({len(data)} bytes)")
-        source_lines.append(f"const uint8_t {f['varname']}[] = {{")
-        
-        # 每行 16 个字节
-        for i in range(0, len(data), 16):
-            chunk = data[i:i+16]
-            hex_str = ', '.join(f'0x{b:02x}' for b in chunk)
-            source_lines.append(f"    {hex_str},")
-        
-        source_lines.append("};")
-        source_lines.append("")
+        compressed = compress_resource(data)
+        digest = content_hash(data)
+        if compressed is not None:
+            source_lines.append(f"// {f['relpath']} ({len(data)} bytes, gzip {len(compressed)} bytes)")
+            append_byte_array(source_lines, f['varname'] + '_gz', compressed)
+            entries.append((f, 'nullptr', len(data), f['varname'] + '_gz', len(compressed), digest))
+        else:
+            source_lines.append(f"// {f['relpath']} ({len(data)} bytes)")
+            append_byte_array(source_lines, f['varname'], data)
+            entries.append((f, f['varname'], len(data), 'nullptr', 0, digest))
     
     # 生成资源映射表
     source_lines.append("// 资源映射表")
     source_lines.append("struct ResourceEntry {")
     source_lines.append("    const char* path;")
-    source_lines.append("    const uint8_t* data;")
-    source_lines.append("    size_t size;")
+    source_lines.append("    const uint8_t* data;       // 原始内容（只嵌入了压缩版本时为 nullptr）")
+    source_lines.append("    size_t size;               // 原始内容大小")
+    source_lines.append("    const uint8_t* gzipData;   // gzip 压缩内容")
+    source_lines.append("    size_t gzipSize;")
     source_lines.append("    const char* mimeType;")
+    source_lines.append("    const char* etag;")
+    source_lines.append("    const char* gzipEtag;")
     source_lines.append("};")
     source_lines.append("")
     source_lines.append(f"const ResourceEntry resourceTable[] = {{")
     
-    for f in files:
-        with open(f['filepath'], 'rb') as fp:
-            size = len(fp.read())
-        source_lines.append(f'    {{"{f["urlpath"]}", {f["varname"]}, {size}, "{f["mime"]}"}},')
+    for f, data_var, size, gz_var, gz_size, digest in entries:
+        source_lines.append(f'    {{"{f["urlpath"]}", {data_var}, {size}, {gz_var}, {gz_size}, "{f["mime"]}", '
+                            f'"\\"{digest}\\"", "\\"{digest}-gz\\""}},')
     
     source_lines.append("};")
     source_lines.append("")
     source_lines.append(f"const size_t resourceCount = {len(files)};")
     source_lines.append("")
-    source_lines.append("} // anonymous namespace")
-    source_lines.append("")
+    
+    # 运行时查找表和按需解压
+    source_lines.extend([
+        "// 同一资源的两种编码形式",
+        "struct ResourceVariants {",
+        "    const ResourceEntry* entry;",
+        "    EmbeddedResource identity;",
+        "    EmbeddedResource gzip;",
+        "    std::string inflated;      // 按需解压的原始内容",
+        "    std::once_flag inflateOnce;",
+        "};",
+        "",
+        "bool inflateGzip(const uint8_t* data, size_t size, std::string& out, size_t expectedSize) {",
+        "    out.resize(expectedSize);",
+        "    z_stream stream = {};",
+        "    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {",
+        "        return false;",
+        "    }",
+        "    stream.next_in = const_cast<Bytef*>(data);",
+        "    stream.avail_in = static_cast<uInt>(size);",
+        "    stream.next_out = reinterpret_cast<Bytef*>(&out[0]);",
+        "    stream.avail_out = static_cast<uInt>(expectedSize);",
+        "    int ret = inflate(&stream, Z_FINISH);",
+        "    size_t produced = stream.total_out;",
+        "    inflateEnd(&stream);",
+        "    return ret == Z_STREAM_END && produced == expectedSize;",
+        "}",
+        "",
+        "const std::unordered_map<std::string, std::unique_ptr<ResourceVariants>>& resourceIndex() {",
+        "    // 函数内静态变量的初始化是线程安全的",
+        "    static const auto index = [] {",
+        "        std::unordered_map<std::string, std::unique_ptr<ResourceVariants>> map;",
+        "        for (size_t i = 0; i < resourceCount; ++i) {",
+        "            const ResourceEntry& entry = resourceTable[i];",
+        "            std::unique_ptr<ResourceVariants> variants(new ResourceVariants());",
+        "            variants->entry = &entry;",
+        "            variants->identity = {entry.data, entry.size, entry.mimeType, nullptr, entry.etag};",
+        "            variants->gzip = {entry.gzipData, entry.gzipSize, entry.mimeType, \"gzip\", entry.gzipEtag};",
+        "            map[entry.path] = std::move(variants);",
+        "        }",
+        "        return map;",
+        "    }();",
+        "    return index;",
+        "}",
+        "",
+        "} // anonymous namespace",
+        "",
+    ])
     
     # 生成查找函数
-    source_lines.append("const EmbeddedResource* getEmbeddedResource(const std::string& path) {")
-    source_lines.append("    static std::unordered_map<std::string, EmbeddedResource> cache;")
-    source_lines.append("    static bool initialized = false;")
+    source_lines.append("const EmbeddedResource* getEmbeddedResource(const std::string& path, bool acceptGzip) {")
+    source_lines.append("    const auto& index = resourceIndex();")
     source_lines.append("    ")
-    source_lines.append("    if (!initialized) {")
-    source_lines.append("        for (size_t i = 0; i < resourceCount; ++i) {")
-    source_lines.append("            cache[resourceTable[i].path] = {")
-    source_lines.append("                resourceTable[i].data,")
-    source_lines.append("                resourceTable[i].size,")
-    source_lines.append("                resourceTable[i].mimeType")
-    source_lines.append("            };")
-    source_lines.append("        }")
-    source_lines.append("        initialized = true;")
+    source_lines.append("    auto it = index.find(path);")
+    source_lines.append("    ")
+    source_lines.append("    // 尝试添加 index.html")
+    source_lines.append("    if (it == index.end() && !path.empty() && path.back() == '/') {")
+    source_lines.append("        it = index.find(path + \"index.html\");")
+    source_lines.append("    }")
+    source_lines.append("    if (it == index.end()) {")
+    source_lines.append("        return nullptr;")
     source_lines.append("    }")
     source_lines.append("    ")
-    source_lines.append("    auto it = cache.find(path);")
-    source_lines.append("    if (it != cache.end()) {")
-    source_lines.append("        return &it->second;")
+    source_lines.append("    ResourceVariants& variants = *it->second;")
+    source_lines.append("    if (acceptGzip && variants.gzip.data) {")
+    source_lines.append("        return &variants.gzip;")
     source_lines.append("    }")
     source_lines.append("    ")
-    source_lines.append("    // 尝试添加 index.html")
-    source_lines.append("    if (path.back() == '/') {")
-    source_lines.append("        it = cache.find(path + \"index.html\");")
-    source_lines.append("        if (it != cache.end()) {")
-    source_lines.append("            return &it->second;")
+    source_lines.append("    // 客户端不接受 gzip：首次访问时解压并缓存原始内容")
+    source_lines.append("    if (!variants.entry->data) {")
+    source_lines.append("        std::call_once(variants.inflateOnce, [&variants] {")
+    source_lines.append("            const ResourceEntry& entry = *variants.entry;")
+    source_lines.append("            if (inflateGzip(entry.gzipData, entry.gzipSize, variants.inflated, entry.size)) {")
+    source_lines.append("                variants.identity.data = reinterpret_cast<const uint8_t*>(variants.inflated.data());")
+    source_lines.append("            }")
+    source_lines.append("        });")
+    source_lines.append("        if (!variants.identity.data) {")
+    source_lines.append("            return nullptr;")
     source_lines.append("        }")
     source_lines.append("    }")
-    source_lines.append("    ")
-    source_lines.append("    return nullptr;")
+    source_lines.append("    return &variants.identity;")
     source_lines.append("}")
     source_lines.append("")
     source_lines.append("bool hasEmbeddedResources() {")
@@ -223,9 +305,11 @@ struct EmbeddedResource {
     const uint8_t* data;
     size_t size;
     const char* mimeType;
+    const char* contentEncoding;
+    const char* etag;
 };
 
-const EmbeddedResource* getEmbeddedResource(const std::string& path);
+const EmbeddedResource* getEmbeddedResource(const std::string& path, bool acceptGzip = false);
 bool hasEmbeddedResources();
 std::vector<std::string> getEmbeddedResourcePaths();
 
@@ -237,7 +321,7 @@ std::vector<std::string> getEmbeddedResourcePaths();
 
 #include "embedded_resources.h"
 
-const EmbeddedResource* getEmbeddedResource(const std::string&) {
+const EmbeddedResource* getEmbeddedResource(const std::string&, bool) {
     return nullptr;
 }
 
@@ -295,6 +379,13 @@ def main():
         print(f"  {f['urlpath']} ({size} bytes) [{f['mime']}]")
     
     print(f"总大小: {total_size / 1024:.1f} KB")
+    compressed_size = 0
+    for f in files:
+        with open(f['filepath'], 'rb') as fp:
+            data = fp.read()
+        compressed = compress_resource(data)
+        compressed_size += len(compressed) if compressed is not None else len(data)
+    print(f"嵌入大小: {compressed_size / 1024:.1f} KB（gzip 预压缩）")
     print()
     
     generate_header(files, output_dir)
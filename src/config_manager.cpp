@@ -81,6 +81,12 @@ SystemConfig ConfigManager::loadSystemConfig() {
         if (j.contains("maxModelsPerTask")) config.maxModelsPerTask = j["maxModelsPerTask"];
         if (j.contains("maxRetries")) config.maxRetries = j["maxRetries"];
         if (j.contains("consecutiveFailureThreshold")) config.consecutiveFailureThreshold = j["consecutiveFailureThreshold"];
+        if (j.contains("translationBatchSize")) config.translationBatchSize = j["translationBatchSize"];
+        if (j.contains("translationBatchTokens")) config.translationBatchTokens = j["translationBatchTokens"];
+        if (j.contains("translationCombined")) config.translationCombined = j["translationCombined"];
+        if (j.contains("translationCacheEnabled")) config.translationCacheEnabled = j["translationCacheEnabled"];
+        if (j.contains("translationCacheMemoryMB")) config.translationCacheMemoryMB = j["translationCacheMemoryMB"];
+        if (j.contains("translationCacheDiskMB")) config.translationCacheDiskMB = j["translationCacheDiskMB"];
         if (j.contains("adminPasswordHash")) config.adminPasswordHash = j["adminPasswordHash"];
         if (j.contains("passwordSalt")) config.passwordSalt = j["passwordSalt"];
         if (j.contains("serverPort")) config.serverPort = j["serverPort"];
@@ -94,6 +100,21 @@ SystemConfig ConfigManager::loadSystemConfig() {
         if (j.contains("logRetentionDays")) config.logRetentionDays = j["logRetentionDays"];
         if (j.contains("logArchiveIntervalDays")) config.logArchiveIntervalDays = j["logArchiveIntervalDays"];
         
+        // HTTP 服务器配置
+        if (j.contains("httpWorkerThreads")) config.httpWorkerThreads = j["httpWorkerThreads"];
+        if (j.contains("httpMaxPendingRequests")) config.httpMaxPendingRequests = j["httpMaxPendingRequests"];
+        if (j.contains("httpMaxStaticRequests")) config.httpMaxStaticRequests = j["httpMaxStaticRequests"];
+        if (j.contains("httpMaxApiRequests")) config.httpMaxApiRequests = j["httpMaxApiRequests"];
+        if (j.contains("httpMaxUploadRequests")) config.httpMaxUploadRequests = j["httpMaxUploadRequests"];
+        if (j.contains("httpMaxExportRequests")) config.httpMaxExportRequests = j["httpMaxExportRequests"];
+        if (j.contains("httpMaxRequestBodyMB")) config.httpMaxRequestBodyMB = j["httpMaxRequestBodyMB"];
+        if (j.contains("httpCompressionLevel")) config.httpCompressionLevel = j["httpCompressionLevel"];
+        if (j.contains("httpCompressionMinBytes")) config.httpCompressionMinBytes = j["httpCompressionMinBytes"];
+        if (j.contains("storageDurability")) config.storageDurability = j["storageDurability"];
+        if (j.contains("storageSyncIntervalMs")) config.storageSyncIntervalMs = j["storageSyncIntervalMs"];
+        if (j.contains("storageCompression")) config.storageCompression = j["storageCompression"];
+        if (j.contains("storageEncoding")) config.storageEncoding = j["storageEncoding"];
+        
         // 不再打印日志，避免频繁输出
     } catch (const std::exception& e) {
         Logger::getInstance().error("Failed to load system config: " + std::string(e.what()));
@@ -113,6 +134,12 @@ bool ConfigManager::saveSystemConfig(const SystemConfig& config) {
         j["maxModelsPerTask"] = config.maxModelsPerTask;
         j["maxRetries"] = config.maxRetries;
         j["consecutiveFailureThreshold"] = config.consecutiveFailureThreshold;
+        j["translationBatchSize"] = config.translationBatchSize;
+        j["translationBatchTokens"] = config.translationBatchTokens;
+        j["translationCombined"] = config.translationCombined;
+        j["translationCacheEnabled"] = config.translationCacheEnabled;
+        j["translationCacheMemoryMB"] = config.translationCacheMemoryMB;
+        j["translationCacheDiskMB"] = config.translationCacheDiskMB;
         j["adminPasswordHash"] = config.adminPasswordHash;
         j["passwordSalt"] = config.passwordSalt;
         j["serverPort"] = config.serverPort;
@@ -126,6 +153,21 @@ bool ConfigManager::saveSystemConfig(const SystemConfig& config) {
         j["logRetentionDays"] = config.logRetentionDays;
         j["logArchiveIntervalDays"] = config.logArchiveIntervalDays;
         
+        // HTTP 服务器配置
+        j["httpWorkerThreads"] = config.httpWorkerThreads;
+        j["httpMaxPendingRequests"] = config.httpMaxPendingRequests;
+        j["httpMaxStaticRequests"] = config.httpMaxStaticRequests;
+        j["httpMaxApiRequests"] = config.httpMaxApiRequests;
+        j["httpMaxUploadRequests"] = config.httpMaxUploadRequests;
+        j["httpMaxExportRequests"] = config.httpMaxExportRequests;
+        j["httpMaxRequestBodyMB"] = config.httpMaxRequestBodyMB;
+        j["httpCompressionLevel"] = config.httpCompressionLevel;
+        j["httpCompressionMinBytes"] = config.httpCompressionMinBytes;
+        j["storageDurability"] = config.storageDurability;
+        j["storageSyncIntervalMs"] = config.storageSyncIntervalMs;
+        j["storageCompression"] = config.storageCompression;
+        j["storageEncoding"] = config.storageEncoding;
+        
         std::ofstream file(systemConfigPath_);
         if (!file.is_open()) {
             Logger::getInstance().error("Failed to open system config file for writing");
@@ -0,0 +1,141 @@
+#include "curl_pool.h"
+#include "logger.h"
+#include <iomanip>
+#include <sstream>
+
+// 每个端点最多保留的空闲句柄数（超过时直接释放，通常不超过该端点的翻译线程数）
+static const size_t MAX_IDLE_HANDLES_PER_ENDPOINT = 32;
+
+// 每个端点每完成该数量的请求记录一次连接复用率
+static const uint64_t REUSE_LOG_INTERVAL = 100;
+
+CurlPool& CurlPool::getInstance() {
+    static CurlPool instance;
+    return instance;
+}
+
+CurlPool::CurlPool() {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    
+    // 共享 DNS 缓存与 TLS 会话。连接缓存不放入 share 对象（libcurl 不支持多个线程并发共享连接），
+    // 由各句柄自己的连接缓存随句柄复用
+    share_ = curl_share_init();
+    if (share_) {
+        curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &CurlPool::lockShare);
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &CurlPool::unlockShare);
+        curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+}
+
+CurlPool::~CurlPool() {
+    for (auto& pair : endpoints_) {
+        for (CURL* curl : pair.second.idle) {
+            curl_easy_cleanup(curl);
+        }
+    }
+    endpoints_.clear();
+    if (share_) {
+        curl_share_cleanup(share_);
+    }
+    curl_global_cleanup();
+}
+
+void CurlPool::lockShare(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<CurlPool*>(userptr)->shareMutexes_[data].lock();
+}
+
+void CurlPool::unlockShare(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<CurlPool*>(userptr)->shareMutexes_[data].unlock();
+}
+
+std::string CurlPool::endpointOf(const std::string& url) {
+    // scheme://host:port/path -> scheme://host:port
+    size_t hostStart = url.find("://");
+    hostStart = hostStart == std::string::npos ? 0 : hostStart + 3;
+    size_t hostEnd = url.find_first_of("/?#", hostStart);
+    return hostEnd == std::string::npos ? url : url.substr(0, hostEnd);
+}
+
+CURL* CurlPool::acquire(const std::string& endpoint) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<CURL*>& idle = endpoints_[endpoint].idle;
+        if (!idle.empty()) {
+            CURL* curl = idle.back();
+            idle.pop_back();
+            return curl;
+        }
+    }
+    
+    CURL* curl = curl_easy_init();
+    if (curl) {
+        if (share_) {
+            curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+        }
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    }
+    return curl;
+}
+
+void CurlPool::release(const std::string& endpoint, CURL* curl) {
+    if (!curl) {
+        return;
+    }
+    
+    // 清除本次请求的选项（请求体、回调等指向调用者的数据），保留连接缓存
+    curl_easy_reset(curl);
+    if (share_) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+    }
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<CURL*>& idle = endpoints_[endpoint].idle;
+        if (idle.size() < MAX_IDLE_HANDLES_PER_ENDPOINT) {
+            idle.push_back(curl);
+            return;
+        }
+    }
+    curl_easy_cleanup(curl);
+}
+
+void CurlPool::record(const std::string& endpoint, bool reused) {
+    uint64_t requests;
+    uint64_t reusedCount;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Endpoint& stats = endpoints_[endpoint];
+        stats.requests++;
+        if (reused) {
+            stats.reused++;
+        }
+        requests = stats.requests;
+        reusedCount = stats.reused;
+    }
+    
+    if (requests % REUSE_LOG_INTERVAL == 0) {
+        std::ostringstream oss;
+        oss << "Connection reuse for " << endpoint << ": " << reusedCount << "/" << requests << " requests ("
+            << std::fixed << std::setprecision(1) << (100.0 * reusedCount / requests) << "%)";
+        Logger::getInstance().info(oss.str());
+    }
+}
+
+CurlPool::Handle::Handle(const std::string& url)
+    : endpoint_(endpointOf(url)), curl_(CurlPool::getInstance().acquire(endpoint_)) {
+}
+
+CurlPool::Handle::~Handle() {
+    CurlPool::getInstance().release(endpoint_, curl_);
+}
+
+void CurlPool::Handle::recordTransfer() {
+    // 本次请求新建的连接数为 0 即复用了已有连接
+    long connects = 0;
+    if (curl_ && curl_easy_getinfo(curl_, CURLINFO_NUM_CONNECTS, &connects) == CURLE_OK) {
+        CurlPool::getInstance().record(endpoint_, connects == 0);
+    }
+}
@@ -6,17 +6,19 @@
 
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <cstdint>
 
 struct EmbeddedResource {
     const uint8_t* data;
     size_t size;
     const char* mimeType;
+    const char* contentEncoding;  // "gzip" 或 nullptr（未压缩）
+    const char* etag;             // 基于内容哈希的 ETag，不同编码的 ETag 不同
 };
 
-// 获取嵌入式资源
-const EmbeddedResource* getEmbeddedResource(const std::string& path);
+// 获取嵌入式资源；acceptGzip 为 true 时优先返回 gzip 压缩版本，
+// 否则返回原始内容（只嵌入了压缩版本的资源在首次访问时解压）
+const EmbeddedResource* getEmbeddedResource(const std::string& path, bool acceptGzip = false);
 
 // 检查是否有嵌入式资源
 bool hasEmbeddedResources();
@@ -2,6 +2,7 @@
 #include "logger.h"
 #include <regex>
 #include <algorithm>
+#include <cstring>
 
 // Chinese UTF-8 string constants for field names
 static const std::string ZH_DI = "\xe7\xac\xac";
@@ -44,6 +45,37 @@ bool HTMLParser::validate(const std::string& htmlContent) {
     return false;
 }
 
+// 增量校验时保留的上一块末尾长度，需大于最长的标记
+static const size_t STREAM_VALIDATOR_TAIL = 64;
+
+void HTMLStreamValidator::feed(const char* data, size_t size) {
+    if (!binary_ && memchr(data, '\0', size) != nullptr) {
+        binary_ = true;
+    }
+    if (isValid()) {
+        return;
+    }
+    
+    window_.append(data, size);
+    static const std::regex recordPatternEn(R"(Record\s+\d+\s+of\s+\d+)");
+    static const std::string zhBiaotiTag = "<b>" + ZH_BIAOTI + "</b>";
+    if (window_.find("Web of Science") != std::string::npos ||
+        window_.find(zhBiaotiTag) != std::string::npos ||
+        std::regex_search(window_, recordPatternEn)) {
+        matched_ = true;
+    }
+    hasZhDi_ = hasZhDi_ || window_.find(ZH_DI) != std::string::npos;
+    hasZhTiaoGong_ = hasZhTiaoGong_ || window_.find(ZH_TIAO_GONG) != std::string::npos;
+    
+    if (window_.size() > STREAM_VALIDATOR_TAIL) {
+        window_.erase(0, window_.size() - STREAM_VALIDATOR_TAIL);
+    }
+}
+
+bool HTMLStreamValidator::isValid() const {
+    return matched_ || (hasZhDi_ && hasZhTiaoGong_);
+}
+
 std::vector<Literature> HTMLParser::parse(const std::string& htmlContent) {
     std::vector<Literature> literatures;
     try {
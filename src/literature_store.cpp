@@ -0,0 +1,650 @@
+#include "literature_store.h"
+#include "logger.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <io.h>
+    #define platform_fseek _fseeki64
+    #define platform_fsync(fd) _commit(fd)
+    #define platform_fdatasync(fd) _commit(fd)
+    #define platform_fileno _fileno
+    #define platform_truncate(fd, size) _chsize_s(fd, size)
+#else
+    #include <unistd.h>
+    #define platform_fseek fseeko
+    #define platform_fsync fsync
+    #define platform_fdatasync fdatasync
+    #define platform_fileno fileno
+    #define platform_truncate(fd, size) ftruncate(fd, size)
+#endif
+
+// 段文件与日志文件的文件头（格式标识与版本）
+static const char SEGMENT_MAGIC[8] = {'W', 'O', 'S', 'L', 'I', 'T', '0', '1'};
+static const char JOURNAL_MAGIC[8] = {'W', 'O', 'S', 'J', 'R', 'N', '0', '1'};
+static const size_t MAGIC_SIZE = sizeof(SEGMENT_MAGIC);
+
+// 记录头：长度、CRC32、文献序号
+static const size_t RECORD_HEADER_SIZE = 12;
+
+// 单条记录的长度上限，超过视为文件损坏
+static const uint32_t MAX_RECORD_SIZE = 64 * 1024 * 1024;
+
+// 长度字段的最高位：数据为 [原始长度 u32][zlib 压缩数据]
+static const uint32_t RECORD_COMPRESSED = 0x80000000u;
+
+// 小于该长度的记录不压缩（压缩收益抵不过开销）
+static const size_t COMPRESS_MIN_BYTES = 256;
+
+// 段文件超过该大小且过期记录占一半以上时压缩
+static const uint64_t COMPACT_MIN_BYTES = 1024 * 1024;
+
+static void writeU32(char* out, uint32_t value) {
+    out[0] = static_cast<char>(value & 0xff);
+    out[1] = static_cast<char>((value >> 8) & 0xff);
+    out[2] = static_cast<char>((value >> 16) & 0xff);
+    out[3] = static_cast<char>((value >> 24) & 0xff);
+}
+
+static uint32_t readU32(const char* in) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(in);
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// 校验和覆盖文献序号和数据
+static uint32_t recordChecksum(int index, const char* data, size_t size) {
+    char indexBytes[4];
+    writeU32(indexBytes, static_cast<uint32_t>(index));
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(indexBytes), 4);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(size));
+    return static_cast<uint32_t>(crc);
+}
+
+static uint32_t recordSize(uint32_t length) {
+    return length & ~RECORD_COMPRESSED;
+}
+
+// flags 为长度字段的标记位（RECORD_COMPRESSED 或 0），返回记录头中的长度字段
+static uint32_t encodeRecord(std::string& out, int index, const std::string& payload, uint32_t flags = 0) {
+    uint32_t length = static_cast<uint32_t>(payload.size()) | flags;
+    char header[RECORD_HEADER_SIZE];
+    writeU32(header, length);
+    writeU32(header + 4, recordChecksum(index, payload.data(), payload.size()));
+    writeU32(header + 8, static_cast<uint32_t>(index));
+    out.append(header, RECORD_HEADER_SIZE);
+    out.append(payload);
+    return length;
+}
+
+// 压缩记录数据，压缩后没有变小时返回 false（按原样存储）
+static bool compressPayload(const std::string& payload, std::string& out) {
+    if (payload.size() < COMPRESS_MIN_BYTES) {
+        return false;
+    }
+    uLongf bound = compressBound(static_cast<uLong>(payload.size()));
+    out.resize(4 + bound);
+    writeU32(&out[0], static_cast<uint32_t>(payload.size()));
+    if (compress2(reinterpret_cast<Bytef*>(&out[4]), &bound, reinterpret_cast<const Bytef*>(payload.data()),
+                  static_cast<uLong>(payload.size()), Z_DEFAULT_COMPRESSION) != Z_OK ||
+        4 + bound >= payload.size()) {
+        return false;
+    }
+    out.resize(4 + bound);
+    return true;
+}
+
+static bool decompressPayload(const std::string& stored, std::string& payload) {
+    if (stored.size() < 4) {
+        return false;
+    }
+    uint32_t size = readU32(stored.data());
+    if (size > MAX_RECORD_SIZE) {
+        return false;
+    }
+    payload.resize(size);
+    uLongf length = size;
+    if (uncompress(reinterpret_cast<Bytef*>(&payload[0]), &length,
+                   reinterpret_cast<const Bytef*>(stored.data() + 4),
+                   static_cast<uLong>(stored.size() - 4)) != Z_OK || length != size) {
+        payload.clear();
+        return false;
+    }
+    return true;
+}
+
+// 打开记录文件，不存在时创建并写入文件头
+static std::FILE* openRecordFile(const std::string& path, const char* magic) {
+    std::FILE* file = fopen(path.c_str(), "r+b");
+    if (file) {
+        return file;
+    }
+    
+    file = fopen(path.c_str(), "w+b");
+    if (!file) {
+        Logger::getInstance().error("Failed to open literature store: " + path);
+        return nullptr;
+    }
+    if (fwrite(magic, 1, MAGIC_SIZE, file) != MAGIC_SIZE || fflush(file) != 0) {
+        Logger::getInstance().error("Failed to initialize literature store: " + path);
+        fclose(file);
+        return nullptr;
+    }
+    return file;
+}
+
+// 顺序扫描记录文件，每条完整记录调用一次 onRecord(文献序号, 数据偏移, 长度字段, 数据)；
+// 写入中断留下的残缺记录被截断。endOffset 返回最后一条完整记录的结尾
+static bool scanRecords(std::FILE* file, const std::string& path, const char* magic,
+                        const std::function<void(int, uint64_t, uint32_t, const std::string&)>& onRecord,
+                        uint64_t& endOffset) {
+    char fileMagic[MAGIC_SIZE];
+    platform_fseek(file, 0, SEEK_SET);
+    if (fread(fileMagic, 1, MAGIC_SIZE, file) != MAGIC_SIZE || memcmp(fileMagic, magic, MAGIC_SIZE) != 0) {
+        Logger::getInstance().error("Invalid literature store: " + path);
+        return false;
+    }
+    
+    uint64_t offset = MAGIC_SIZE;
+    std::string payload;
+    
+    while (true) {
+        char header[RECORD_HEADER_SIZE];
+        size_t headerRead = fread(header, 1, RECORD_HEADER_SIZE, file);
+        if (headerRead == 0 && feof(file)) {
+            break;
+        }
+        
+        bool valid = headerRead == RECORD_HEADER_SIZE;
+        uint32_t lengthField = 0;
+        uint32_t length = 0;
+        int index = 0;
+        if (valid) {
+            lengthField = readU32(header);
+            length = recordSize(lengthField);
+            index = static_cast<int>(readU32(header + 8));
+            valid = length <= MAX_RECORD_SIZE;
+        }
+        if (valid) {
+            payload.resize(length);
+            valid = fread(&payload[0], 1, length, file) == length &&
+                    recordChecksum(index, payload.data(), length) == readU32(header + 4);
+        }
+        if (!valid) {
+            // 写入中断留下的残缺记录：截断到最后一条完整记录之后
+            Logger::getInstance().warning("Truncating damaged tail of literature store " + path +
+                                          " at offset " + std::to_string(offset));
+            fflush(file);
+            if (platform_truncate(platform_fileno(file), offset) != 0) {
+                Logger::getInstance().error("Failed to truncate literature store: " + path);
+                return false;
+            }
+            break;
+        }
+        
+        onRecord(index, offset + RECORD_HEADER_SIZE, lengthField, payload);
+        offset += RECORD_HEADER_SIZE + length;
+    }
+    
+    endOffset = offset;
+    return true;
+}
+
+// 文件大小，不存在时为 0
+static uint64_t fileSizeOnDisk(const std::string& path) {
+#ifdef _WIN32
+    struct _stat64 st;
+    if (_stat64(path.c_str(), &st) != 0) {
+        return 0;
+    }
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return 0;
+    }
+#endif
+    return static_cast<uint64_t>(st.st_size);
+}
+
+// 用新文件替换旧文件（Windows 下 rename 不能覆盖已存在的文件）
+static bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+LiteratureStore::LiteratureStore(const std::string& path, MergeFunction merge)
+    : path_(path), merge_(std::move(merge)), compress_(false), file_(nullptr), journal_(nullptr),
+      fileBytes_(0), liveBytes_(0), journalBytes_(0), reportedBytes_(0) {
+    // literatures.seg -> literatures.journal
+    size_t dot = path_.rfind('.');
+    journalPath_ = (dot == std::string::npos ? path_ : path_.substr(0, dot)) + ".journal";
+}
+
+LiteratureStore::~LiteratureStore() {
+    // 关闭前写入尚未落盘的增量，下次打开时重放
+    if (journal_) {
+        writeJournal();
+        reportSize();
+        fclose(journal_);
+    }
+    if (file_) {
+        fclose(file_);
+    }
+}
+
+bool LiteratureStore::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+        return true;
+    }
+    
+    // 打开前的文件大小作为基准，创建、截断与折叠日志引起的变化在打开后一并通知
+    reportedBytes_ = fileSizeOnDisk(path_) + fileSizeOnDisk(journalPath_);
+    file_ = openRecordFile(path_, SEGMENT_MAGIC);
+    if (!file_) {
+        return false;
+    }
+    if (!scan()) {
+        fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    
+    journal_ = openRecordFile(journalPath_, JOURNAL_MAGIC);
+    if (!journal_ || !scanJournal()) {
+        if (journal_) {
+            fclose(journal_);
+            journal_ = nullptr;
+        }
+        fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    
+    // 上次运行留下的增量：折叠进段文件，日志文件从空开始
+    if (!deltas_.empty()) {
+        Logger::getInstance().info("Replaying " + std::to_string(deltas_.size()) +
+                                   " journaled literature updates: " + journalPath_);
+        foldJournal();
+    }
+    reportSize();
+    return true;
+}
+
+bool LiteratureStore::scan() {
+    index_.clear();
+    liveBytes_ = 0;
+    return scanRecords(file_, path_, SEGMENT_MAGIC,
+                       [this](int index, uint64_t offset, uint32_t length, const std::string& payload) {
+                           auto it = index_.find(index);
+                           if (it != index_.end()) {
+                               liveBytes_ -= RECORD_HEADER_SIZE + recordSize(it->second.length);
+                           }
+                           index_[index] = {offset, length};
+                           liveBytes_ += RECORD_HEADER_SIZE + payload.size();
+                       },
+                       fileBytes_);
+}
+
+bool LiteratureStore::scanJournal() {
+    // 同一文献只保留最后一条增量
+    deltas_.clear();
+    journalBuffer_.clear();
+    return scanRecords(journal_, journalPath_, JOURNAL_MAGIC,
+                       [this](int index, uint64_t, uint32_t, const std::string& delta) {
+                           deltas_[index] = delta;
+                       },
+                       journalBytes_);
+}
+
+bool LiteratureStore::put(int index, const std::string& payload) {
+    return putBatch({{index, payload}});
+}
+
+bool LiteratureStore::putBatch(const std::vector<std::pair<int, std::string>>& records) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) {
+        return false;
+    }
+    
+    // 日志中有同一文献的增量时先折叠，避免之后重放日志时旧增量覆盖新记录
+    for (const auto& record : records) {
+        if (deltas_.count(record.first)) {
+            if (!foldJournal()) {
+                return false;
+            }
+            break;
+        }
+    }
+    
+    // 无法合并而保留在日志中的增量早于本次写入的完整记录，从日志中移除
+    bool superseded = false;
+    for (const auto& record : records) {
+        superseded = deltas_.erase(record.first) > 0 || superseded;
+    }
+    if (superseded) {
+        rewriteJournal();
+    }
+    
+    bool ok = append(records);
+    if (ok) {
+        maybeCompact();
+    }
+    reportSize();
+    return ok;
+}
+
+bool LiteratureStore::append(const std::vector<std::pair<int, std::string>>& records) {
+    // 调用者需要持有 mutex_；一批记录编码后一次写入
+    std::string buffer;
+    std::vector<uint32_t> lengths;
+    lengths.reserve(records.size());
+    bool compress = compress_;
+    std::string compressed;
+    for (const auto& record : records) {
+        if (compress && compressPayload(record.second, compressed)) {
+            lengths.push_back(encodeRecord(buffer, record.first, compressed, RECORD_COMPRESSED));
+        } else {
+            lengths.push_back(encodeRecord(buffer, record.first, record.second));
+        }
+    }
+    
+    if (platform_fseek(file_, static_cast<int64_t>(fileBytes_), SEEK_SET) != 0 ||
+        fwrite(buffer.data(), 1, buffer.size(), file_) != buffer.size() ||
+        fflush(file_) != 0) {
+        // 部分写入的记录在下次打开时因校验失败被截断
+        Logger::getInstance().error("Failed to write literature store: " + path_);
+        return false;
+    }
+    
+    uint64_t offset = fileBytes_;
+    for (size_t i = 0; i < records.size(); i++) {
+        auto it = index_.find(records[i].first);
+        if (it != index_.end()) {
+            liveBytes_ -= RECORD_HEADER_SIZE + recordSize(it->second.length);
+        }
+        uint32_t size = recordSize(lengths[i]);
+        index_[records[i].first] = {offset + RECORD_HEADER_SIZE, lengths[i]};
+        offset += RECORD_HEADER_SIZE + size;
+        liveBytes_ += RECORD_HEADER_SIZE + size;
+    }
+    fileBytes_ = offset;
+    return true;
+}
+
+bool LiteratureStore::readAt(const RecordLocation& location, std::string& payload) {
+    // 调用者需要持有 mutex_；压缩记录解压后返回
+    uint32_t size = recordSize(location.length);
+    bool compressed = (location.length & RECORD_COMPRESSED) != 0;
+    std::string stored;
+    std::string& target = compressed ? stored : payload;
+    target.resize(size);
+    if (platform_fseek(file_, static_cast<int64_t>(location.offset), SEEK_SET) != 0 ||
+        fread(&target[0], 1, size, file_) != size) {
+        Logger::getInstance().error("Failed to read literature store: " + path_);
+        payload.clear();
+        return false;
+    }
+    if (compressed && !decompressPayload(stored, payload)) {
+        Logger::getInstance().error("Failed to decompress literature record in " + path_ +
+                                    " at offset " + std::to_string(location.offset));
+        return false;
+    }
+    return true;
+}
+
+bool LiteratureStore::get(int index, std::string& payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(index);
+    if (!file_ || it == index_.end() || !readAt(it->second, payload)) {
+        return false;
+    }
+    auto delta = deltas_.find(index);
+    std::string merged;
+    if (delta != deltas_.end() && merge_(payload, delta->second, merged)) {
+        payload.swap(merged);
+    }
+    return true;
+}
+
+bool LiteratureStore::getMany(const std::vector<int>& indices, std::vector<std::string>& payloads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    payloads.assign(indices.size(), std::string());
+    if (!file_) {
+        return false;
+    }
+    
+    // 按文件偏移排序后顺序读取
+    std::vector<std::pair<uint64_t, size_t>> order;
+    order.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+        auto it = index_.find(indices[i]);
+        if (it != index_.end()) {
+            order.emplace_back(it->second.offset, i);
+        }
+    }
+    std::sort(order.begin(), order.end());
+    
+    for (const auto& item : order) {
+        if (!readAt(index_[indices[item.second]], payloads[item.second])) {
+            return false;
+        }
+        auto delta = deltas_.find(indices[item.second]);
+        std::string merged;
+        if (delta != deltas_.end() && merge_(payloads[item.second], delta->second, merged)) {
+            payloads[item.second].swap(merged);
+        }
+    }
+    return true;
+}
+
+void LiteratureStore::maybeCompact() {
+    // 调用者需要持有 mutex_；重写段文件，只保留每篇文献的最新记录
+    if (fileBytes_ < COMPACT_MIN_BYTES || fileBytes_ - sizeof(SEGMENT_MAGIC) < liveBytes_ * 2) {
+        return;
+    }
+    
+    std::string tempPath = path_ + ".compact";
+    std::FILE* out = fopen(tempPath.c_str(), "wb");
+    if (!out) {
+        Logger::getInstance().error("Failed to create compacted literature store: " + tempPath);
+        return;
+    }
+    
+    // 按文献序号顺序重写，之后按序读取全部文献时即为顺序读
+    std::vector<int> indices;
+    indices.reserve(index_.size());
+    for (const auto& pair : index_) {
+        indices.push_back(pair.first);
+    }
+    std::sort(indices.begin(), indices.end());
+    
+    std::unordered_map<int, RecordLocation> newIndex;
+    uint64_t offset = sizeof(SEGMENT_MAGIC);
+    bool ok = fwrite(SEGMENT_MAGIC, 1, sizeof(SEGMENT_MAGIC), out) == sizeof(SEGMENT_MAGIC);
+    // 记录按当前的压缩设置重新编码，切换压缩设置后已有记录在这里转换
+    bool compress = compress_;
+    std::string payload;
+    std::string compressed;
+    std::string record;
+    for (size_t i = 0; ok && i < indices.size(); i++) {
+        ok = readAt(index_[indices[i]], payload);
+        if (ok) {
+            record.clear();
+            uint32_t length = compress && compressPayload(payload, compressed)
+                ? encodeRecord(record, indices[i], compressed, RECORD_COMPRESSED)
+                : encodeRecord(record, indices[i], payload);
+            ok = fwrite(record.data(), 1, record.size(), out) == record.size();
+            newIndex[indices[i]] = {offset + RECORD_HEADER_SIZE, length};
+            offset += record.size();
+        }
+    }
+    ok = ok && fflush(out) == 0 && platform_fsync(platform_fileno(out)) == 0;
+    fclose(out);
+    
+    if (!ok) {
+        Logger::getInstance().error("Failed to compact literature store: " + path_);
+        std::remove(tempPath.c_str());
+        return;
+    }
+    
+    uint64_t oldBytes = fileBytes_;
+    fclose(file_);
+    file_ = nullptr;
+    if (!replaceFile(tempPath, path_)) {
+        Logger::getInstance().error("Failed to replace literature store: " + path_);
+        std::remove(tempPath.c_str());
+    } else {
+        index_.swap(newIndex);
+        fileBytes_ = offset;
+        liveBytes_ = offset - sizeof(SEGMENT_MAGIC);
+    }
+    
+    file_ = fopen(path_.c_str(), "r+b");
+    if (!file_) {
+        Logger::getInstance().error("Failed to reopen literature store: " + path_);
+        return;
+    }
+    Logger::getInstance().debug("Compacted literature store " + path_ + ": " +
+                                std::to_string(oldBytes) + " -> " + std::to_string(fileBytes_) + " bytes");
+}
+
+void LiteratureStore::reportSize() {
+    // 调用者需要持有 mutex_
+    uint64_t bytes = fileBytes_ + journalBytes_;
+    if (bytes != reportedBytes_ && sizeListener_) {
+        sizeListener_(static_cast<int64_t>(bytes) - static_cast<int64_t>(reportedBytes_));
+    }
+    reportedBytes_ = bytes;
+}
+
+bool LiteratureStore::sync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) {
+        return false;
+    }
+    return fflush(file_) == 0 && platform_fsync(platform_fileno(file_)) == 0;
+}
+
+bool LiteratureStore::putDelta(int index, const std::string& delta) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!journal_ || index_.find(index) == index_.end()) {
+        return false;
+    }
+    deltas_[index] = delta;
+    encodeRecord(journalBuffer_, index, delta);
+    return true;
+}
+
+bool LiteratureStore::commitJournal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool ok = writeJournal();
+    reportSize();
+    return ok;
+}
+
+bool LiteratureStore::writeJournal() {
+    // 调用者需要持有 mutex_；缓冲区中的全部增量一次写入，一次 fdatasync
+    if (!journal_ || journalBuffer_.empty()) {
+        return true;
+    }
+    
+    if (platform_fseek(journal_, static_cast<int64_t>(journalBytes_), SEEK_SET) != 0 ||
+        fwrite(journalBuffer_.data(), 1, journalBuffer_.size(), journal_) != journalBuffer_.size() ||
+        fflush(journal_) != 0 ||
+        platform_fdatasync(platform_fileno(journal_)) != 0) {
+        // 缓冲区保留，下次提交时从同一位置重写
+        Logger::getInstance().error("Failed to write literature journal: " + journalPath_);
+        return false;
+    }
+    journalBytes_ += journalBuffer_.size();
+    journalBuffer_.clear();
+    return true;
+}
+
+bool LiteratureStore::compactJournal() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_ || !journal_) {
+        return false;
+    }
+    bool ok = foldJournal();
+    reportSize();
+    return ok;
+}
+
+uint64_t LiteratureStore::journalBytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return journalBytes_ + journalBuffer_.size();
+}
+
+bool LiteratureStore::foldJournal() {
+    // 调用者需要持有 mutex_；合并后的记录写入段文件并落盘后才清空日志，
+    // 中途崩溃时下次打开会再次重放（增量覆盖同样的字段，重复合并结果不变）
+    if (deltas_.empty() && journalBytes_ <= MAGIC_SIZE) {
+        journalBuffer_.clear();
+        return true;
+    }
+    
+    std::vector<int> indices;
+    indices.reserve(deltas_.size());
+    for (const auto& pair : deltas_) {
+        indices.push_back(pair.first);
+    }
+    std::sort(indices.begin(), indices.end());
+    
+    // 无法合并的增量不折叠，清空日志后重新写入，不会因折叠而丢失
+    std::vector<std::pair<int, std::string>> records;
+    records.reserve(indices.size());
+    std::unordered_map<int, std::string> unmerged;
+    std::string payload;
+    for (int index : indices) {
+        auto it = index_.find(index);
+        if (it != index_.end() && readAt(it->second, payload)) {
+            std::string merged;
+            if (merge_(payload, deltas_[index], merged)) {
+                records.emplace_back(index, std::move(merged));
+            } else {
+                unmerged[index] = deltas_[index];
+            }
+        }
+    }
+    
+    if ((!records.empty() && !append(records)) ||
+        fflush(file_) != 0 || platform_fsync(platform_fileno(file_)) != 0) {
+        Logger::getInstance().error("Failed to fold literature journal: " + journalPath_);
+        return false;
+    }
+    
+    if (!unmerged.empty()) {
+        Logger::getInstance().warning(std::to_string(unmerged.size()) +
+                                      " literature updates could not be merged, kept in journal: " + journalPath_);
+    }
+    deltas_.swap(unmerged);
+    rewriteJournal();
+    
+    maybeCompact();
+    return true;
+}
+
+bool LiteratureStore::rewriteJournal() {
+    // 调用者需要持有 mutex_；清空日志文件后重新写入 deltas_ 中尚未折叠的增量
+    journalBuffer_.clear();
+    fflush(journal_);
+    if (platform_truncate(platform_fileno(journal_), MAGIC_SIZE) != 0 ||
+        platform_fdatasync(platform_fileno(journal_)) != 0) {
+        Logger::getInstance().error("Failed to truncate literature journal: " + journalPath_);
+    }
+    journalBytes_ = MAGIC_SIZE;
+    
+    for (const auto& pair : deltas_) {
+        encodeRecord(journalBuffer_, pair.first, pair.second);
+    }
+    return writeJournal();
+}
@@ -2,6 +2,7 @@
 #include "config_manager.h"
 #include "web_server.h"
 #include "task_queue.h"
+#include "translation_cache.h"
 #include <iostream>
 #include <csignal>
 
@@ -76,6 +77,15 @@ int main(int argc, char* argv[]) {
     Logger::getInstance().setLogArchiveIntervalDays(config.logArchiveIntervalDays);
     Logger::getInstance().startLogManager();
     
+    // 文件写入的落盘方式
+    StorageManager::getInstance().setDurability(config.storageDurability, config.storageSyncIntervalMs);
+    StorageManager::getInstance().setCompression(config.storageCompression);
+    StorageManager::getInstance().setEncoding(config.storageEncoding);
+    
+    // 译文缓存
+    TranslationCache::getInstance().configure(config.translationCacheEnabled, config.translationCacheMemoryMB,
+                                              config.translationCacheDiskMB);
+    
     try {
         // 启动任务队列
         TaskQueue::getInstance().start();
@@ -1,24 +1,39 @@
 #include "storage_manager.h"
+#include "literature_store.h"
 #include "logger.h"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
 #include <cstring>
+#include <atomic>
+#include <zlib.h>
+#include <openssl/evp.h>
+#include <dirent.h>
 
 #ifdef _WIN32
     #include <windows.h>
     #include <direct.h>
     #include <io.h>
     #define platform_mkdir(path, mode) _mkdir(path)
+    #define platform_rmdir _rmdir
+    #define platform_fsync(fd) _commit(fd)
+    #define platform_open _open
+    #define platform_close _close
     #define platform_stat _stat
     #define platform_stat_struct struct _stat
     #define S_ISDIR(mode) (((mode) & _S_IFMT) == _S_IFDIR)
 #else
     #include <sys/stat.h>
     #include <sys/types.h>
-    #include <dirent.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
     #define platform_mkdir mkdir
+    #define platform_rmdir rmdir
+    #define platform_fsync fsync
+    #define platform_open open
+    #define platform_close close
     #define platform_stat stat
     #define platform_stat_struct struct stat
 #endif
@@ -32,6 +47,669 @@
     #define USE_STD_FILESYSTEM 0
 #endif
 
+// 上传暂存区，以 . 开头使遍历任务目录时自动跳过
+static const char* UPLOAD_DIR = "data/.uploads";
+
+// 内容寻址的原始 HTML 及其解析结果缓存
+static const char* BLOB_DIR = "data/.blobs";
+
+// 二进制编码数据开头的格式字节（JSON 文本不会以这些字节开头，没有格式字节的数据按 JSON 读取）
+static const char ENCODING_TAG_CBOR = '\x01';
+static const char ENCODING_TAG_MSGPACK = '\x02';
+
+// 上传文件保留时间（秒），超时未被任务使用则删除
+static const int UPLOAD_RETENTION_SECONDS = 24 * 3600;
+
+// 上传暂存区的清理间隔（秒）
+static const int UPLOAD_CLEANUP_INTERVAL_SECONDS = 3600;
+
+// 同时保持打开的文献存储数量上限
+static const size_t MAX_OPEN_LITERATURE_STORES = 16;
+
+// 压缩保存的任务文件在原文件名后加该后缀（gzip 格式，下载时可直接作为 Content-Encoding: gzip 发送）
+static const char* COMPRESSED_SUFFIX = ".gz";
+
+// 小于该大小的任务文件不压缩
+static const size_t ARTIFACT_COMPRESS_MIN_BYTES = 4096;
+
+// 缓存的任务配置每隔该时间（毫秒）检查一次 config.json 是否被外部修改
+static const int TASK_CONFIG_RECHECK_MS = 1000;
+
+// 文献日志的提交间隔（毫秒）：间隔内各线程的状态更新合并为一次写入和 fdatasync
+static const int JOURNAL_COMMIT_INTERVAL_MS = 100;
+
+// 日志文件超过该大小时折叠进段文件
+static const uint64_t JOURNAL_COMPACT_BYTES = 1024 * 1024;
+
+// 存储用量计数的校正间隔（秒）：全量扫描 data 目录，修正计数与实际占用的偏差
+static const int STORAGE_RECONCILE_INTERVAL_SECONDS = 6 * 3600;
+
+// 将已写入的文件或目录落盘（Windows 下目录无法单独落盘，忽略）
+static bool syncPath(const std::string& path, bool directory) {
+#ifdef _WIN32
+    if (directory) {
+        return true;
+    }
+    int fd = platform_open(path.c_str(), _O_RDWR | _O_BINARY);
+#else
+    int fd = platform_open(path.c_str(), directory ? (O_RDONLY | O_DIRECTORY) : O_RDONLY);
+#endif
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = platform_fsync(fd) == 0;
+    platform_close(fd);
+    return ok;
+}
+
+static std::string parentDirectory(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? "." : path.substr(0, slash);
+}
+
+// 读取文件的修改时间（纳秒）与大小
+static bool statFileVersion(const std::string& path, int64_t& mtime, int64_t& size) {
+    platform_stat_struct st;
+    if (platform_stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    mtime = static_cast<int64_t>(st.st_mtime) * 1000000000LL;
+#else
+    mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    size = static_cast<int64_t>(st.st_size);
+    return true;
+}
+
+static std::string hexDigest(const unsigned char* digest, unsigned int length) {
+    std::ostringstream oss;
+    for (unsigned int i = 0; i < length; i++) {
+        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+    }
+    return oss.str();
+}
+
+static bool gzipCompress(const std::string& input, std::string& output) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    output.resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = static_cast<uInt>(output.size());
+    int result = deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END;
+}
+
+static bool gzipDecompress(const char* data, size_t size, std::string& output) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+        return false;
+    }
+    output.clear();
+    output.reserve(size * 4);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(size);
+    
+    char buffer[65536];
+    int result;
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        result = inflate(&stream, Z_NO_FLUSH);
+        if (result != Z_OK && result != Z_STREAM_END) {
+            break;
+        }
+        output.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while (result != Z_STREAM_END);
+    inflateEnd(&stream);
+    return result == Z_STREAM_END;
+}
+
+// 任务文件可能以原文件名或加 .gz 后缀保存；两种形式同时存在（替换过程中断）时使用较新的一个
+static std::string resolveArtifact(const std::string& path) {
+    int64_t plainMtime = 0;
+    int64_t compressedMtime = 0;
+    int64_t size = 0;
+    bool plain = statFileVersion(path, plainMtime, size);
+    bool compressed = statFileVersion(path + COMPRESSED_SUFFIX, compressedMtime, size);
+    return compressed && (!plain || compressedMtime >= plainMtime) ? path + COMPRESSED_SUFFIX : path;
+}
+
+static json literatureToJson(const LiteratureData& data) {
+    json j;
+    j["index"] = data.index;
+    j["recordNumber"] = data.recordNumber;
+    j["totalRecords"] = data.totalRecords;
+    j["sourceFileName"] = data.sourceFileName;
+    j["sourceFileIndex"] = data.sourceFileIndex;
+    j["indexInFile"] = data.indexInFile;
+    j["originalTitle"] = data.originalTitle;
+    j["originalAbstract"] = data.originalAbstract;
+    j["translatedTitle"] = data.translatedTitle;
+    j["translatedAbstract"] = data.translatedAbstract;
+    j["authors"] = data.authors;
+    j["source"] = data.source;
+    j["volume"] = data.volume;
+    j["issue"] = data.issue;
+    j["pages"] = data.pages;
+    j["doi"] = data.doi;
+    j["earlyAccessDate"] = data.earlyAccessDate;
+    j["publishedDate"] = data.publishedDate;
+    j["accessionNumber"] = data.accessionNumber;
+    j["issn"] = data.issn;
+    j["eissn"] = data.eissn;
+    j["status"] = data.status;
+    j["errorMessage"] = data.errorMessage;
+    j["translatedByModel"] = data.translatedByModel;
+    return j;
+}
+
+static LiteratureData literatureFromJson(const json& j) {
+    LiteratureData data;
+    data.index = j.value("index", 0);
+    data.recordNumber = j.value("recordNumber", 0);
+    data.totalRecords = j.value("totalRecords", 0);
+    data.sourceFileName = j.value("sourceFileName", "");
+    data.sourceFileIndex = j.value("sourceFileIndex", 1);
+    data.indexInFile = j.value("indexInFile", 0);
+    data.originalTitle = j.value("originalTitle", "");
+    data.originalAbstract = j.value("originalAbstract", "");
+    data.translatedTitle = j.value("translatedTitle", "");
+    data.translatedAbstract = j.value("translatedAbstract", "");
+    data.authors = j.value("authors", "");
+    data.source = j.value("source", "");
+    data.volume = j.value("volume", "");
+    data.issue = j.value("issue", "");
+    data.pages = j.value("pages", "");
+    data.doi = j.value("doi", "");
+    data.earlyAccessDate = j.value("earlyAccessDate", "");
+    data.publishedDate = j.value("publishedDate", "");
+    data.accessionNumber = j.value("accessionNumber", "");
+    data.issn = j.value("issn", "");
+    data.eissn = j.value("eissn", "");
+    data.status = j.value("status", "pending");
+    data.errorMessage = j.value("errorMessage", "");
+    data.translatedByModel = j.value("translatedByModel", "");
+    return data;
+}
+
+// 文献增量：翻译过程中会变化的字段
+static json literatureDeltaToJson(const LiteratureData& data) {
+    json j;
+    j["status"] = data.status;
+    j["errorMessage"] = data.errorMessage;
+    j["translatedTitle"] = data.translatedTitle;
+    j["translatedAbstract"] = data.translatedAbstract;
+    j["translatedByModel"] = data.translatedByModel;
+    return j;
+}
+
+// 合并后的记录按当前设置的编码写入；记录或增量无法解码时返回 false，增量由存储保留在日志中
+static bool mergeLiteratureDelta(const std::string& payload, const std::string& delta,
+                                 StorageEncoding encoding, std::string& merged) {
+    try {
+        json j = StorageManager::decodeDocument(payload);
+        j.update(StorageManager::decodeDocument(delta));
+        merged = StorageManager::encodeDocument(j, encoding);
+        return true;
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Failed to merge literature update: " + std::string(e.what()));
+        return false;
+    }
+}
+
+static json taskConfigToJson(const TaskConfig& config) {
+    json j;
+    j["taskId"] = config.taskId;
+    j["taskName"] = config.taskName;
+    j["fileName"] = config.fileName;
+    j["fileNames"] = config.fileNames;
+    j["translateTitle"] = config.translateTitle;
+    j["translateAbstract"] = config.translateAbstract;
+    
+    // 保存模型配置
+    json modelJson;
+    modelJson["url"] = config.modelConfig.url;
+    modelJson["apiKey"] = config.modelConfig.apiKey;
+    modelJson["modelId"] = config.modelConfig.modelId;
+    modelJson["temperature"] = config.modelConfig.temperature;
+    modelJson["systemPrompt"] = config.modelConfig.systemPrompt;
+    modelJson["provider"] = config.modelConfig.provider;
+    modelJson["enableThinking"] = config.modelConfig.enableThinking;
+    modelJson["autoAppendPath"] = config.modelConfig.autoAppendPath;
+    j["modelConfig"] = modelJson;
+    
+    // 保存多模型配置
+    if (!config.modelConfigs.empty()) {
+        json modelsArray = json::array();
+        for (const auto& mwt : config.modelConfigs) {
+            json mj;
+            mj["url"] = mwt.model.url;
+            mj["apiKey"] = mwt.model.apiKey;
+            mj["modelId"] = mwt.model.modelId;
+            mj["name"] = mwt.model.name;
+            mj["temperature"] = mwt.model.temperature;
+            mj["systemPrompt"] = mwt.model.systemPrompt;
+            mj["provider"] = mwt.model.provider;
+            mj["enableThinking"] = mwt.model.enableThinking;
+            mj["autoAppendPath"] = mwt.model.autoAppendPath;
+            mj["threads"] = mwt.threads;
+            modelsArray.push_back(mj);
+        }
+        j["modelConfigs"] = modelsArray;
+    }
+    
+    j["totalCount"] = config.totalCount;
+    j["completedCount"] = config.completedCount;
+    j["failedCount"] = config.failedCount;
+    j["status"] = config.status;
+    j["createdAt"] = config.createdAt;
+    j["updatedAt"] = config.updatedAt;
+    j["deleted"] = config.deleted;
+    if (!config.sourceHash.empty()) {
+        j["sourceHash"] = config.sourceHash;
+    }
+    return j;
+}
+
+static TaskConfig taskConfigFromJson(const json& j) {
+    TaskConfig config;
+    config.taskId = j.value("taskId", "");
+    config.taskName = j.value("taskName", "");
+    config.fileName = j.value("fileName", "");
+    
+    // 加载多文件名
+    if (j.contains("fileNames") && j["fileNames"].is_array()) {
+        config.fileNames = j["fileNames"].get<std::vector<std::string>>();
+    }
+    
+    config.translateTitle = j.value("translateTitle", true);
+    config.translateAbstract = j.value("translateAbstract", true);
+    
+    if (j.contains("modelConfig")) {
+        json modelJson = j["modelConfig"];
+        config.modelConfig.url = modelJson.value("url", "");
+        config.modelConfig.apiKey = modelJson.value("apiKey", "");
+        config.modelConfig.modelId = modelJson.value("modelId", "");
+        config.modelConfig.temperature = modelJson.value("temperature", 0.3f);
+        config.modelConfig.systemPrompt = modelJson.value("systemPrompt", "");
+        config.modelConfig.provider = modelJson.value("provider", "openai");
+        config.modelConfig.enableThinking = modelJson.value("enableThinking", false);
+        config.modelConfig.autoAppendPath = modelJson.value("autoAppendPath", true);
+    }
+    
+    // 加载多模型配置
+    if (j.contains("modelConfigs") && j["modelConfigs"].is_array()) {
+        for (const auto& mj : j["modelConfigs"]) {
+            ModelWithThreads mwt;
+            mwt.model.url = mj.value("url", "");
+            mwt.model.apiKey = mj.value("apiKey", "");
+            mwt.model.modelId = mj.value("modelId", "");
+            mwt.model.name = mj.value("name", "");
+            mwt.model.temperature = mj.value("temperature", 0.3f);
+            mwt.model.systemPrompt = mj.value("systemPrompt", "");
+            mwt.model.provider = mj.value("provider", "openai");
+            mwt.model.enableThinking = mj.value("enableThinking", false);
+            mwt.model.autoAppendPath = mj.value("autoAppendPath", true);
+            mwt.threads = mj.value("threads", 1);
+            config.modelConfigs.push_back(mwt);
+        }
+    }
+    
+    config.totalCount = j.value("totalCount", 0);
+    config.completedCount = j.value("completedCount", 0);
+    config.failedCount = j.value("failedCount", 0);
+    config.status = j.value("status", "pending");
+    config.createdAt = j.value("createdAt", "");
+    config.updatedAt = j.value("updatedAt", "");
+    config.deleted = j.value("deleted", false);
+    config.sourceHash = j.value("sourceHash", "");
+    return config;
+}
+
+UploadWriter::UploadWriter() : file_(nullptr), hashCtx_(nullptr), size_(0) {
+}
+
+UploadWriter::~UploadWriter() {
+    if (file_) {
+        fclose(file_);
+        std::remove(tempPath_.c_str());
+    }
+    if (hashCtx_) {
+        EVP_MD_CTX_free(hashCtx_);
+    }
+}
+
+bool UploadWriter::open() {
+    static std::atomic<unsigned long> sequence(0);
+    
+    platform_mkdir(UPLOAD_DIR, 0755);
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    tempPath_ = std::string(UPLOAD_DIR) + "/tmp-" +
+                std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(now).count()) +
+                "-" + std::to_string(sequence.fetch_add(1)) + ".part";
+    
+    file_ = fopen(tempPath_.c_str(), "wb");
+    if (!file_) {
+        Logger::getInstance().error("Failed to create upload file: " + tempPath_);
+        return false;
+    }
+    
+    hashCtx_ = EVP_MD_CTX_new();
+    if (!hashCtx_ || EVP_DigestInit_ex(hashCtx_, EVP_sha256(), nullptr) != 1) {
+        Logger::getInstance().error("Failed to initialize upload hash");
+        return false;
+    }
+    return true;
+}
+
+bool UploadWriter::write(const char* data, size_t size) {
+    if (!file_ || fwrite(data, 1, size, file_) != size) {
+        Logger::getInstance().error("Failed to write upload file: " + tempPath_);
+        return false;
+    }
+    EVP_DigestUpdate(hashCtx_, data, size);
+    size_ += size;
+    return true;
+}
+
+std::string UploadWriter::commit() {
+    if (!file_) {
+        return "";
+    }
+    
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int hashLength = 0;
+    EVP_DigestFinal_ex(hashCtx_, hash, &hashLength);
+    std::string uploadId = hexDigest(hash, hashLength);
+    
+    // 确保数据落盘后再以最终文件名可见
+    bool flushed = fflush(file_) == 0 && platform_fsync(fileno(file_)) == 0;
+    fclose(file_);
+    file_ = nullptr;
+    
+    std::string path = StorageManager::getInstance().getUploadPath(uploadId);
+    if (!flushed) {
+        Logger::getInstance().error("Failed to flush upload file: " + tempPath_);
+        std::remove(tempPath_.c_str());
+        return "";
+    }
+    if (StorageManager::getInstance().hasUpload(uploadId)) {
+        // 相同内容已上传过
+        std::remove(tempPath_.c_str());
+    } else if (std::rename(tempPath_.c_str(), path.c_str()) != 0) {
+        Logger::getInstance().error("Failed to commit upload file: " + path);
+        std::remove(tempPath_.c_str());
+        return "";
+    } else {
+        StorageManager::getInstance().accountBytes(path, static_cast<int64_t>(size_));
+    }
+    
+    Logger::getInstance().info("Upload stored: " + path + " (" + std::to_string(size_) + " bytes)");
+    return uploadId;
+}
+
+void StorageManager::setDurability(const std::string& mode, int syncIntervalMs) {
+    if (mode == "always") {
+        durability_ = StorageDurability::Always;
+    } else if (mode == "os") {
+        durability_ = StorageDurability::Os;
+    } else {
+        durability_ = StorageDurability::Batched;
+    }
+    syncIntervalMs_ = std::max(10, syncIntervalMs);
+}
+
+void StorageManager::setEncoding(const std::string& mode) {
+    if (mode == "cbor") {
+        encoding_ = StorageEncoding::Cbor;
+    } else if (mode == "msgpack") {
+        encoding_ = StorageEncoding::MessagePack;
+    } else {
+        encoding_ = StorageEncoding::Json;
+    }
+}
+
+std::string StorageManager::encodeDocument(const json& j, StorageEncoding encoding) {
+    std::string data;
+    if (encoding == StorageEncoding::Cbor) {
+        data.push_back(ENCODING_TAG_CBOR);
+        json::to_cbor(j, data);
+    } else if (encoding == StorageEncoding::MessagePack) {
+        data.push_back(ENCODING_TAG_MSGPACK);
+        json::to_msgpack(j, data);
+    } else {
+        data = j.dump();
+    }
+    return data;
+}
+
+json StorageManager::decodeDocument(const std::string& data) {
+    if (!data.empty() && data[0] == ENCODING_TAG_CBOR) {
+        return json::from_cbor(data.begin() + 1, data.end());
+    }
+    if (!data.empty() && data[0] == ENCODING_TAG_MSGPACK) {
+        return json::from_msgpack(data.begin() + 1, data.end());
+    }
+    return json::parse(data);
+}
+
+std::string StorageManager::encodeLiteratureData(const LiteratureData& data, StorageEncoding encoding) {
+    return encodeDocument(literatureToJson(data), encoding);
+}
+
+LiteratureData StorageManager::decodeLiteratureData(const std::string& data) {
+    return literatureFromJson(decodeDocument(data));
+}
+
+std::string StorageManager::encodeTaskConfig(const TaskConfig& config, StorageEncoding encoding) {
+    // JSON 编码的 config.json 保持缩进格式，便于直接查看
+    json j = taskConfigToJson(config);
+    return encoding == StorageEncoding::Json ? j.dump(2) : encodeDocument(j, encoding);
+}
+
+TaskConfig StorageManager::decodeTaskConfig(const std::string& data) {
+    return taskConfigFromJson(decodeDocument(data));
+}
+
+void StorageManager::setCompression(const std::string& mode) {
+    bool enabled = mode == "zlib";
+    compressArtifacts_ = enabled;
+    
+    std::lock_guard<std::mutex> lock(storeMutex_);
+    for (auto& pair : literatureStores_) {
+        pair.second.store->setCompression(enabled);
+    }
+}
+
+bool StorageManager::writeArtifact(const std::string& path, const std::string& content) {
+    std::string compressed;
+    bool useCompressed = compressArtifacts_ && content.size() >= ARTIFACT_COMPRESS_MIN_BYTES &&
+                         gzipCompress(content, compressed) && compressed.size() < content.size();
+    std::string target = useCompressed ? path + COMPRESSED_SUFFIX : path;
+    if (!writeFileAtomic(target, useCompressed ? compressed : content)) {
+        return false;
+    }
+    // 新文件就位后再删除另一种形式的旧文件
+    removeFile(useCompressed ? path : path + COMPRESSED_SUFFIX);
+    return true;
+}
+
+bool StorageManager::loadArtifact(const std::string& path, std::string& content) {
+    auto mapped = mapFile(resolveArtifact(path));
+    return mapped && decodeMappedFile(*mapped, content);
+}
+
+bool StorageManager::decodeMappedFile(const MappedFile& mapped, std::string& content) {
+    if (mapped.encoding().empty()) {
+        content.assign(mapped.data() ? mapped.data() : "", mapped.size());
+        return true;
+    }
+    if (!gzipDecompress(mapped.data(), mapped.size(), content)) {
+        Logger::getInstance().error("Failed to decompress stored file");
+        content.clear();
+        return false;
+    }
+    return true;
+}
+
+bool StorageManager::compressArtifactFile(const std::string& path) {
+    // 未压缩的文件已写入 path：启用压缩时流式压缩为 path.gz，压缩后变小才替换原文件
+    int64_t mtime = 0;
+    int64_t plainSize = 0;
+    if (!compressArtifacts_ || !statFileVersion(path, mtime, plainSize) ||
+        plainSize < static_cast<int64_t>(ARTIFACT_COMPRESS_MIN_BYTES)) {
+        return true;
+    }
+    
+    std::string compressedPath = path + COMPRESSED_SUFFIX;
+    std::string tempPath = compressedPath + ".tmp";
+    std::FILE* in = fopen(path.c_str(), "rb");
+    gzFile out = in ? gzopen(tempPath.c_str(), "wb") : nullptr;
+    bool ok = out != nullptr;
+    char buffer[65536];
+    size_t bytesRead;
+    while (ok && (bytesRead = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        ok = gzwrite(out, buffer, static_cast<unsigned>(bytesRead)) == static_cast<int>(bytesRead);
+    }
+    ok = ok && !ferror(in);
+    if (in) {
+        fclose(in);
+    }
+    if (out) {
+        ok = gzclose(out) == Z_OK && ok;
+    }
+    
+    int64_t compressedSize = 0;
+    if (!ok || !statFileVersion(tempPath, mtime, compressedSize) || compressedSize >= plainSize) {
+        if (!ok) {
+            Logger::getInstance().warning("Failed to compress " + path + ", keeping it uncompressed");
+        }
+        std::remove(tempPath.c_str());
+        return ok;
+    }
+    if (durability_ == StorageDurability::Always && !syncPath(tempPath, false)) {
+        Logger::getInstance().warning("Failed to sync compressed file: " + tempPath);
+    }
+    if (!installFile(tempPath, compressedPath)) {
+        return false;
+    }
+    removeFile(path);
+    return true;
+}
+
+bool StorageManager::writeFileAtomic(const std::string& path, const std::string& content) {
+    // 临时文件名加序号，同一文件的并发写入互不干扰
+    static std::atomic<uint64_t> tempCounter(0);
+    std::string tempPath = path + ".tmp" + std::to_string(++tempCounter);
+    
+    std::FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        Logger::getInstance().error("Failed to open file for writing: " + tempPath);
+        return false;
+    }
+    bool ok = fwrite(content.data(), 1, content.size(), file) == content.size() && fflush(file) == 0;
+    if (ok && durability_ == StorageDurability::Always) {
+        ok = platform_fsync(fileno(file)) == 0;
+    }
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        Logger::getInstance().error("Failed to write file: " + tempPath);
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return installFile(tempPath, path);
+}
+
+bool StorageManager::installFile(const std::string& tempPath, const std::string& path) {
+    // 临时文件的数据在 always 模式下已落盘；替换后按落盘方式同步目录项
+    int64_t mtime = 0;
+    int64_t newSize = 0;
+    int64_t oldSize = 0;
+    statFileVersion(tempPath, mtime, newSize);
+    statFileVersion(path, mtime, oldSize);
+#ifdef _WIN32
+    bool replaced = MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool replaced = std::rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!replaced) {
+        Logger::getInstance().error("Failed to replace file: " + path);
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    accountBytes(path, newSize - oldSize);
+    
+    StorageDurability durability = durability_;
+    if (durability == StorageDurability::Always) {
+        if (!syncPath(parentDirectory(path), true)) {
+            Logger::getInstance().warning("Failed to sync directory of: " + path);
+        }
+    } else if (durability == StorageDurability::Batched) {
+        std::lock_guard<std::mutex> lock(syncMutex_);
+        startSyncThread();
+        if (pendingFileSyncs_.empty()) {
+            nextFileSync_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(syncIntervalMs_.load());
+        }
+        pendingFileSyncs_.insert(path);
+        syncCv_.notify_one();
+    }
+    return true;
+}
+
+bool StorageManager::removeFile(const std::string& path) {
+    int64_t mtime = 0;
+    int64_t size = 0;
+    if (!statFileVersion(path, mtime, size) || std::remove(path.c_str()) != 0) {
+        return false;
+    }
+    accountBytes(path, -size);
+    return true;
+}
+
+void StorageManager::accountBytes(const std::string& path, int64_t delta) {
+    // data/<日期>/<任务>/... 计入该任务，data 下的其他文件（以 . 开头的目录等）计入共享用量
+    static const std::string prefix = "data/";
+    if (delta == 0 || path.compare(0, prefix.size(), prefix) != 0) {
+        return;
+    }
+    std::string taskId;
+    size_t dateEnd = path.find('/', prefix.size());
+    if (path[prefix.size()] != '.' && dateEnd != std::string::npos) {
+        size_t taskEnd = path.find('/', dateEnd + 1);
+        if (taskEnd != std::string::npos) {
+            taskId = path.substr(prefix.size(), taskEnd - prefix.size());
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(usageMutex_);
+    if (taskId.empty()) {
+        sharedUsage_ += delta;
+    } else {
+        taskUsage_[taskId] += delta;
+    }
+    totalUsage_ += delta;
+    usageVersion_++;
+}
+
+void StorageManager::dropTaskUsage(const std::string& taskId) {
+    std::lock_guard<std::mutex> lock(usageMutex_);
+    auto it = taskUsage_.find(taskId);
+    if (it != taskUsage_.end()) {
+        totalUsage_ -= it->second;
+        taskUsage_.erase(it);
+        usageVersion_++;
+    }
+}
+
 StorageManager& StorageManager::getInstance() {
     static StorageManager instance;
     return instance;
@@ -58,249 +736,796 @@ bool StorageManager::createTaskDirectory(const std::string& taskId) {
             return false;
         }
         
-        // 创建list子目录
-        std::string listDir = path + "/list";
-        if (platform_mkdir(listDir.c_str(), 0755) != 0 && errno != EEXIST) {
-            Logger::getInstance().error("Failed to create list directory: " + listDir);
+        Logger::getInstance().info("Created task directory: " + path);
+        return true;
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Exception creating task directory: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool StorageManager::saveTaskConfig(const TaskConfig& config) {
+    try {
+        std::string path = getTaskPath(config.taskId) + "/config.json";
+        
+        // 同一任务的写入按任务的写锁串行，缓存与文件的先后顺序一致；
+        // 编码与写入文件（可能 fsync）不持有 configMutex_，不阻塞其他任务的读取
+        std::shared_ptr<std::mutex> writeMutex;
+        {
+            std::lock_guard<std::mutex> lock(configMutex_);
+            std::shared_ptr<std::mutex>& slot = configWriteMutexes_[config.taskId];
+            if (!slot) {
+                slot = std::make_shared<std::mutex>();
+            }
+            writeMutex = slot;
+        }
+        
+        {
+            std::lock_guard<std::mutex> writeLock(*writeMutex);
+            if (!writeFileAtomic(path, encodeTaskConfig(config, encoding_))) {
+                Logger::getInstance().error("Failed to write config file: " + path);
+                return false;
+            }
+            
+            CachedTaskConfig cached{config, -1, -1, std::chrono::steady_clock::now()};
+            if (!statFileVersion(path, cached.mtime, cached.size)) {
+                cached.mtime = cached.size = -1;
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(configMutex_);
+                configCache_[config.taskId] = std::move(cached);
+            }
+            
+            // 回调也在任务的写锁内调用：同一任务并发保存时，任务目录收到更新的顺序与写入文件的顺序一致，
+            // 不会以较旧的状态覆盖较新的状态
+            std::function<void(const TaskConfig&)> listener;
+            {
+                std::lock_guard<std::mutex> lock(listenerMutex_);
+                listener = taskConfigListener_;
+            }
+            if (listener) {
+                listener(config);
+            }
+        }
+        
+        return true;
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Failed to save task config: " + std::string(e.what()));
+        return false;
+    }
+}
+
+void StorageManager::setTaskConfigListener(std::function<void(const TaskConfig&)> listener) {
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    taskConfigListener_ = std::move(listener);
+}
+
+void StorageManager::setTaskRemovedListener(std::function<void(const std::string&)> listener) {
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    taskRemovedListener_ = std::move(listener);
+}
+
+TaskConfig StorageManager::loadTaskConfig(const std::string& taskId) {
+    std::string path = getTaskPath(taskId) + "/config.json";
+    auto now = std::chrono::steady_clock::now();
+    
+    {
+        std::lock_guard<std::mutex> lock(configMutex_);
+        auto it = configCache_.find(taskId);
+        if (it != configCache_.end() &&
+            now - it->second.checkedAt < std::chrono::milliseconds(TASK_CONFIG_RECHECK_MS)) {
+            return it->second.config;
+        }
+    }
+    
+    // 检查 config.json 是否被外部修改；查询文件与读取文件都不持有 configMutex_
+    int64_t mtime = 0;
+    int64_t size = 0;
+    bool exists = statFileVersion(path, mtime, size);
+    {
+        std::lock_guard<std::mutex> lock(configMutex_);
+        auto it = configCache_.find(taskId);
+        if (it != configCache_.end()) {
+            if (exists && it->second.mtime == mtime && it->second.size == size) {
+                it->second.checkedAt = now;
+                return it->second.config;
+            }
+            configCache_.erase(it);
+        }
+    }
+    
+    TaskConfig config;
+    if (!exists) {
+        Logger::getInstance().error("Failed to open config file: " + path);
+        return config;
+    }
+    if (readTaskConfigFile(path, config)) {
+        // 读取期间保存的配置已放入缓存且不旧于读到的内容，此时以缓存为准
+        std::lock_guard<std::mutex> lock(configMutex_);
+        auto inserted = configCache_.emplace(taskId, CachedTaskConfig{config, mtime, size, now});
+        if (!inserted.second) {
+            return inserted.first->second.config;
+        }
+    }
+    return config;
+}
+    
+bool StorageManager::readTaskConfigFile(const std::string& path, TaskConfig& config) {
+    try {
+        std::ifstream file(path, std::ios::binary);
+        
+        if (!file.is_open()) {
+            Logger::getInstance().error("Failed to open config file: " + path);
             return false;
         }
         
-        Logger::getInstance().info("Created task directory: " + path);
-        return true;
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        config = decodeTaskConfig(content);
+        
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Failed to load task config: " + std::string(e.what()));
+        return false;
+    }
+    
+    return true;
+}
+
+std::string StorageManager::sha256Hex(const std::string& content) {
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int hashLength = 0;
+    EVP_Digest(content.data(), content.size(), hash, &hashLength, EVP_sha256(), nullptr);
+    return hexDigest(hash, hashLength);
+}
+
+std::string StorageManager::getBlobPath(const std::string& hash) {
+    return std::string(BLOB_DIR) + "/" + hash + ".html";
+}
+
+std::string StorageManager::getOriginalHtmlPath(const std::string& taskId) {
+    std::string sourceHash = loadTaskConfig(taskId).sourceHash;
+    return sourceHash.empty() ? getTaskPath(taskId) + "/original.html" : getBlobPath(sourceHash);
+}
+
+void StorageManager::loadBlobRefs() {
+    // 调用者需要持有 blobMutex_
+    if (blobRefsLoaded_) {
+        return;
+    }
+    blobRefsLoaded_ = true;
+    platform_mkdir(BLOB_DIR, 0755);
+    
+    std::ifstream file(std::string(BLOB_DIR) + "/refs.json");
+    if (!file.is_open()) {
+        return;
+    }
+    try {
+        json j;
+        file >> j;
+        for (const auto& item : j.at("refs").items()) {
+            blobRefs_[item.key()] = item.value().get<int>();
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Failed to read source reference counts: " + std::string(e.what()));
+    }
+}
+        
+void StorageManager::saveBlobRefs() {
+    // 调用者需要持有 blobMutex_
+    json j;
+    j["version"] = 1;
+    j["refs"] = blobRefs_;
+    if (!writeFileAtomic(std::string(BLOB_DIR) + "/refs.json", j.dump())) {
+        Logger::getInstance().error("Failed to write source reference counts");
+    }
+}
+
+std::string StorageManager::storeSourceBlob(const std::string& content) {
+    std::string hash = sha256Hex(content);
+    std::lock_guard<std::mutex> lock(blobMutex_);
+    loadBlobRefs();
+    
+    std::string path = getBlobPath(hash);
+    platform_stat_struct st;
+    if (platform_stat(resolveArtifact(path).c_str(), &st) == 0) {
+        Logger::getInstance().info("Reusing stored original HTML: " + hash);
+    } else if (!writeArtifact(path, content)) {
+        Logger::getInstance().error("Failed to write original HTML: " + path);
+        return "";
+    } else {
+        Logger::getInstance().info("Saved original HTML: " + path);
+    }
+    blobRefs_[hash]++;
+    saveBlobRefs();
+    return hash;
+}
+
+std::string StorageManager::loadSourceBlob(const std::string& hash) {
+    std::string content;
+    if (!loadArtifact(getBlobPath(hash), content)) {
+        Logger::getInstance().error("Failed to load original HTML: " + hash);
+        return "";
+    }
+    return content;
+}
+
+void StorageManager::releaseSourceBlob(const std::string& hash) {
+    std::lock_guard<std::mutex> lock(blobMutex_);
+    loadBlobRefs();
+    auto it = blobRefs_.find(hash);
+    if (it == blobRefs_.end()) {
+        return;
+    }
+    if (--it->second > 0) {
+        saveBlobRefs();
+        return;
+    }
+    
+    // 先写入引用计数再删除文件：中途中断只会留下无引用的文件，不会有引用指向已删除的文件
+    blobRefs_.erase(it);
+    saveBlobRefs();
+    std::string path = getBlobPath(hash);
+    std::string cachePath = std::string(BLOB_DIR) + "/" + hash + ".parsed";
+    for (const std::string& file : {path, path + COMPRESSED_SUFFIX, cachePath, cachePath + COMPRESSED_SUFFIX}) {
+        removeFile(file);
+    }
+    Logger::getInstance().info("Removed unreferenced original HTML: " + hash);
+}
+
+bool StorageManager::loadParseCache(const std::string& hash, std::vector<std::vector<Literature>>& files) {
+    std::string content;
+    if (hash.empty() || !loadArtifact(std::string(BLOB_DIR) + "/" + hash + ".parsed", content)) {
+        return false;
+    }
+    try {
+        json j = json::parse(content);
+        files.clear();
+        for (const auto& fileJson : j.at("files")) {
+            std::vector<Literature> literatures;
+            literatures.reserve(fileJson.size());
+            for (const auto& item : fileJson) {
+                literatures.push_back(Literature::fromJson(item));
+            }
+            files.push_back(std::move(literatures));
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().warning("Ignoring damaged parse cache " + hash + ": " + e.what());
+        files.clear();
+        return false;
+    }
+    return true;
+}
+
+void StorageManager::saveParseCache(const std::string& hash, const std::vector<std::vector<Literature>>& files) {
+    // 任务只使用解析出的字段，每条文献的原始 HTML 片段不缓存
+    json filesJson = json::array();
+    for (const auto& literatures : files) {
+        json fileJson = json::array();
+        for (const auto& lit : literatures) {
+            json item = lit.toJson();
+            item.erase("originalHtml");
+            fileJson.push_back(std::move(item));
+        }
+        filesJson.push_back(std::move(fileJson));
+    }
+    json j;
+    j["version"] = 1;
+    j["files"] = std::move(filesJson);
+    
+    std::lock_guard<std::mutex> lock(blobMutex_);
+    loadBlobRefs();
+    if (!blobRefs_.count(hash)) {
+        return;
+    }
+    if (!writeArtifact(std::string(BLOB_DIR) + "/" + hash + ".parsed", j.dump())) {
+        Logger::getInstance().warning("Failed to write parse cache: " + hash);
+    }
+}
+
+std::string StorageManager::loadOriginalHtml(const std::string& taskId) {
+    try {
+        std::string path = getOriginalHtmlPath(taskId);
+        std::string content;
+        
+        if (!loadArtifact(path, content)) {
+            Logger::getInstance().error("Failed to open original.html: " + path);
+            return "";
+        }
+        
+        return content;
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Failed to load original HTML: " + std::string(e.what()));
+        return "";
+    }
+}
+
+bool StorageManager::isValidUploadId(const std::string& uploadId) {
+    if (uploadId.size() != 64) {
+        return false;
+    }
+    for (char c : uploadId) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string StorageManager::getUploadPath(const std::string& uploadId) {
+    return std::string(UPLOAD_DIR) + "/" + uploadId + ".html";
+}
+
+bool StorageManager::hasUpload(const std::string& uploadId) {
+    platform_stat_struct st;
+    return isValidUploadId(uploadId) && platform_stat(getUploadPath(uploadId).c_str(), &st) == 0;
+}
+
+std::string StorageManager::loadUpload(const std::string& uploadId) {
+    try {
+        std::string path = getUploadPath(uploadId);
+        std::ifstream file(path, std::ios::binary);
+        
+        if (!file.is_open()) {
+            Logger::getInstance().error("Failed to open upload: " + path);
+            return "";
+        }
+        
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Failed to load upload: " + std::string(e.what()));
+        return "";
+    }
+}
+
+std::string StorageManager::adoptUploads(const std::vector<std::string>& uploadIds,
+                                         const std::vector<std::string>& fileNames) {
+    try {
+        std::lock_guard<std::mutex> lock(blobMutex_);
+        loadBlobRefs();
+        platform_stat_struct st;
+        std::string hash;
+        
+        if (uploadIds.size() == 1) {
+            // 上传ID即内容哈希：相同内容已保存过时直接删除上传文件，否则重命名，不复制数据
+            hash = uploadIds[0];
+            std::string path = getBlobPath(hash);
+            if (platform_stat(resolveArtifact(path).c_str(), &st) == 0) {
+                removeFile(getUploadPath(hash));
+                Logger::getInstance().info("Reusing stored original HTML: " + hash);
+            } else {
+                // 上传暂存区与原始 HTML 都计入共享用量，重命名不改变用量计数
+                if (std::rename(getUploadPath(hash).c_str(), path.c_str()) != 0) {
+                    Logger::getInstance().error("Failed to move upload to: " + path);
+                    return "";
+                }
+                // 压缩失败时保留未压缩的文件，不影响任务
+                compressArtifactFile(path);
+                Logger::getInstance().info("Saved original HTML: " + path);
+            }
+        } else {
+            // 多文件按原有格式拼接，分块复制到临时文件并同时计算哈希
+            static std::atomic<uint64_t> tempCounter(0);
+            std::string tempPath = std::string(BLOB_DIR) + "/tmp-" + std::to_string(++tempCounter);
+            std::FILE* file = fopen(tempPath.c_str(), "wb");
+            if (!file) {
+                Logger::getInstance().error("Failed to open original HTML for writing: " + tempPath);
+                return "";
+            }
+            EVP_MD_CTX* hashCtx = EVP_MD_CTX_new();
+            EVP_DigestInit_ex(hashCtx, EVP_sha256(), nullptr);
+            auto append = [&](const char* data, size_t size) {
+                EVP_DigestUpdate(hashCtx, data, size);
+                return fwrite(data, 1, size, file) == size;
+            };
+            
+            bool ok = true;
+            char buffer[65536];
+            for (size_t i = 0; ok && i < uploadIds.size(); i++) {
+                std::FILE* upload = fopen(getUploadPath(uploadIds[i]).c_str(), "rb");
+                if (!upload) {
+                    Logger::getInstance().error("Failed to open upload: " + uploadIds[i]);
+                    ok = false;
+                    break;
+                }
+                if (i > 0) {
+                    std::string separator = "\n<!-- File: " + (i < fileNames.size() ? fileNames[i] : "") + " -->\n";
+                    ok = append(separator.data(), separator.size());
+                }
+                size_t bytesRead;
+                while (ok && (bytesRead = fread(buffer, 1, sizeof(buffer), upload)) > 0) {
+                    ok = append(buffer, bytesRead);
+                }
+                ok = ok && !ferror(upload);
+                fclose(upload);
+            }
+            ok = fflush(file) == 0 && ok;
+            if (ok && durability_ == StorageDurability::Always) {
+                ok = platform_fsync(fileno(file)) == 0;
+            }
+            ok = fclose(file) == 0 && ok;
+            
+            unsigned char digest[EVP_MAX_MD_SIZE];
+            unsigned int digestLength = 0;
+            EVP_DigestFinal_ex(hashCtx, digest, &digestLength);
+            EVP_MD_CTX_free(hashCtx);
+            if (!ok) {
+                Logger::getInstance().error("Failed to write original HTML: " + tempPath);
+                std::remove(tempPath.c_str());
+                return "";
+            }
+            
+            hash = hexDigest(digest, digestLength);
+            std::string path = getBlobPath(hash);
+            if (platform_stat(resolveArtifact(path).c_str(), &st) == 0) {
+                std::remove(tempPath.c_str());
+                Logger::getInstance().info("Reusing stored original HTML: " + hash);
+            } else {
+                if (!installFile(tempPath, path)) {
+                    return "";
+                }
+                compressArtifactFile(path);
+                Logger::getInstance().info("Saved original HTML: " + path);
+            }
+        }
+        
+        blobRefs_[hash]++;
+        saveBlobRefs();
+        return hash;
     } catch (const std::exception& e) {
-        Logger::getInstance().error("Exception creating task directory: " + std::string(e.what()));
-        return false;
+        Logger::getInstance().error("Failed to save original HTML: " + std::string(e.what()));
+        return "";
     }
 }
 
-bool StorageManager::saveTaskConfig(const TaskConfig& config) {
+void StorageManager::removeUploads(const std::vector<std::string>& uploadIds) {
+    for (const auto& uploadId : uploadIds) {
+        if (isValidUploadId(uploadId)) {
+            removeFile(getUploadPath(uploadId));
+        }
+    }
+}
+
+int StorageManager::cleanupStaleUploads() {
+    auto now = std::chrono::steady_clock::now();
+    if (now < uploadCleanupDue_) {
+        return 0;
+    }
+    uploadCleanupDue_ = now + std::chrono::seconds(UPLOAD_CLEANUP_INTERVAL_SECONDS);
+    
+    int count = 0;
+#if USE_STD_FILESYSTEM
     try {
-        std::string path = getTaskPath(config.taskId) + "/config.json";
-        
-        json j;
-        j["taskId"] = config.taskId;
-        j["taskName"] = config.taskName;
-        j["fileName"] = config.fileName;
-        j["fileNames"] = config.fileNames;
-        j["translateTitle"] = config.translateTitle;
-        j["translateAbstract"] = config.translateAbstract;
-        
-        // 保存模型配置
-        json modelJson;
-        modelJson["url"] = config.modelConfig.url;
-        modelJson["apiKey"] = config.modelConfig.apiKey;
-        modelJson["modelId"] = config.modelConfig.modelId;
-        modelJson["temperature"] = config.modelConfig.temperature;
-        modelJson["systemPrompt"] = config.modelConfig.systemPrompt;
-        modelJson["provider"] = config.modelConfig.provider;
-        modelJson["enableThinking"] = config.modelConfig.enableThinking;
-        modelJson["autoAppendPath"] = config.modelConfig.autoAppendPath;
-        j["modelConfig"] = modelJson;
-        
-        // 保存多模型配置
-        if (!config.modelConfigs.empty()) {
-            json modelsArray = json::array();
-            for (const auto& mwt : config.modelConfigs) {
-                json mj;
-                mj["url"] = mwt.model.url;
-                mj["apiKey"] = mwt.model.apiKey;
-                mj["modelId"] = mwt.model.modelId;
-                mj["name"] = mwt.model.name;
-                mj["temperature"] = mwt.model.temperature;
-                mj["systemPrompt"] = mwt.model.systemPrompt;
-                mj["provider"] = mwt.model.provider;
-                mj["enableThinking"] = mwt.model.enableThinking;
-                mj["autoAppendPath"] = mwt.model.autoAppendPath;
-                mj["threads"] = mwt.threads;
-                modelsArray.push_back(mj);
-            }
-            j["modelConfigs"] = modelsArray;
+        if (!fs::exists(UPLOAD_DIR)) {
+            return 0;
         }
-        
-        j["totalCount"] = config.totalCount;
-        j["completedCount"] = config.completedCount;
-        j["failedCount"] = config.failedCount;
-        j["status"] = config.status;
-        j["createdAt"] = config.createdAt;
-        j["updatedAt"] = config.updatedAt;
-        j["deleted"] = config.deleted;
-        
-        std::ofstream file(path);
-        if (!file.is_open()) {
-            Logger::getInstance().error("Failed to open config file for writing: " + path);
-            return false;
+        auto deadline = fs::file_time_type::clock::now() - std::chrono::seconds(UPLOAD_RETENTION_SECONDS);
+        for (const auto& entry : fs::directory_iterator(UPLOAD_DIR)) {
+            std::error_code ec;
+            if (entry.is_regular_file(ec) && entry.last_write_time(ec) < deadline && !ec) {
+                if (removeFile(std::string(UPLOAD_DIR) + "/" + entry.path().filename().string())) {
+                    count++;
+                }
+            }
         }
-        
-        file << j.dump(2);
-        file.close();
-        
-        return true;
     } catch (const std::exception& e) {
-        Logger::getInstance().error("Failed to save task config: " + std::string(e.what()));
-        return false;
+        Logger::getInstance().warning("Failed to clean up uploads: " + std::string(e.what()));
     }
+    if (count > 0) {
+        Logger::getInstance().info("Removed " + std::to_string(count) + " stale uploads");
+    }
+#endif
+    return count;
 }
 
-TaskConfig StorageManager::loadTaskConfig(const std::string& taskId) {
-    TaskConfig config;
+std::shared_ptr<LiteratureStore> StorageManager::getLiteratureStore(const std::string& taskId) {
+    // 打开存储（扫描段文件、重放日志、迁移旧版文献）不持有 storeMutex_，不阻塞其他任务的读写；
+    // 同一任务同时只由一个线程打开，其他线程等待其结果
+    std::promise<std::shared_ptr<LiteratureStore>> promise;
+    std::shared_future<std::shared_ptr<LiteratureStore>> opening;
+    {
+        std::lock_guard<std::mutex> lock(storeMutex_);
+        auto it = literatureStores_.find(taskId);
+        if (it != literatureStores_.end()) {
+            it->second.lastUsed = ++storeClock_;
+            return it->second.store;
+        }
+        auto pending = openingStores_.find(taskId);
+        if (pending != openingStores_.end()) {
+            opening = pending->second;
+        } else {
+            openingStores_[taskId] = promise.get_future().share();
+        }
+    }
+    if (opening.valid()) {
+        return opening.get();
+    }
     
+    std::shared_ptr<LiteratureStore> store;
     try {
-        std::string path = getTaskPath(taskId) + "/config.json";
-        std::ifstream file(path);
-        
-        if (!file.is_open()) {
-            Logger::getInstance().error("Failed to open config file: " + path);
-            return config;
-        }
-        
-        json j;
-        file >> j;
-        
-        config.taskId = j.value("taskId", "");
-        config.taskName = j.value("taskName", "");
-        config.fileName = j.value("fileName", "");
-        
-        // 加载多文件名
-        if (j.contains("fileNames") && j["fileNames"].is_array()) {
-            config.fileNames = j["fileNames"].get<std::vector<std::string>>();
-        }
-        
-        config.translateTitle = j.value("translateTitle", true);
-        config.translateAbstract = j.value("translateAbstract", true);
-        
-        if (j.contains("modelConfig")) {
-            json modelJson = j["modelConfig"];
-            config.modelConfig.url = modelJson.value("url", "");
-            config.modelConfig.apiKey = modelJson.value("apiKey", "");
-            config.modelConfig.modelId = modelJson.value("modelId", "");
-            config.modelConfig.temperature = modelJson.value("temperature", 0.3f);
-            config.modelConfig.systemPrompt = modelJson.value("systemPrompt", "");
-            config.modelConfig.provider = modelJson.value("provider", "openai");
-            config.modelConfig.enableThinking = modelJson.value("enableThinking", false);
-            config.modelConfig.autoAppendPath = modelJson.value("autoAppendPath", true);
-        }
-        
-        // 加载多模型配置
-        if (j.contains("modelConfigs") && j["modelConfigs"].is_array()) {
-            for (const auto& mj : j["modelConfigs"]) {
-                ModelWithThreads mwt;
-                mwt.model.url = mj.value("url", "");
-                mwt.model.apiKey = mj.value("apiKey", "");
-                mwt.model.modelId = mj.value("modelId", "");
-                mwt.model.name = mj.value("name", "");
-                mwt.model.temperature = mj.value("temperature", 0.3f);
-                mwt.model.systemPrompt = mj.value("systemPrompt", "");
-                mwt.model.provider = mj.value("provider", "openai");
-                mwt.model.enableThinking = mj.value("enableThinking", false);
-                mwt.model.autoAppendPath = mj.value("autoAppendPath", true);
-                mwt.threads = mj.value("threads", 1);
-                config.modelConfigs.push_back(mwt);
+        store = openLiteratureStore(taskId);
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Failed to open literature store: " + std::string(e.what()));
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(storeMutex_);
+        openingStores_.erase(taskId);
+        if (store) {
+            // 打开期间压缩设置可能已修改
+            store->setCompression(compressArtifacts_);
+            
+            // 关闭最久未使用且没有其他线程在用的存储（同一任务始终只有一个打开的存储）
+            if (literatureStores_.size() >= MAX_OPEN_LITERATURE_STORES) {
+                auto oldest = literatureStores_.end();
+                for (auto iter = literatureStores_.begin(); iter != literatureStores_.end(); ++iter) {
+                    if (iter->second.store.use_count() == 1 &&
+                        (oldest == literatureStores_.end() || iter->second.lastUsed < oldest->second.lastUsed)) {
+                        oldest = iter;
+                    }
+                }
+                if (oldest != literatureStores_.end()) {
+                    literatureStores_.erase(oldest);
+                }
             }
+            
+            literatureStores_[taskId] = {store, ++storeClock_};
         }
-        
-        config.totalCount = j.value("totalCount", 0);
-        config.completedCount = j.value("completedCount", 0);
-        config.failedCount = j.value("failedCount", 0);
-        config.status = j.value("status", "pending");
-        config.createdAt = j.value("createdAt", "");
-        config.updatedAt = j.value("updatedAt", "");
-        config.deleted = j.value("deleted", false);
-        
-    } catch (const std::exception& e) {
-        Logger::getInstance().error("Failed to load task config: " + std::string(e.what()));
+    }
+    promise.set_value(store);
+    return store;
+}
+
+std::shared_ptr<LiteratureStore> StorageManager::openLiteratureStore(const std::string& taskId) {
+    // 只为已存在的任务目录打开存储，避免为无效的任务ID创建文件
+    std::string taskPath = getTaskPath(taskId);
+    platform_stat_struct st;
+    if (platform_stat(taskPath.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return nullptr;
     }
     
-    return config;
+    std::string segmentPath = taskPath + "/literatures.seg";
+    bool exists = platform_stat(segmentPath.c_str(), &st) == 0;
+    auto store = std::make_shared<LiteratureStore>(segmentPath, [this](const std::string& payload, const std::string& delta,
+                                                                      std::string& merged) {
+        return mergeLiteratureDelta(payload, delta, encoding_, merged);
+    });
+    store->setCompression(compressArtifacts_);
+    store->setSizeListener([this, segmentPath](int64_t delta) { accountBytes(segmentPath, delta); });
+    if (!store->open()) {
+        return nullptr;
+    }
+    if (!exists) {
+        migrateLegacyLiteratures(taskId, *store);
+    }
+    return store;
+}
+
+void StorageManager::closeLiteratureStore(const std::string& taskId) {
+    std::lock_guard<std::mutex> lock(storeMutex_);
+    literatureStores_.erase(taskId);
+}
+
+void StorageManager::migrateLegacyLiteratures(const std::string& taskId, LiteratureStore& store) {
+    // 旧版任务每篇文献一个 list/<序号>.json，迁移到段文件后删除
+    std::string listDir = getTaskPath(taskId) + "/list";
+    platform_stat_struct st;
+    if (platform_stat(listDir.c_str(), &st) != 0) {
+        return;
+    }
+    
+    std::vector<int> indices = loadIndexJson(taskId);
+    std::vector<std::pair<int, std::string>> records;
+    std::vector<std::string> legacyFiles;
+    for (int index : indices) {
+        std::string path = listDir + "/" + std::to_string(index) + ".json";
+        if (platform_stat(path.c_str(), &st) != 0) {
+            continue;
+        }
+        records.emplace_back(index, encodeLiteratureData(loadLegacyLiteratureData(taskId, index), encoding_));
+        legacyFiles.push_back(path);
+    }
+    
+    // 段文件落盘后才删除旧文件；迁移失败时旧文件保留，读取时仍可回退到旧文件
+    if (!records.empty() && !(store.putBatch(records) && store.sync())) {
+        Logger::getInstance().error("Failed to migrate literatures of task: " + taskId);
+        return;
+    }
+    for (const auto& path : legacyFiles) {
+        removeFile(path);
+    }
+    platform_rmdir(listDir.c_str());
+    
+    Logger::getInstance().info("Migrated " + std::to_string(records.size()) +
+                               " literatures to segment store: " + taskId);
 }
 
-bool StorageManager::saveOriginalHtml(const std::string& taskId, const std::string& content) {
+bool StorageManager::saveLiteratureData(const std::string& taskId, int index, const LiteratureData& data) {
     try {
-        std::string path = getTaskPath(taskId) + "/original.html";
-        std::ofstream file(path);
-        
-        if (!file.is_open()) {
-            Logger::getInstance().error("Failed to open original.html for writing: " + path);
+        std::shared_ptr<LiteratureStore> store = getLiteratureStore(taskId);
+        if (!store) {
+            Logger::getInstance().error("Failed to open literature store for task: " + taskId);
             return false;
         }
-        
-        file << content;
-        file.close();
-        
-        Logger::getInstance().info("Saved original HTML: " + path);
-        return true;
+        return store->put(index, encodeLiteratureData(data, encoding_));
     } catch (const std::exception& e) {
-        Logger::getInstance().error("Failed to save original HTML: " + std::string(e.what()));
+        Logger::getInstance().error("Failed to save literature data: " + std::string(e.what()));
         return false;
     }
 }
-
-std::string StorageManager::loadOriginalHtml(const std::string& taskId) {
-    try {
-        std::string path = getTaskPath(taskId) + "/original.html";
-        std::ifstream file(path);
         
-        if (!file.is_open()) {
-            Logger::getInstance().error("Failed to open original.html: " + path);
-            return "";
+bool StorageManager::saveLiteratureBatch(const std::string& taskId, const std::vector<LiteratureData>& literatures) {
+    try {
+        std::shared_ptr<LiteratureStore> store = getLiteratureStore(taskId);
+        if (!store) {
+            Logger::getInstance().error("Failed to open literature store for task: " + taskId);
+            return false;
         }
         
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        return buffer.str();
+        std::vector<std::pair<int, std::string>> records;
+        records.reserve(literatures.size());
+        for (const auto& data : literatures) {
+            records.emplace_back(data.index, encodeLiteratureData(data, encoding_));
+        }
+        return store->putBatch(records);
     } catch (const std::exception& e) {
-        Logger::getInstance().error("Failed to load original HTML: " + std::string(e.what()));
-        return "";
+        Logger::getInstance().error("Failed to save literature data: " + std::string(e.what()));
+        return false;
     }
 }
 
-bool StorageManager::saveLiteratureData(const std::string& taskId, int index, const LiteratureData& data) {
-    try {
-        std::string path = getTaskPath(taskId) + "/list/" + std::to_string(index) + ".json";
+bool StorageManager::updateLiteratureStatus(const std::string& taskId, int index, const LiteratureData& data) {
+    std::shared_ptr<LiteratureStore> store = getLiteratureStore(taskId);
+    if (!store || !store->putDelta(index, encodeDocument(literatureDeltaToJson(data), encoding_))) {
+        // 记录尚不在段文件中（如旧版任务迁移失败）时写入完整记录
+        return saveLiteratureData(taskId, index, data);
+    }
+    
+    std::lock_guard<std::mutex> lock(syncMutex_);
+    startSyncThread();
+    if (!journalPending_) {
+        journalPending_ = true;
+        journalDeadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(JOURNAL_COMMIT_INTERVAL_MS);
+        syncCv_.notify_one();
+    }
+    return true;
+}
+
+void StorageManager::startSyncThread() {
+    // 调用者需要持有 syncMutex_
+    if (!syncThread_.joinable() && !syncStopped_) {
+        syncRunning_ = true;
+        syncThread_ = std::thread(&StorageManager::syncLoop, this);
+    }
+}
         
-        json j;
-        j["index"] = data.index;
-        j["recordNumber"] = data.recordNumber;
-        j["totalRecords"] = data.totalRecords;
-        j["sourceFileName"] = data.sourceFileName;
-        j["sourceFileIndex"] = data.sourceFileIndex;
-        j["indexInFile"] = data.indexInFile;
-        j["originalTitle"] = data.originalTitle;
-        j["originalAbstract"] = data.originalAbstract;
-        j["translatedTitle"] = data.translatedTitle;
-        j["translatedAbstract"] = data.translatedAbstract;
-        j["authors"] = data.authors;
-        j["source"] = data.source;
-        j["volume"] = data.volume;
-        j["issue"] = data.issue;
-        j["pages"] = data.pages;
-        j["doi"] = data.doi;
-        j["earlyAccessDate"] = data.earlyAccessDate;
-        j["publishedDate"] = data.publishedDate;
-        j["accessionNumber"] = data.accessionNumber;
-        j["issn"] = data.issn;
-        j["eissn"] = data.eissn;
-        j["status"] = data.status;
-        j["errorMessage"] = data.errorMessage;
-        j["translatedByModel"] = data.translatedByModel;
-        
-        std::ofstream file(path);
-        if (!file.is_open()) {
-            Logger::getInstance().error("Failed to open literature file for writing: " + path);
-            return false;
+void StorageManager::syncLoop() {
+    std::unique_lock<std::mutex> lock(syncMutex_);
+    while (true) {
+        syncCv_.wait(lock, [this] { return !syncRunning_ || journalPending_ || !pendingFileSyncs_.empty(); });
+        
+        // 等到最早的提交时间：日志为首次更新后一个提交间隔，文件为首次替换后一个落盘间隔，
+        // 期间各线程的更新合并为一次落盘
+        auto nextDeadline = [this] {
+            auto deadline = std::chrono::steady_clock::time_point::max();
+            if (journalPending_) {
+                deadline = journalDeadline_;
+            }
+            if (!pendingFileSyncs_.empty()) {
+                deadline = std::min(deadline, nextFileSync_);
+            }
+            return deadline;
+        };
+        auto deadline = nextDeadline();
+        auto now = std::chrono::steady_clock::now();
+        if (syncRunning_ && now < deadline) {
+            syncCv_.wait_until(lock, deadline, [&] { return !syncRunning_ || nextDeadline() < deadline; });
+            continue;
+        }
+        
+        bool commitJournals = journalPending_ && (!syncRunning_ || now >= journalDeadline_);
+        if (commitJournals) {
+            journalPending_ = false;
+        }
+        std::set<std::string> files;
+        if (!syncRunning_ || now >= nextFileSync_) {
+            files.swap(pendingFileSyncs_);
         }
+        bool running = syncRunning_;
+        lock.unlock();
         
-        file << j.dump(2);
-        file.close();
+        if (commitJournals) {
+            std::vector<std::shared_ptr<LiteratureStore>> stores;
+            {
+                std::lock_guard<std::mutex> storeLock(storeMutex_);
+                for (const auto& pair : literatureStores_) {
+                    stores.push_back(pair.second.store);
+                }
+            }
+            for (const auto& store : stores) {
+                store->commitJournal();
+                if (store->journalBytes() >= JOURNAL_COMPACT_BYTES) {
+                    store->compactJournal();
+                }
+            }
+        }
         
-        return true;
-    } catch (const std::exception& e) {
-        Logger::getInstance().error("Failed to save literature data: " + std::string(e.what()));
-        return false;
+        // 批量落盘：文件内容和所在目录（目录项即 rename 的结果）各 fsync 一次
+        std::set<std::string> directories;
+        for (const auto& path : files) {
+            syncPath(path, false);
+            directories.insert(parentDirectory(path));
+        }
+        for (const auto& directory : directories) {
+            syncPath(directory, true);
+        }
+        
+        if (!running) {
+            break;
+        }
+        lock.lock();
+    }
+}
+
+StorageManager::~StorageManager() {
+    {
+        std::lock_guard<std::mutex> lock(syncMutex_);
+        syncRunning_ = false;
+        syncStopped_ = true;
     }
+    syncCv_.notify_one();
+    if (syncThread_.joinable()) {
+        syncThread_.join();
+    }
+    // 之后关闭的文献存储在析构时写入剩余的增量
 }
 
 LiteratureData StorageManager::loadLiteratureData(const std::string& taskId, int index) {
+    std::shared_ptr<LiteratureStore> store = getLiteratureStore(taskId);
+    std::string payload;
+    if (store && store->get(index, payload)) {
+        try {
+            return decodeLiteratureData(payload);
+        } catch (const std::exception& e) {
+            Logger::getInstance().error("Failed to load literature data: " + std::string(e.what()));
+        }
+    }
+    return loadLegacyLiteratureData(taskId, index);
+}
+
+std::vector<LiteratureData> StorageManager::loadAllLiteratureData(const std::string& taskId) {
+    return loadLiteratureDataBatch(taskId, loadIndexJson(taskId));
+}
+
+std::vector<LiteratureData> StorageManager::loadLiteratureDataBatch(const std::string& taskId,
+                                                                    const std::vector<int>& indices) {
+    std::vector<std::string> payloads;
+    std::shared_ptr<LiteratureStore> store = getLiteratureStore(taskId);
+    if (store) {
+        store->getMany(indices, payloads);
+    }
+    payloads.resize(indices.size());
+    
+    std::vector<LiteratureData> literatures;
+    literatures.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (!payloads[i].empty()) {
+            try {
+                literatures.push_back(decodeLiteratureData(payloads[i]));
+                continue;
+            } catch (const std::exception& e) {
+                Logger::getInstance().error("Failed to load literature data: " + std::string(e.what()));
+            }
+        }
+        literatures.push_back(loadLegacyLiteratureData(taskId, indices[i]));
+    }
+    return literatures;
+}
+
+LiteratureData StorageManager::loadLegacyLiteratureData(const std::string& taskId, int index) {
     LiteratureData data;
+    data.index = index;
     data.sourceFileIndex = 1;
     data.indexInFile = 0;
     
@@ -315,31 +1540,7 @@ LiteratureData StorageManager::loadLiteratureData(const std::string& taskId, int
         
         json j;
         file >> j;
-        
-        data.index = j.value("index", 0);
-        data.recordNumber = j.value("recordNumber", 0);
-        data.totalRecords = j.value("totalRecords", 0);
-        data.sourceFileName = j.value("sourceFileName", "");
-        data.sourceFileIndex = j.value("sourceFileIndex", 1);
-        data.indexInFile = j.value("indexInFile", 0);
-        data.originalTitle = j.value("originalTitle", "");
-        data.originalAbstract = j.value("originalAbstract", "");
-        data.translatedTitle = j.value("translatedTitle", "");
-        data.translatedAbstract = j.value("translatedAbstract", "");
-        data.authors = j.value("authors", "");
-        data.source = j.value("source", "");
-        data.volume = j.value("volume", "");
-        data.issue = j.value("issue", "");
-        data.pages = j.value("pages", "");
-        data.doi = j.value("doi", "");
-        data.earlyAccessDate = j.value("earlyAccessDate", "");
-        data.publishedDate = j.value("publishedDate", "");
-        data.accessionNumber = j.value("accessionNumber", "");
-        data.issn = j.value("issn", "");
-        data.eissn = j.value("eissn", "");
-        data.status = j.value("status", "pending");
-        data.errorMessage = j.value("errorMessage", "");
-        data.translatedByModel = j.value("translatedByModel", "");
+        data = literatureFromJson(j);
         
     } catch (const std::exception& e) {
         Logger::getInstance().error("Failed to load literature data: " + std::string(e.what()));
@@ -351,16 +1552,11 @@ LiteratureData StorageManager::loadLiteratureData(const std::string& taskId, int
 bool StorageManager::saveTranslatedHtml(const std::string& taskId, const std::string& content) {
     try {
         std::string path = getTaskPath(taskId) + "/translated.html";
-        std::ofstream file(path);
-        
-        if (!file.is_open()) {
-            Logger::getInstance().error("Failed to open translated.html for writing: " + path);
+        if (!writeArtifact(path, content)) {
+            Logger::getInstance().error("Failed to write translated.html: " + path);
             return false;
         }
         
-        file << content;
-        file.close();
-        
         Logger::getInstance().info("Saved translated HTML: " + path);
         return true;
     } catch (const std::exception& e) {
@@ -371,22 +1567,108 @@ bool StorageManager::saveTranslatedHtml(const std::string& taskId, const std::st
 
 std::string StorageManager::loadTranslatedHtml(const std::string& taskId) {
     try {
-        std::string path = getTaskPath(taskId) + "/translated.html";
-        std::ifstream file(path);
+        std::string content;
         
-        if (!file.is_open()) {
+        if (!loadArtifact(getTaskPath(taskId) + "/translated.html", content)) {
             return "";
         }
         
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        return buffer.str();
+        return content;
     } catch (const std::exception& e) {
         Logger::getInstance().error("Failed to load translated HTML: " + std::string(e.what()));
         return "";
     }
 }
 
+std::shared_ptr<MappedFile> StorageManager::mapOriginalHtml(const std::string& taskId) {
+    return mapFile(resolveArtifact(getOriginalHtmlPath(taskId)));
+}
+
+std::shared_ptr<MappedFile> StorageManager::mapTranslatedHtml(const std::string& taskId) {
+    return mapFile(resolveArtifact(getTaskPath(taskId) + "/translated.html"));
+}
+
+MappedFile::~MappedFile() {
+    if (!data_) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+std::shared_ptr<MappedFile> StorageManager::mapFile(const std::string& path) {
+    std::shared_ptr<MappedFile> mapped(new MappedFile());
+    size_t suffixLength = strlen(COMPRESSED_SUFFIX);
+    if (path.size() > suffixLength && path.compare(path.size() - suffixLength, suffixLength, COMPRESSED_SUFFIX) == 0) {
+        mapped->encoding_ = "gzip";
+    }
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER size;
+    FILETIME written;
+    if (!GetFileSizeEx(file, &size) || !GetFileTime(file, nullptr, nullptr, &written)) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    mapped->size_ = static_cast<size_t>(size.QuadPart);
+    // FILETIME 为自 1601 年起的 100 纳秒数
+    ULARGE_INTEGER ticks;
+    ticks.LowPart = written.dwLowDateTime;
+    ticks.HighPart = written.dwHighDateTime;
+    mapped->mtime_ = (static_cast<int64_t>(ticks.QuadPart) - 116444736000000000LL) * 100;
+    
+    if (mapped->size_ > 0) {
+        // 映射视图独立持有文件映射，句柄可以立即关闭
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            mapped->data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+        }
+        if (!mapped->data_) {
+            CloseHandle(file);
+            Logger::getInstance().error("Failed to map file: " + path);
+            return nullptr;
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = platform_open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        platform_close(fd);
+        return nullptr;
+    }
+    mapped->size_ = static_cast<size_t>(st.st_size);
+    mapped->mtime_ = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    
+    if (mapped->size_ > 0) {
+        // 映射建立后不再需要文件描述符；长度为 0 的文件不能映射，保持 data 为空
+        void* data = mmap(nullptr, mapped->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            platform_close(fd);
+            Logger::getInstance().error("Failed to map file: " + path + " (" + strerror(errno) + ")");
+            return nullptr;
+        }
+        madvise(data, mapped->size_, MADV_SEQUENTIAL);
+        mapped->data_ = static_cast<const char*>(data);
+    }
+    platform_close(fd);
+#endif
+
+    return mapped;
+}
+
 bool StorageManager::saveIndexJson(const std::string& taskId, const std::vector<int>& indices) {
     try {
         std::string path = getTaskPath(taskId) + "/index.json";
@@ -396,15 +1678,11 @@ bool StorageManager::saveIndexJson(const std::string& taskId, const std::vector<
             j.push_back(index);
         }
         
-        std::ofstream file(path);
-        if (!file.is_open()) {
-            Logger::getInstance().error("Failed to open index.json for writing: " + path);
+        if (!writeFileAtomic(path, j.dump(2))) {
+            Logger::getInstance().error("Failed to write index.json: " + path);
             return false;
         }
         
-        file << j.dump(2);
-        file.close();
-        
         return true;
     } catch (const std::exception& e) {
         Logger::getInstance().error("Failed to save index.json: " + std::string(e.what()));
@@ -440,41 +1718,54 @@ std::vector<int> StorageManager::loadIndexJson(const std::string& taskId) {
 bool StorageManager::deleteTask(const std::string& taskId) {
     try {
         std::string path = getTaskPath(taskId);
+        std::string sourceHash = loadTaskConfig(taskId).sourceHash;
+        closeLiteratureStore(taskId);
+        {
+            std::lock_guard<std::mutex> lock(configMutex_);
+            configCache_.erase(taskId);
+            configWriteMutexes_.erase(taskId);
+        }
         
+        std::function<void(const std::string&)> removedListener;
+        {
+            std::lock_guard<std::mutex> lock(listenerMutex_);
+            removedListener = taskRemovedListener_;
+        }
+        if (removedListener) {
+            removedListener(taskId);
+        }
+
+        bool deleted;
+        std::string detail;
 #if USE_STD_FILESYSTEM
         // 使用 C++17 filesystem
         std::error_code ec;
         fs::remove_all(path, ec);
-        if (!ec) {
-            Logger::getInstance().info("Deleted task: " + taskId);
-            return true;
-        } else {
-            Logger::getInstance().error("Failed to delete task: " + taskId + " - " + ec.message());
-            return false;
+        deleted = !ec;
+        if (ec) {
+            detail = " - " + ec.message();
         }
 #elif defined(_WIN32)
         // Windows: 使用 system 命令
         std::string command = "rmdir /s /q \"" + path + "\"";
-        int result = system(command.c_str());
-        if (result == 0) {
-            Logger::getInstance().info("Deleted task: " + taskId);
-            return true;
-        } else {
-            Logger::getInstance().error("Failed to delete task: " + taskId);
-            return false;
-        }
+        deleted = system(command.c_str()) == 0;
 #else
         // Linux: 使用 rm -rf
         std::string command = "rm -rf \"" + path + "\"";
-        int result = system(command.c_str());
-        if (result == 0) {
-            Logger::getInstance().info("Deleted task: " + taskId);
-            return true;
-        } else {
-            Logger::getInstance().error("Failed to delete task: " + taskId);
+        deleted = system(command.c_str()) == 0;
+#endif
+        if (!deleted) {
+            Logger::getInstance().error("Failed to delete task: " + taskId + detail);
             return false;
         }
-#endif
+        dropTaskUsage(taskId);
+        
+        // 任务目录删除后再释放原始 HTML 的引用
+        if (!sourceHash.empty()) {
+            releaseSourceBlob(sourceHash);
+        }
+        Logger::getInstance().info("Deleted task: " + taskId);
+        return true;
     } catch (const std::exception& e) {
         Logger::getInstance().error("Exception deleting task: " + std::string(e.what()));
         return false;
@@ -688,7 +1979,116 @@ static uint64_t calculateDirSize(const std::string& path) {
 }
 
 uint64_t StorageManager::getStorageUsage() {
-    return calculateDirSize("data");
+    bool known;
+    {
+        std::lock_guard<std::mutex> lock(usageMutex_);
+        known = usageKnown_;
+    }
+    // 计数尚未建立（没有保存的计数且后台尚未扫描）时先扫描一次
+    if (!known) {
+        reconcileStorageUsage(true);
+    }
+    std::lock_guard<std::mutex> lock(usageMutex_);
+    return totalUsage_ > 0 ? static_cast<uint64_t>(totalUsage_) : 0;
+}
+
+bool StorageManager::getUsageSnapshot(StorageUsageSnapshot& snapshot) {
+    std::lock_guard<std::mutex> lock(usageMutex_);
+    if (!usageKnown_) {
+        return false;
+    }
+    snapshot.tasks = taskUsage_;
+    snapshot.shared = sharedUsage_;
+    return true;
+}
+
+uint64_t StorageManager::getUsageVersion() {
+    std::lock_guard<std::mutex> lock(usageMutex_);
+    return usageVersion_;
+}
+
+void StorageManager::restoreUsage(const StorageUsageSnapshot& snapshot, bool stale) {
+    std::lock_guard<std::mutex> lock(usageMutex_);
+    taskUsage_ = snapshot.tasks;
+    sharedUsage_ = snapshot.shared;
+    totalUsage_ = snapshot.shared;
+    for (const auto& pair : taskUsage_) {
+        totalUsage_ += pair.second;
+    }
+    usageKnown_ = true;
+    usageVersion_++;
+    usageReconcileDue_ = stale ? std::chrono::steady_clock::now()
+                               : std::chrono::steady_clock::now() + std::chrono::seconds(STORAGE_RECONCILE_INTERVAL_SECONDS);
+}
+
+void StorageManager::reconcileStorageUsage(bool force) {
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(usageMutex_);
+        if (!force && usageKnown_ && now < usageReconcileDue_) {
+            return;
+        }
+        usageReconcileDue_ = now + std::chrono::seconds(STORAGE_RECONCILE_INTERVAL_SECONDS);
+    }
+    
+    // 按与 accountBytes 相同的规则分组统计；扫描期间的写入可能漏计或重复计入，留待下次校正
+    std::unordered_map<std::string, int64_t> tasks;
+    int64_t shared = 0;
+    DIR* dir = opendir("data");
+    if (dir) {
+        struct dirent* dateEntry;
+        while ((dateEntry = readdir(dir)) != nullptr) {
+            std::string dateName = dateEntry->d_name;
+            if (dateName == "." || dateName == "..") continue;
+            
+            std::string datePath = "data/" + dateName;
+            platform_stat_struct st;
+            if (platform_stat(datePath.c_str(), &st) != 0) continue;
+            if (!S_ISDIR(st.st_mode)) {
+                shared += static_cast<int64_t>(st.st_size);
+                continue;
+            }
+            if (dateName[0] == '.') {
+                shared += static_cast<int64_t>(calculateDirSize(datePath));
+                continue;
+            }
+            
+            DIR* dateDir = opendir(datePath.c_str());
+            if (!dateDir) continue;
+            struct dirent* taskEntry;
+            while ((taskEntry = readdir(dateDir)) != nullptr) {
+                std::string taskName = taskEntry->d_name;
+                if (taskName == "." || taskName == "..") continue;
+                
+                std::string taskPath = datePath + "/" + taskName;
+                if (platform_stat(taskPath.c_str(), &st) != 0) continue;
+                if (S_ISDIR(st.st_mode)) {
+                    tasks[dateName + "/" + taskName] = static_cast<int64_t>(calculateDirSize(taskPath));
+                } else {
+                    shared += static_cast<int64_t>(st.st_size);
+                }
+            }
+            closedir(dateDir);
+        }
+        closedir(dir);
+    }
+    
+    int64_t total = shared;
+    for (const auto& pair : tasks) {
+        total += pair.second;
+    }
+    
+    std::lock_guard<std::mutex> lock(usageMutex_);
+    if (usageKnown_ && total != totalUsage_) {
+        Logger::getInstance().info("Storage usage reconciled: " +
+                                   formatStorageSize(totalUsage_ > 0 ? static_cast<uint64_t>(totalUsage_) : 0) +
+                                   " -> " + formatStorageSize(static_cast<uint64_t>(total)));
+    }
+    taskUsage_.swap(tasks);
+    sharedUsage_ = shared;
+    totalUsage_ = total;
+    usageKnown_ = true;
+    usageVersion_++;
 }
 
 std::string StorageManager::formatStorageSize(uint64_t bytes) {
@@ -0,0 +1,332 @@
+#include "task_catalog.h"
+#include "logger.h"
+#include "storage_manager.h"
+#include "nlohmann/json.hpp"
+#include <fstream>
+#include <dirent.h>
+
+#ifdef _WIN32
+    #define platform_stat _stat
+    #define platform_stat_struct struct _stat
+#else
+    #include <sys/stat.h>
+    #define platform_stat stat
+    #define platform_stat_struct struct stat
+#endif
+
+using json = nlohmann::json;
+
+// 目录文件的最短写入间隔（毫秒）：翻译过程中进度频繁变化，合并为每个间隔写入一次
+static const int CATALOG_PERSIST_INTERVAL_MS = 2000;
+
+static bool statFileVersion(const std::string& path, int64_t& mtime, int64_t& size) {
+    platform_stat_struct st;
+    if (platform_stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    mtime = static_cast<int64_t>(st.st_mtime) * 1000000000LL;
+#else
+    mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    size = static_cast<int64_t>(st.st_size);
+    return true;
+}
+
+TaskCatalog::TaskCatalog(const std::string& dataDir)
+    : dataDir_(dataDir), path_(dataDir + "/.catalog.json"), dirty_(false), persistedUsageVersion_(0) {
+}
+
+std::string TaskCatalog::configPath(const std::string& taskId) const {
+    return dataDir_ + "/" + taskId + "/config.json";
+}
+
+void TaskCatalog::insertEntry(const std::string& taskId, Entry entry) {
+    // 调用者需要持有 mutex_
+    eraseEntry(taskId);
+    CreatedKey key(entry.info.createdAt, taskId);
+    byCreatedAt_.insert(key);
+    if (!entry.info.deleted) {
+        byStatus_[entry.info.status].insert(key);
+    }
+    entries_[taskId] = std::move(entry);
+}
+
+void TaskCatalog::eraseEntry(const std::string& taskId) {
+    // 调用者需要持有 mutex_
+    auto it = entries_.find(taskId);
+    if (it == entries_.end()) {
+        return;
+    }
+    CreatedKey key(it->second.info.createdAt, taskId);
+    byCreatedAt_.erase(key);
+    auto status = byStatus_.find(it->second.info.status);
+    if (status != byStatus_.end()) {
+        status->second.erase(key);
+    }
+    entries_.erase(it);
+}
+
+bool TaskCatalog::readFile(json& usage) {
+    // 调用者需要持有 mutex_
+    std::ifstream file(path_);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    try {
+        json j;
+        file >> j;
+        for (const auto& item : j.at("tasks")) {
+            Entry entry;
+            entry.info.taskId = item.value("taskId", "");
+            entry.info.taskName = item.value("taskName", "");
+            entry.info.fileName = item.value("fileName", "");
+            entry.info.modelName = item.value("modelName", "");
+            entry.info.modelCount = item.value("modelCount", 1);
+            entry.info.status = static_cast<TaskStatus>(item.value("status", 0));
+            entry.info.totalCount = item.value("totalCount", 0);
+            entry.info.completedCount = item.value("completedCount", 0);
+            entry.info.failedCount = item.value("failedCount", 0);
+            entry.info.createdAt = item.value("createdAt", "");
+            entry.info.updatedAt = item.value("updatedAt", "");
+            entry.info.deleted = item.value("deleted", false);
+            entry.configMtime = item.value("configMtime", static_cast<int64_t>(-1));
+            entry.configSize = item.value("configSize", static_cast<int64_t>(-1));
+            if (!entry.info.taskId.empty()) {
+                std::string taskId = entry.info.taskId;
+                insertEntry(taskId, std::move(entry));
+            }
+        }
+        if (j.contains("usage")) {
+            usage = j["usage"];
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().warning("Failed to read task catalog, rebuilding: " + std::string(e.what()));
+        entries_.clear();
+        byCreatedAt_.clear();
+        byStatus_.clear();
+        usage = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void TaskCatalog::load(const std::function<TaskInfo(const std::string&)>& loadInfo) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    byCreatedAt_.clear();
+    byStatus_.clear();
+    json usage;
+    readFile(usage);
+    
+    // 与任务目录核对：只比较 config.json 的修改时间与大小，变化时才重新读取
+    std::set<std::string> present;
+    int reloaded = 0;
+    DIR* dir = opendir(dataDir_.c_str());
+    if (dir) {
+        struct dirent* dateEntry;
+        while ((dateEntry = readdir(dir)) != nullptr) {
+            if (dateEntry->d_name[0] == '.') continue;
+            
+            std::string datePath = dataDir_ + "/" + dateEntry->d_name;
+            DIR* dateDir = opendir(datePath.c_str());
+            if (!dateDir) continue;
+            
+            struct dirent* taskEntry;
+            while ((taskEntry = readdir(dateDir)) != nullptr) {
+                if (taskEntry->d_name[0] == '.') continue;
+                
+                std::string taskId = std::string(dateEntry->d_name) + "/" + taskEntry->d_name;
+                int64_t mtime = 0;
+                int64_t size = 0;
+                if (!statFileVersion(configPath(taskId), mtime, size)) {
+                    continue;
+                }
+                present.insert(taskId);
+                
+                auto it = entries_.find(taskId);
+                if (it != entries_.end() && it->second.configMtime == mtime && it->second.configSize == size) {
+                    continue;
+                }
+                
+                Entry entry;
+                entry.info = loadInfo(taskId);
+                if (entry.info.taskId.empty()) {
+                    eraseEntry(taskId);
+                    continue;
+                }
+                entry.configMtime = mtime;
+                entry.configSize = size;
+                insertEntry(taskId, std::move(entry));
+                reloaded++;
+            }
+            closedir(dateDir);
+        }
+        closedir(dir);
+    }
+    
+    int removed = 0;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (present.count(it->first)) {
+            ++it;
+            continue;
+        }
+        std::string taskId = it->first;
+        ++it;
+        eraseEntry(taskId);
+        removed++;
+    }
+    
+    dirty_ = reloaded > 0 || removed > 0;
+    
+    // 恢复存储用量计数：任务在目录文件写入后有变化（通常是上次未正常退出）时计数可能已过时，
+    // 由调度线程尽快重新扫描；没有保存的计数时首次查询或调度线程扫描建立
+    if (usage.is_object()) {
+        try {
+            // 计数在写入目录文件之前取得，按目录文件的实际大小修正
+            int64_t mtime = 0;
+            int64_t catalogBytes = 0;
+            statFileVersion(path_, mtime, catalogBytes);
+            StorageManager::StorageUsageSnapshot snapshot;
+            snapshot.shared = usage.value("shared", static_cast<int64_t>(0)) +
+                              catalogBytes - usage.value("catalogBytes", catalogBytes);
+            for (const auto& item : usage.at("tasks").items()) {
+                snapshot.tasks[item.key()] = item.value().get<int64_t>();
+            }
+            StorageManager::getInstance().restoreUsage(snapshot, dirty_);
+        } catch (const std::exception& e) {
+            Logger::getInstance().warning("Failed to restore storage usage: " + std::string(e.what()));
+        }
+    }
+    Logger::getInstance().info("Task catalog loaded: " + std::to_string(entries_.size()) + " tasks (" +
+                               std::to_string(reloaded) + " reloaded, " + std::to_string(removed) + " removed)");
+}
+
+void TaskCatalog::update(const TaskInfo& info) {
+    if (info.taskId.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry entry;
+    entry.info = info;
+    insertEntry(info.taskId, std::move(entry));
+    changed_.insert(info.taskId);
+    dirty_ = true;
+}
+
+void TaskCatalog::remove(const std::string& taskId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    eraseEntry(taskId);
+    changed_.erase(taskId);
+    dirty_ = true;
+}
+
+std::vector<TaskInfo> TaskCatalog::list(bool includeDeleted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<TaskInfo> tasks;
+    tasks.reserve(entries_.size());
+    for (auto it = byCreatedAt_.rbegin(); it != byCreatedAt_.rend(); ++it) {
+        const TaskInfo& info = entries_[it->second].info;
+        if (includeDeleted || !info.deleted) {
+            tasks.push_back(info);
+        }
+    }
+    return tasks;
+}
+
+std::vector<TaskInfo> TaskCatalog::listByStatus(TaskStatus status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<TaskInfo> tasks;
+    auto it = byStatus_.find(status);
+    if (it == byStatus_.end()) {
+        return tasks;
+    }
+    tasks.reserve(it->second.size());
+    for (const auto& key : it->second) {
+        tasks.push_back(entries_[key.second].info);
+    }
+    return tasks;
+}
+
+void TaskCatalog::persist(bool force) {
+    // 同一时间只有一个线程写入目录文件；写入文件时不持有 mutex_，不阻塞查询与更新
+    std::lock_guard<std::mutex> persistLock(persistMutex_);
+    auto now = std::chrono::steady_clock::now();
+    StorageManager& storage = StorageManager::getInstance();
+    uint64_t usageVersion = storage.getUsageVersion();
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    if ((!dirty_ && usageVersion == persistedUsageVersion_) ||
+        (!force && now - persistedAt_ < std::chrono::milliseconds(CATALOG_PERSIST_INTERVAL_MS))) {
+        return;
+    }
+    
+    // 修改过的任务重新记录 config.json 的版本（config.json 总是先于目录更新写入）
+    for (const auto& taskId : changed_) {
+        auto it = entries_.find(taskId);
+        if (it != entries_.end() &&
+            !statFileVersion(configPath(taskId), it->second.configMtime, it->second.configSize)) {
+            it->second.configMtime = it->second.configSize = -1;
+        }
+    }
+    
+    json tasks = json::array();
+    for (const auto& key : byCreatedAt_) {
+        const Entry& entry = entries_[key.second];
+        json item;
+        item["taskId"] = entry.info.taskId;
+        item["taskName"] = entry.info.taskName;
+        item["fileName"] = entry.info.fileName;
+        item["modelName"] = entry.info.modelName;
+        item["modelCount"] = entry.info.modelCount;
+        item["status"] = static_cast<int>(entry.info.status);
+        item["totalCount"] = entry.info.totalCount;
+        item["completedCount"] = entry.info.completedCount;
+        item["failedCount"] = entry.info.failedCount;
+        item["createdAt"] = entry.info.createdAt;
+        item["updatedAt"] = entry.info.updatedAt;
+        item["deleted"] = entry.info.deleted;
+        item["configMtime"] = entry.configMtime;
+        item["configSize"] = entry.configSize;
+        tasks.push_back(item);
+    }
+    json j;
+    j["version"] = 1;
+    j["tasks"] = tasks;
+    
+    // 本次写入包含的修改；写入失败时放回，写入期间的新修改留待下次写入
+    std::set<std::string> persisted;
+    persisted.swap(changed_);
+    bool wasDirty = dirty_;
+    dirty_ = false;
+    lock.unlock();
+    
+    StorageManager::StorageUsageSnapshot snapshot;
+    if (storage.getUsageSnapshot(snapshot)) {
+        json usageTasks = json::object();
+        for (const auto& pair : snapshot.tasks) {
+            usageTasks[pair.first] = pair.second;
+        }
+        int64_t mtime = 0;
+        int64_t catalogBytes = 0;
+        statFileVersion(path_, mtime, catalogBytes);
+        j["usage"] = {{"shared", snapshot.shared}, {"catalogBytes", catalogBytes}, {"tasks", usageTasks}};
+    }
+    
+    // 原子替换，中途中断时保留旧的目录文件
+    bool written = storage.writeFileAtomic(path_, j.dump());
+    
+    if (!written) {
+        Logger::getInstance().error("Failed to write task catalog: " + path_);
+        lock.lock();
+        changed_.insert(persisted.begin(), persisted.end());
+        dirty_ = dirty_ || wasDirty;
+        return;
+    }
+    
+    lock.lock();
+    persistedAt_ = now;
+    // 写入目录文件本身也改变用量，记录写入后的版本，避免仅因此再次写入
+    persistedUsageVersion_ = storage.getUsageVersion();
+}
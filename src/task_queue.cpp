@@ -1,6 +1,7 @@
 #include "task_queue.h"
 #include "logger.h"
 #include "html_parser.h"
+#include "translation_engine.h"
 #include <chrono>
 #include <iomanip>
 #include <sstream>
@@ -9,13 +10,23 @@
 #include <future>
 #include <atomic>
 #include <queue>
+#include <memory>
+#include <condition_variable>
+#include <functional>
 
 TaskQueue& TaskQueue::getInstance() {
     static TaskQueue instance;
     return instance;
 }
 
-TaskQueue::TaskQueue() : running_(false) {
+TaskQueue::TaskQueue() : running_(false), catalog_("data") {
+    StorageManager::getInstance().setTaskConfigListener([this](const TaskConfig& config) {
+        catalog_.update(makeTaskInfo(config));
+        notifyTaskListeners(config);
+    });
+    StorageManager::getInstance().setTaskRemovedListener([this](const std::string& taskId) {
+        catalog_.remove(taskId);
+    });
 }
 
 TaskQueue::~TaskQueue() {
@@ -24,6 +35,7 @@ TaskQueue::~TaskQueue() {
 
 void TaskQueue::start() {
     if (!running_.load()) {
+        catalog_.load([this](const std::string& taskId) { return getTaskInfo(taskId); });
         running_.store(true);
         schedulerThread_ = std::thread(&TaskQueue::schedulerLoop, this);
         Logger::getInstance().info("TaskQueue started");
@@ -51,6 +63,8 @@ void TaskQueue::stop() {
             taskThreads_.clear();
         }
         
+        catalog_.persist(true);
+        
         Logger::getInstance().info("TaskQueue stopped");
     }
 }
@@ -70,8 +84,9 @@ std::string TaskQueue::createTask(const std::string& fileName,
             return "";
         }
         
-        // 保存原始HTML
-        if (!StorageManager::getInstance().saveOriginalHtml(taskId, htmlContent)) {
+        // 保存原始HTML（内容相同的文件只保存一份）
+        std::string sourceHash = StorageManager::getInstance().storeSourceBlob(htmlContent);
+        if (sourceHash.empty()) {
             Logger::getInstance().error("Failed to save original HTML");
             return "";
         }
@@ -80,6 +95,7 @@ std::string TaskQueue::createTask(const std::string& fileName,
         TaskConfig taskConfig = config;
         taskConfig.taskId = taskId;
         taskConfig.fileName = fileName;
+        taskConfig.sourceHash = sourceHash;
         taskConfig.status = "parsing";
         
         auto now = std::chrono::system_clock::now();
@@ -93,11 +109,13 @@ std::string TaskQueue::createTask(const std::string& fileName,
         // 保存配置
         if (!StorageManager::getInstance().saveTaskConfig(taskConfig)) {
             Logger::getInstance().error("Failed to save task config");
+            StorageManager::getInstance().releaseSourceBlob(sourceHash);
             return "";
         }
         
         // 解析并保存任务
-        parseAndSaveTask(taskId, htmlContent);
+        auto files = parseSources(sourceHash, [&]() { return std::vector<std::string>{htmlContent}; });
+        parseAndSaveTask(taskId, files.empty() ? std::vector<Literature>() : files[0]);
         
         // 通知工作线程
         cv_.notify_one();
@@ -112,106 +130,95 @@ std::string TaskQueue::createTask(const std::string& fileName,
 }
 
 std::vector<TaskInfo> TaskQueue::listTasks(bool includeDeleted) {
-    std::vector<TaskInfo> tasks;
+    // 按创建时间排序（最新的在前，用于显示）
+    return catalog_.list(includeDeleted);
+}
+
+TaskInfo TaskQueue::getTaskInfo(const std::string& taskId) {
+    try {
+        return makeTaskInfo(StorageManager::getInstance().loadTaskConfig(taskId));
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Failed to get task info: " + std::string(e.what()));
+    }
+    
+    return TaskInfo();
+}
+
+int TaskQueue::addTaskListener(std::function<void(const TaskInfo&)> listener) {
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    int listenerId = nextListenerId_++;
+    taskListeners_[listenerId] = std::move(listener);
+    return listenerId;
+}
+
+void TaskQueue::removeTaskListener(int listenerId) {
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    taskListeners_.erase(listenerId);
+}
+
+void TaskQueue::notifyTaskListeners(const TaskConfig& config) {
+    // 回调期间持有锁，保证取消订阅返回后订阅者可以安全销毁
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    if (taskListeners_.empty()) {
+        return;
+    }
     
     try {
-        // 遍历data目录
-        DIR* dir = opendir("data");
-        if (!dir) {
-            return tasks;
+        TaskInfo info = makeTaskInfo(config);
+        for (const auto& pair : taskListeners_) {
+            pair.second(info);
         }
-        
-        struct dirent* dateEntry;
-        while ((dateEntry = readdir(dir)) != nullptr) {
-            if (dateEntry->d_name[0] == '.') continue;
-            
-            std::string datePath = std::string("data/") + dateEntry->d_name;
-            DIR* dateDir = opendir(datePath.c_str());
-            if (!dateDir) continue;
-            
-            struct dirent* taskEntry;
-            while ((taskEntry = readdir(dateDir)) != nullptr) {
-                if (taskEntry->d_name[0] == '.') continue;
-                
-                std::string taskId = std::string(dateEntry->d_name) + "/" + taskEntry->d_name;
-                TaskInfo info = getTaskInfo(taskId);
-                if (!info.taskId.empty()) {
-                    // 根据includeDeleted参数决定是否包含已删除的任务
-                    if (includeDeleted || !info.deleted) {
-                        tasks.push_back(info);
-                    }
-                }
-            }
-            closedir(dateDir);
-        }
-        closedir(dir);
-        
-        // 按创建时间排序（最新的在前，用于显示）
-        std::sort(tasks.begin(), tasks.end(), 
-            [](const TaskInfo& a, const TaskInfo& b) {
-                return a.createdAt > b.createdAt;
-            });
-        
     } catch (const std::exception& e) {
-        Logger::getInstance().error("Failed to list tasks: " + std::string(e.what()));
+        Logger::getInstance().error("Failed to notify task change: " + std::string(e.what()));
     }
-    
-    return tasks;
 }
 
-TaskInfo TaskQueue::getTaskInfo(const std::string& taskId) {
+TaskInfo TaskQueue::makeTaskInfo(const TaskConfig& config) {
     TaskInfo info;
     
-    try {
-        TaskConfig config = StorageManager::getInstance().loadTaskConfig(taskId);
-        
-        info.taskId = config.taskId;
-        info.taskName = config.taskName;
-        info.fileName = config.fileName;
-        info.totalCount = config.totalCount;
-        info.completedCount = config.completedCount;
-        info.failedCount = config.failedCount;
-        info.createdAt = config.createdAt;
-        info.updatedAt = config.updatedAt;
-        info.deleted = config.deleted;
-        
-        // 获取模型名称
-        if (!config.modelConfigs.empty()) {
-            // 多模型任务
-            info.modelCount = config.modelConfigs.size();
-            if (config.modelConfigs.size() == 1) {
-                info.modelName = config.modelConfigs[0].model.name;
-            } else {
-                info.modelName = std::to_string(config.modelConfigs.size()) + "个模型";
-            }
-        } else if (!config.modelConfig.modelId.empty()) {
-            // 兼容旧的单模型任务
-            info.modelCount = 1;
-            ModelConfig savedModel = ConfigManager::getInstance().getModelConfig(config.modelConfig.modelId);
-            if (!savedModel.name.empty()) {
-                info.modelName = savedModel.name;
-            } else {
-                info.modelName = config.modelConfig.modelId;
-            }
+    info.taskId = config.taskId;
+    info.taskName = config.taskName;
+    info.fileName = config.fileName;
+    info.totalCount = config.totalCount;
+    info.completedCount = config.completedCount;
+    info.failedCount = config.failedCount;
+    info.createdAt = config.createdAt;
+    info.updatedAt = config.updatedAt;
+    info.deleted = config.deleted;
+        
+    // 获取模型名称
+    if (!config.modelConfigs.empty()) {
+        // 多模型任务
+        info.modelCount = config.modelConfigs.size();
+        if (config.modelConfigs.size() == 1) {
+            info.modelName = config.modelConfigs[0].model.name;
+        } else {
+            info.modelName = std::to_string(config.modelConfigs.size()) + "个模型";
         }
-        
-        // 转换状态
-        if (config.status == "parsing") {
-            info.status = TaskStatus::Parsing;
-        } else if (config.status == "pending") {
-            info.status = TaskStatus::Pending;
-        } else if (config.status == "running") {
-            info.status = TaskStatus::Running;
-        } else if (config.status == "paused") {
-            info.status = TaskStatus::Paused;
-        } else if (config.status == "completed") {
-            info.status = TaskStatus::Completed;
-        } else if (config.status == "failed") {
-            info.status = TaskStatus::Failed;
+    } else if (!config.modelConfig.modelId.empty()) {
+        // 兼容旧的单模型任务
+        info.modelCount = 1;
+        ModelConfig savedModel = ConfigManager::getInstance().getModelConfig(config.modelConfig.modelId);
+        if (!savedModel.name.empty()) {
+            info.modelName = savedModel.name;
+        } else {
+            info.modelName = config.modelConfig.modelId;
         }
+    }
         
-    } catch (const std::exception& e) {
-        Logger::getInstance().error("Failed to get task info: " + std::string(e.what()));
+    // 转换状态
+    if (config.status == "parsing") {
+        info.status = TaskStatus::Parsing;
+    } else if (config.status == "pending") {
+        info.status = TaskStatus::Pending;
+    } else if (config.status == "running") {
+        info.status = TaskStatus::Running;
+    } else if (config.status == "paused") {
+        info.status = TaskStatus::Paused;
+    } else if (config.status == "completed") {
+        info.status = TaskStatus::Completed;
+    } else if (config.status == "failed") {
+        info.status = TaskStatus::Failed;
     }
     
     return info;
@@ -221,13 +228,7 @@ std::vector<LiteratureData> TaskQueue::getTaskLiteratures(const std::string& tas
     std::vector<LiteratureData> literatures;
     
     try {
-        std::vector<int> indices = StorageManager::getInstance().loadIndexJson(taskId);
-        
-        for (int index : indices) {
-            LiteratureData data = StorageManager::getInstance().loadLiteratureData(taskId, index);
-            literatures.push_back(data);
-        }
-        
+        literatures = StorageManager::getInstance().loadAllLiteratureData(taskId);
     } catch (const std::exception& e) {
         Logger::getInstance().error("Failed to get task literatures: " + std::string(e.what()));
     }
@@ -345,63 +346,59 @@ void TaskQueue::schedulerLoop() {
             if (currentRunning < maxConcurrent) {
                 std::unique_lock<std::mutex> lock(mutex_);
                 
-                // 查找待处理的任务
-                std::vector<TaskInfo> tasks = listTasks(false);
-                
-                // 按创建时间升序排序（FIFO - 先进先出，最早创建的优先调度）
-                std::sort(tasks.begin(), tasks.end(), 
-                    [](const TaskInfo& a, const TaskInfo& b) {
-                        return a.createdAt < b.createdAt;
-                    });
+                // 查找待处理的任务，按创建时间升序（FIFO - 先进先出，最早创建的优先调度）
+                std::vector<TaskInfo> tasks = catalog_.listByStatus(TaskStatus::Pending);
                 
                 for (const auto& taskInfo : tasks) {
-                    if (taskInfo.status == TaskStatus::Pending) {
-                        // 检查是否已经在调度中
-                        {
-                            std::lock_guard<std::mutex> slock(scheduledMutex_);
-                            if (scheduledTasks_.find(taskInfo.taskId) != scheduledTasks_.end()) {
-                                continue;  // 已经在调度中，跳过
-                            }
-                        }
-                        
-                        // 获取任务配置以检查模型
-                        TaskConfig config = StorageManager::getInstance().loadTaskConfig(taskInfo.taskId);
-                        std::string modelId = config.modelConfig.modelId;
-                        
-                        // 检查是否可以启动该任务（模型并发限制）
-                        if (!canStartTask(modelId)) {
-                            continue;  // 该模型已达到并发限制，跳过
-                        }
-                        
-                        // 检查总并发数
-                        if (getTotalRunningTasks() >= maxConcurrent) {
-                            break;  // 已达到最大并发数
-                        }
-                        
-                        std::string taskId = taskInfo.taskId;
-                        
-                        // 标记为已调度
-                        {
-                            std::lock_guard<std::mutex> slock(scheduledMutex_);
-                            scheduledTasks_.insert(taskId);
-                        }
-                        
-                        // 记录任务启动
-                        onTaskStarted(taskId, modelId);
-                        
-                        // 在独立线程中执行任务
-                        {
-                            std::lock_guard<std::mutex> tlock(taskThreadsMutex_);
-                            taskThreads_[taskId] = std::thread(&TaskQueue::executeTask, this, taskId, modelId);
+                    // 检查是否已经在调度中
+                    {
+                        std::lock_guard<std::mutex> slock(scheduledMutex_);
+                        if (scheduledTasks_.find(taskInfo.taskId) != scheduledTasks_.end()) {
+                            continue;  // 已经在调度中，跳过
                         }
-                        
-                        Logger::getInstance().info("Scheduled task: " + taskId + " (model: " + modelId + 
-                                                   ", running: " + std::to_string(getTotalRunningTasks()) + "/" + 
-                                                   std::to_string(maxConcurrent) + ")");
                     }
+                    
+                    // 获取任务配置以检查模型
+                    TaskConfig config = StorageManager::getInstance().loadTaskConfig(taskInfo.taskId);
+                    std::string modelId = config.modelConfig.modelId;
+                    
+                    // 检查是否可以启动该任务（模型并发限制）
+                    if (!canStartTask(modelId)) {
+                        continue;  // 该模型已达到并发限制，跳过
+                    }
+                    
+                    // 检查总并发数
+                    if (getTotalRunningTasks() >= maxConcurrent) {
+                        break;  // 已达到最大并发数
+                    }
+                    
+                    std::string taskId = taskInfo.taskId;
+                    
+                    // 标记为已调度
+                    {
+                        std::lock_guard<std::mutex> slock(scheduledMutex_);
+                        scheduledTasks_.insert(taskId);
+                    }
+                    
+                    // 记录任务启动
+                    onTaskStarted(taskId, modelId);
+                    
+                    // 在独立线程中执行任务
+                    {
+                        std::lock_guard<std::mutex> tlock(taskThreadsMutex_);
+                        taskThreads_[taskId] = std::thread(&TaskQueue::executeTask, this, taskId, modelId);
+                    }
+                    
+                    Logger::getInstance().info("Scheduled task: " + taskId + " (model: " + modelId + 
+                                               ", running: " + std::to_string(getTotalRunningTasks()) + "/" + 
+                                               std::to_string(maxConcurrent) + ")");
                 }
             }
             
+            StorageManager::getInstance().reconcileStorageUsage();
+            StorageManager::getInstance().cleanupStaleUploads();
+            catalog_.persist();
+            
             // 短暂等待后继续检查
             std::this_thread::sleep_for(std::chrono::milliseconds(500));
             
@@ -453,7 +450,29 @@ void TaskQueue::executeTask(const std::string& taskId, const std::string& modelI
     Logger::getInstance().info("Task thread finished: " + taskId);
 }
 
-void TaskQueue::parseAndSaveTask(const std::string& taskId, const std::string& htmlContent) {
+std::vector<std::vector<Literature>> TaskQueue::parseSources(
+    const std::string& sourceHash, const std::function<std::vector<std::string>()>& loadContents) {
+    std::vector<std::vector<Literature>> files;
+    if (StorageManager::getInstance().loadParseCache(sourceHash, files)) {
+        Logger::getInstance().info("Using cached parse result: " + sourceHash);
+        return files;
+    }
+    
+    HTMLParser parser;
+    size_t total = 0;
+    for (const auto& content : loadContents()) {
+        files.push_back(parser.parse(content));
+        total += files.back().size();
+    }
+    
+    // 没有解析出文献时不缓存
+    if (total > 0 && !sourceHash.empty()) {
+        StorageManager::getInstance().saveParseCache(sourceHash, files);
+    }
+    return files;
+}
+
+void TaskQueue::parseAndSaveTask(const std::string& taskId, const std::vector<Literature>& literatures) {
     try {
         Logger::getInstance().info("Parsing task: " + taskId);
         
@@ -461,10 +480,6 @@ void TaskQueue::parseAndSaveTask(const std::string& taskId, const std::string& h
         TaskConfig taskConfig = StorageManager::getInstance().loadTaskConfig(taskId);
         std::string fileName = taskConfig.fileName;
         
-        // 解析HTML
-        HTMLParser parser;
-        std::vector<Literature> literatures = parser.parse(htmlContent);
-        
         if (literatures.empty()) {
             Logger::getInstance().error("No literatures found in HTML");
             
@@ -474,8 +489,10 @@ void TaskQueue::parseAndSaveTask(const std::string& taskId, const std::string& h
             return;
         }
         
-        // 保存文献数据
+        // 保存文献数据（一次批量写入）
         std::vector<int> indices;
+        std::vector<LiteratureData> records;
+        records.reserve(literatures.size());
         for (size_t i = 0; i < literatures.size(); i++) {
             const auto& lit = literatures[i];
             
@@ -501,9 +518,10 @@ void TaskQueue::parseAndSaveTask(const std::string& taskId, const std::string& h
             data.eissn = lit.eissn;
             data.status = "pending";
             
-            StorageManager::getInstance().saveLiteratureData(taskId, data.index, data);
             indices.push_back(data.index);
+            records.push_back(std::move(data));
         }
+        StorageManager::getInstance().saveLiteratureBatch(taskId, records);
         
         // 保存索引
         StorageManager::getInstance().saveIndexJson(taskId, indices);
@@ -535,6 +553,135 @@ void TaskQueue::parseAndSaveTask(const std::string& taskId, const std::string& h
     }
 }
 
+// 一组待翻译的文献（批量翻译时一组多篇，否则一篇）
+struct LiteratureGroupJob {
+    size_t model = 0;        // 负责翻译的模型（多模型任务中 modelConfigs 的下标）
+    std::vector<LiteratureData> group;
+    std::vector<bool> success;
+};
+
+// 通过 TranslationEngine 翻译一组文献，全部完成后在引擎线程中调用 finish。
+// 标题与摘要的请求同时发送：开启合并翻译时同时需要两者的文献只发送一个请求，
+// 其余的标题、摘要各自批量翻译。失败时 success[i] 为 false，errorMessage 记录原因（标题优先）
+static void translateLiteratureGroupAsync(const std::shared_ptr<LiteratureGroupJob>& job, const ModelConfig& model,
+                                          bool translateTitle, bool translateAbstract, bool combined,
+                                          std::function<void()> finish) {
+    size_t count = job->group.size();
+    job->success.assign(count, true);
+    
+    // 各部分请求的结果（按文献下标），最后一个部分完成时汇总
+    struct Parts {
+        std::vector<bool> needTitle;
+        std::vector<bool> needAbstract;
+        std::vector<TranslationResult> titles;
+        std::vector<TranslationResult> abstracts;
+        std::atomic<int> pending;
+    };
+    auto parts = std::make_shared<Parts>();
+    parts->titles.resize(count);
+    parts->abstracts.resize(count);
+    parts->pending.store(1);
+    for (const auto& data : job->group) {
+        parts->needTitle.push_back(translateTitle && !data.originalTitle.empty());
+        parts->needAbstract.push_back(translateAbstract && !data.originalAbstract.empty());
+    }
+    
+    auto complete = [job, parts, finish]() {
+        if (parts->pending.fetch_sub(1) != 1) {
+            return;
+        }
+        for (size_t i = 0; i < job->group.size(); i++) {
+            LiteratureData& data = job->group[i];
+            if (parts->needTitle[i]) {
+                if (parts->titles[i].success) {
+                    data.translatedTitle = parts->titles[i].translatedText;
+                } else {
+                    job->success[i] = false;
+                    data.errorMessage = "Title translation failed: " + parts->titles[i].errorMessage;
+                }
+            }
+            if (parts->needAbstract[i]) {
+                if (parts->abstracts[i].success) {
+                    data.translatedAbstract = parts->abstracts[i].translatedText;
+                } else if (job->success[i]) {
+                    job->success[i] = false;
+                    data.errorMessage = "Abstract translation failed: " + parts->abstracts[i].errorMessage;
+                }
+            }
+        }
+        finish();
+    };
+    
+    std::vector<size_t> combinedMembers;
+    std::vector<size_t> titleMembers;
+    std::vector<size_t> abstractMembers;
+    for (size_t i = 0; i < count; i++) {
+        if (combined && parts->needTitle[i] && parts->needAbstract[i]) {
+            combinedMembers.push_back(i);
+            continue;
+        }
+        if (parts->needTitle[i]) {
+            titleMembers.push_back(i);
+        }
+        if (parts->needAbstract[i]) {
+            abstractMembers.push_back(i);
+        }
+    }
+    
+    TranslationEngine& engine = TranslationEngine::getInstance();
+    if (!combinedMembers.empty()) {
+        std::vector<std::string> titles;
+        std::vector<std::string> abstracts;
+        for (size_t i : combinedMembers) {
+            titles.push_back(job->group[i].originalTitle);
+            abstracts.push_back(job->group[i].originalAbstract);
+        }
+        parts->pending.fetch_add(1);
+        engine.submitCombined(model, titles, abstracts,
+            [parts, combinedMembers, complete](const std::vector<TranslationResult>& titleResults,
+                                               const std::vector<TranslationResult>& abstractResults) {
+                for (size_t k = 0; k < combinedMembers.size(); k++) {
+                    parts->titles[combinedMembers[k]] = titleResults[k];
+                    parts->abstracts[combinedMembers[k]] = abstractResults[k];
+                }
+                complete();
+            });
+    }
+    for (bool title : {true, false}) {
+        const std::vector<size_t>& members = title ? titleMembers : abstractMembers;
+        if (members.empty()) {
+            continue;
+        }
+        std::vector<std::string> texts;
+        for (size_t i : members) {
+            texts.push_back(title ? job->group[i].originalTitle : job->group[i].originalAbstract);
+        }
+        parts->pending.fetch_add(1);
+        engine.submitBatch(model, texts, title ? "标题" : "摘要",
+            [parts, members, title, complete](const std::vector<TranslationResult>& results) {
+                for (size_t k = 0; k < members.size(); k++) {
+                    (title ? parts->titles : parts->abstracts)[members[k]] = results[k];
+                }
+                complete();
+            });
+    }
+    complete();
+}
+
+// 同步翻译一组文献（逐篇翻译与多线程翻译使用），返回前等待全部请求完成
+static void translateLiteratureGroup(const ModelConfig& model, const TaskConfig& config, bool combined,
+                                     std::vector<LiteratureData>& group, std::vector<bool>& success) {
+    auto job = std::make_shared<LiteratureGroupJob>();
+    job->group = std::move(group);
+    auto done = std::make_shared<std::promise<void>>();
+    std::future<void> finished = done->get_future();
+    translateLiteratureGroupAsync(job, model, config.translateTitle, config.translateAbstract, combined,
+                                  [done]() { done->set_value(); });
+    finished.wait();
+    group = std::move(job->group);
+    success = job->success;
+}
+
 void TaskQueue::translateTask(const std::string& taskId) {
     try {
         Logger::getInstance().info("Translating task: " + taskId);
@@ -544,17 +691,16 @@ void TaskQueue::translateTask(const std::string& taskId) {
         config.status = "running";
         StorageManager::getInstance().saveTaskConfig(config);
         
-        // 创建翻译器
-        Translator translator(config.modelConfig);
-        
         // 加载文献索引
         std::vector<int> indices = StorageManager::getInstance().loadIndexJson(taskId);
         
         int consecutiveFailures = 0;
-        int maxConsecutiveFailures = ConfigManager::getInstance().loadSystemConfig().consecutiveFailureThreshold;
+        SystemConfig sysConfig = ConfigManager::getInstance().loadSystemConfig();
+        int maxConsecutiveFailures = sysConfig.consecutiveFailureThreshold;
+        size_t groupSize = static_cast<size_t>(std::max(1, sysConfig.translationBatchSize));
         
-        // 翻译每篇文献
-        for (int index : indices) {
+        // 翻译每篇文献（批量翻译时每次取出一组，请求由 TranslationEngine 发送）
+        for (size_t pos = 0; pos < indices.size();) {
             // 检查是否被暂停
             TaskConfig currentConfig = StorageManager::getInstance().loadTaskConfig(taskId);
             if (currentConfig.status == "paused") {
@@ -562,54 +708,44 @@ void TaskQueue::translateTask(const std::string& taskId) {
                 return;
             }
             
-            LiteratureData data = StorageManager::getInstance().loadLiteratureData(taskId, index);
+            std::vector<LiteratureData> group;
+            while (pos < indices.size() && group.size() < groupSize) {
+                int index = indices[pos++];
+                LiteratureData data = StorageManager::getInstance().loadLiteratureData(taskId, index);
             
-            // 跳过已完成的文献
-            if (data.status == "completed") {
+                // 跳过已完成的文献
+                if (data.status == "completed") {
+                    continue;
+                }
+                
+                data.status = "translating";
+                StorageManager::getInstance().updateLiteratureStatus(taskId, index, data);
+                group.push_back(data);
+            }
+            if (group.empty()) {
                 continue;
             }
             
-            data.status = "translating";
-            StorageManager::getInstance().saveLiteratureData(taskId, index, data);
-            
-            bool success = true;
-            
-            // 翻译标题
-            if (config.translateTitle && !data.originalTitle.empty()) {
-                TranslationResult result = translator.translate(data.originalTitle, "标题");
-                if (result.success) {
-                    data.translatedTitle = result.translatedText;
-                } else {
-                    success = false;
-                    data.errorMessage = "Title translation failed: " + result.errorMessage;
-                }
-            }
+            std::vector<bool> success;
+            translateLiteratureGroup(config.modelConfig, config, sysConfig.translationCombined, group, success);
             
-            // 翻译摘要
-            if (success && config.translateAbstract && !data.originalAbstract.empty()) {
-                TranslationResult result = translator.translate(data.originalAbstract, "摘要");
-                if (result.success) {
-                    data.translatedAbstract = result.translatedText;
+            // 更新文献状态
+            for (size_t i = 0; i < group.size(); i++) {
+                LiteratureData& data = group[i];
+                if (success[i]) {
+                    data.status = "completed";
+                    data.errorMessage = "";
+                    config.completedCount++;
+                    consecutiveFailures = 0;
                 } else {
-                    success = false;
-                    data.errorMessage = "Abstract translation failed: " + result.errorMessage;
+                    data.status = "failed";
+                    config.failedCount++;
+                    consecutiveFailures++;
                 }
+                
+                StorageManager::getInstance().updateLiteratureStatus(taskId, data.index, data);
             }
             
-            // 更新文献状态
-            if (success) {
-                data.status = "completed";
-                data.errorMessage = "";
-                config.completedCount++;
-                consecutiveFailures = 0;
-            } else {
-                data.status = "failed";
-                config.failedCount++;
-                consecutiveFailures++;
-            }
-            
-            StorageManager::getInstance().saveLiteratureData(taskId, index, data);
-            
             // 更新任务进度 - 先检查是否被暂停
             TaskConfig latestConfig = StorageManager::getInstance().loadTaskConfig(taskId);
             if (latestConfig.status == "paused") {
@@ -671,7 +807,7 @@ void TaskQueue::rebuildTranslatedHtml(const std::string& taskId) {
         std::string originalHtml = StorageManager::getInstance().loadOriginalHtml(taskId);
         
         // 加载所有文献数据
-        std::vector<int> indices = StorageManager::getInstance().loadIndexJson(taskId);
+        std::vector<LiteratureData> literatures = StorageManager::getInstance().loadAllLiteratureData(taskId);
         
         std::string translatedHtml = originalHtml;
         
@@ -679,9 +815,7 @@ void TaskQueue::rebuildTranslatedHtml(const std::string& taskId) {
         // 完整版应该在原始位置插入翻译
         translatedHtml += "\n\n<!-- Translated Content -->\n";
         
-        for (int index : indices) {
-            LiteratureData data = StorageManager::getInstance().loadLiteratureData(taskId, index);
-            
+        for (const auto& data : literatures) {
             if (data.status == "completed") {
                 translatedHtml += "<hr>\n<h3>文献 " + std::to_string(data.recordNumber) + " 译文</h3>\n";
                 
@@ -769,7 +903,8 @@ std::string TaskQueue::createTaskMultiFile(const std::vector<std::string>& fileN
         }
         
         // 保存合并后的HTML
-        if (!StorageManager::getInstance().saveOriginalHtml(taskId, combinedHtml)) {
+        std::string sourceHash = StorageManager::getInstance().storeSourceBlob(combinedHtml);
+        if (sourceHash.empty()) {
             Logger::getInstance().error("Failed to save original HTML");
             return "";
         }
@@ -779,6 +914,7 @@ std::string TaskQueue::createTaskMultiFile(const std::vector<std::string>& fileN
         taskConfig.taskId = taskId;
         taskConfig.fileName = fileNames.empty() ? "" : fileNames[0];
         taskConfig.fileNames = fileNames;
+        taskConfig.sourceHash = sourceHash;
         taskConfig.status = "parsing";
         
         auto now = std::chrono::system_clock::now();
@@ -792,11 +928,12 @@ std::string TaskQueue::createTaskMultiFile(const std::vector<std::string>& fileN
         // 保存配置
         if (!StorageManager::getInstance().saveTaskConfig(taskConfig)) {
             Logger::getInstance().error("Failed to save task config");
+            StorageManager::getInstance().releaseSourceBlob(sourceHash);
             return "";
         }
         
         // 解析并保存任务（多文件）
-        parseAndSaveTaskMultiFile(taskId, htmlContents);
+        parseAndSaveTaskMultiFile(taskId, parseSources(sourceHash, [&]() { return htmlContents; }));
         
         // 通知工作线程
         cv_.notify_one();
@@ -810,8 +947,93 @@ std::string TaskQueue::createTaskMultiFile(const std::vector<std::string>& fileN
     }
 }
 
+std::string TaskQueue::createTaskFromUploads(const std::vector<std::string>& fileNames,
+                                             const std::vector<std::string>& uploadIds,
+                                             const TaskConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    try {
+        for (const auto& uploadId : uploadIds) {
+            if (!StorageManager::getInstance().hasUpload(uploadId)) {
+                Logger::getInstance().error("Upload not found: " + uploadId);
+                return "";
+            }
+        }
+        
+        // 生成任务ID
+        std::string taskId = generateTaskId();
+        
+        // 创建任务目录
+        if (!StorageManager::getInstance().createTaskDirectory(taskId)) {
+            Logger::getInstance().error("Failed to create task directory");
+            return "";
+        }
+        
+        // 上传文件存为原始HTML（内容相同的文件只保存一份）
+        std::string sourceHash = StorageManager::getInstance().adoptUploads(uploadIds, fileNames);
+        if (sourceHash.empty()) {
+            Logger::getInstance().error("Failed to save original HTML");
+            return "";
+        }
+        
+        // 创建任务配置
+        TaskConfig taskConfig = config;
+        taskConfig.taskId = taskId;
+        taskConfig.fileName = fileNames.empty() ? "" : fileNames[0];
+        if (fileNames.size() > 1) {
+            taskConfig.fileNames = fileNames;
+        }
+        taskConfig.sourceHash = sourceHash;
+        taskConfig.status = "parsing";
+        
+        auto now = std::chrono::system_clock::now();
+        auto time = std::chrono::system_clock::to_time_t(now);
+        std::tm tm = *std::gmtime(&time);
+        std::ostringstream oss;
+        oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
+        taskConfig.createdAt = oss.str();
+        taskConfig.updatedAt = oss.str();
+        
+        // 保存配置
+        if (!StorageManager::getInstance().saveTaskConfig(taskConfig)) {
+            Logger::getInstance().error("Failed to save task config");
+            StorageManager::getInstance().releaseSourceBlob(sourceHash);
+            return "";
+        }
+        
+        // 解析并保存任务：多文件需要分别解析各上传文件，解析结果已缓存时不读取文件
+        auto files = parseSources(sourceHash, [&]() {
+            std::vector<std::string> contents;
+            if (uploadIds.size() > 1) {
+                for (const auto& uploadId : uploadIds) {
+                    contents.push_back(StorageManager::getInstance().loadUpload(uploadId));
+                }
+            } else {
+                contents.push_back(StorageManager::getInstance().loadSourceBlob(sourceHash));
+            }
+            return contents;
+        });
+        if (uploadIds.size() > 1) {
+            parseAndSaveTaskMultiFile(taskId, files);
+            StorageManager::getInstance().removeUploads(uploadIds);
+        } else {
+            parseAndSaveTask(taskId, files.empty() ? std::vector<Literature>() : files[0]);
+        }
+        
+        // 通知工作线程
+        cv_.notify_one();
+        
+        Logger::getInstance().info("Task created from uploads: " + taskId);
+        return taskId;
+    
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Failed to create task from uploads: " + std::string(e.what()));
+        return "";
+    }
+}
+
 void TaskQueue::parseAndSaveTaskMultiFile(const std::string& taskId, 
-                                          const std::vector<std::string>& htmlContents) {
+                                          const std::vector<std::vector<Literature>>& fileLiteratures) {
     try {
         Logger::getInstance().info("Parsing multi-file task: " + taskId);
         
@@ -819,8 +1041,6 @@ void TaskQueue::parseAndSaveTaskMultiFile(const std::string& taskId,
         TaskConfig taskConfig = StorageManager::getInstance().loadTaskConfig(taskId);
         std::vector<std::string> fileNames = taskConfig.fileNames;
         
-        HTMLParser parser;
-        
         // 存储每个文件的文献及其来源信息
         struct LiteratureWithSource {
             Literature lit;
@@ -830,9 +1050,9 @@ void TaskQueue::parseAndSaveTaskMultiFile(const std::string& taskId,
         };
         std::vector<LiteratureWithSource> allLiteratures;
         
-        // 解析所有HTML文件，记录来源信息
-        for (size_t fileIdx = 0; fileIdx < htmlContents.size(); fileIdx++) {
-            std::vector<Literature> literatures = parser.parse(htmlContents[fileIdx]);
+        // 记录各文件文献的来源信息
+        for (size_t fileIdx = 0; fileIdx < fileLiteratures.size(); fileIdx++) {
+            const std::vector<Literature>& literatures = fileLiteratures[fileIdx];
             
             std::string fileName = (fileIdx < fileNames.size()) ? fileNames[fileIdx] : ("file_" + std::to_string(fileIdx + 1));
             
@@ -855,8 +1075,10 @@ void TaskQueue::parseAndSaveTaskMultiFile(const std::string& taskId,
             return;
         }
         
-        // 保存文献数据
+        // 保存文献数据（一次批量写入）
         std::vector<int> indices;
+        std::vector<LiteratureData> records;
+        records.reserve(allLiteratures.size());
         for (size_t i = 0; i < allLiteratures.size(); i++) {
             const auto& lws = allLiteratures[i];
             const auto& lit = lws.lit;
@@ -883,9 +1105,10 @@ void TaskQueue::parseAndSaveTaskMultiFile(const std::string& taskId,
             data.eissn = lit.eissn;
             data.status = "pending";
             
-            StorageManager::getInstance().saveLiteratureData(taskId, data.index, data);
             indices.push_back(data.index);
+            records.push_back(std::move(data));
         }
+        StorageManager::getInstance().saveLiteratureBatch(taskId, records);
         
         // 保存索引
         StorageManager::getInstance().saveIndexJson(taskId, indices);
@@ -927,15 +1150,11 @@ void TaskQueue::translateTaskMultiThread(const std::string& taskId, int numThrea
         config.status = "running";
         StorageManager::getInstance().saveTaskConfig(config);
         
-        // 加载文献索引
-        std::vector<int> indices = StorageManager::getInstance().loadIndexJson(taskId);
-        
         // 过滤出待翻译的文献
         std::vector<int> pendingIndices;
-        for (int index : indices) {
-            LiteratureData data = StorageManager::getInstance().loadLiteratureData(taskId, index);
+        for (const auto& data : StorageManager::getInstance().loadAllLiteratureData(taskId)) {
             if (data.status != "completed") {
-                pendingIndices.push_back(index);
+                pendingIndices.push_back(data.index);
             }
         }
         
@@ -953,16 +1172,13 @@ void TaskQueue::translateTaskMultiThread(const std::string& taskId, int numThrea
         std::atomic<bool> shouldStop(false);
         std::mutex progressMutex;
         
-        int maxConsecutiveFailures = ConfigManager::getInstance().loadSystemConfig().consecutiveFailureThreshold;
+        SystemConfig sysConfig = ConfigManager::getInstance().loadSystemConfig();
+        int maxConsecutiveFailures = sysConfig.consecutiveFailureThreshold;
+        size_t groupSize = static_cast<size_t>(std::max(1, sysConfig.translationBatchSize));
         
         // 创建工作函数
         auto translateWorker = [&](int startIdx, int endIdx) {
-            // 每个线程创建自己的翻译器
-            Translator translator(config.modelConfig);
-            
-            for (int i = startIdx; i < endIdx && !shouldStop.load(); i++) {
-                int index = pendingIndices[i];
-                
+            for (int i = startIdx; i < endIdx && !shouldStop.load();) {
                 // 检查是否被暂停
                 TaskConfig currentConfig = StorageManager::getInstance().loadTaskConfig(taskId);
                 if (currentConfig.status == "paused") {
@@ -970,58 +1186,49 @@ void TaskQueue::translateTaskMultiThread(const std::string& taskId, int numThrea
                     return;
                 }
                 
-                LiteratureData data = StorageManager::getInstance().loadLiteratureData(taskId, index);
-                
-                // 跳过已完成的文献
-                if (data.status == "completed") {
-                    continue;
-                }
-                
-                data.status = "translating";
-                StorageManager::getInstance().saveLiteratureData(taskId, index, data);
+                // 取出下一组文献（批量翻译时一组多篇）
+                std::vector<LiteratureData> group;
+                while (i < endIdx && group.size() < groupSize) {
+                    int index = pendingIndices[i++];
+                    LiteratureData data = StorageManager::getInstance().loadLiteratureData(taskId, index);
                 
-                bool success = true;
-                
-                // 翻译标题
-                if (config.translateTitle && !data.originalTitle.empty()) {
-                    TranslationResult result = translator.translate(data.originalTitle, "标题");
-                    if (result.success) {
-                        data.translatedTitle = result.translatedText;
-                    } else {
-                        success = false;
-                        data.errorMessage = "Title translation failed: " + result.errorMessage;
+                    // 跳过已完成的文献
+                    if (data.status == "completed") {
+                        continue;
                     }
+                    
+                    data.status = "translating";
+                    StorageManager::getInstance().updateLiteratureStatus(taskId, index, data);
+                    group.push_back(data);
                 }
-                
-                // 翻译摘要
-                if (success && config.translateAbstract && !data.originalAbstract.empty()) {
-                    TranslationResult result = translator.translate(data.originalAbstract, "摘要");
-                    if (result.success) {
-                        data.translatedAbstract = result.translatedText;
-                    } else {
-                        success = false;
-                        data.errorMessage = "Abstract translation failed: " + result.errorMessage;
-                    }
+                if (group.empty()) {
+                    continue;
                 }
                 
+                std::vector<bool> success;
+                translateLiteratureGroup(config.modelConfig, config, sysConfig.translationCombined, group, success);
+                
                 // 更新文献状态
-                if (success) {
-                    data.status = "completed";
-                    data.errorMessage = "";
-                    completedCount.fetch_add(1);
-                    consecutiveFailures.store(0);
-                } else {
-                    data.status = "failed";
-                    failedCount.fetch_add(1);
-                    int failures = consecutiveFailures.fetch_add(1) + 1;
+                for (size_t k = 0; k < group.size(); k++) {
+                    LiteratureData& data = group[k];
+                    if (success[k]) {
+                        data.status = "completed";
+                        data.errorMessage = "";
+                        completedCount.fetch_add(1);
+                        consecutiveFailures.store(0);
+                    } else {
+                        data.status = "failed";
+                        failedCount.fetch_add(1);
+                        int failures = consecutiveFailures.fetch_add(1) + 1;
                     
-                    if (failures >= maxConsecutiveFailures) {
-                        shouldStop.store(true);
+                        if (failures >= maxConsecutiveFailures) {
+                            shouldStop.store(true);
+                        }
                     }
+                    
+                    StorageManager::getInstance().updateLiteratureStatus(taskId, data.index, data);
                 }
                 
-                StorageManager::getInstance().saveLiteratureData(taskId, index, data);
-                
                 // 定期更新任务进度
                 {
                     std::lock_guard<std::mutex> lock(progressMutex);
@@ -1099,7 +1306,22 @@ void TaskQueue::translateTaskMultiThread(const std::string& taskId, int numThrea
     }
 }
 
-// 连续调度翻译 - 多模型工作窃取式调度
+// 已完成的文献组：由引擎线程放入，任务线程取出后保存
+struct AsyncCompletions {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::queue<std::shared_ptr<LiteratureGroupJob>> jobs;
+    
+    void push(const std::shared_ptr<LiteratureGroupJob>& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push(job);
+        }
+        cv.notify_one();
+    }
+};
+
+// 连续调度翻译 - 多模型共享待翻译队列，请求由 TranslationEngine 异步发送
 void TaskQueue::translateTaskContinuous(const std::string& taskId) {
     try {
         Logger::getInstance().info("Translating task with continuous scheduling: " + taskId);
@@ -1109,15 +1331,11 @@ void TaskQueue::translateTaskContinuous(const std::string& taskId) {
         config.status = "running";
         StorageManager::getInstance().saveTaskConfig(config);
         
-        // 加载文献索引
-        std::vector<int> indices = StorageManager::getInstance().loadIndexJson(taskId);
-        
         // 过滤出待翻译的文献
         std::vector<int> pendingIndices;
-        for (int index : indices) {
-            LiteratureData data = StorageManager::getInstance().loadLiteratureData(taskId, index);
+        for (const auto& data : StorageManager::getInstance().loadAllLiteratureData(taskId)) {
             if (data.status != "completed") {
-                pendingIndices.push_back(index);
+                pendingIndices.push_back(data.index);
             }
         }
         
@@ -1128,144 +1346,146 @@ void TaskQueue::translateTaskContinuous(const std::string& taskId) {
             return;
         }
         
-        // 共享状态
-        std::atomic<int> completedCount(config.completedCount);
-        std::atomic<int> failedCount(config.failedCount);
-        std::atomic<int> consecutiveFailures(0);
-        std::atomic<bool> shouldStop(false);
-        std::mutex progressMutex;
-        
-        // 共享任务队列
-        std::queue<int> taskQueue;
-        std::mutex queueMutex;
-        for (int idx : pendingIndices) {
-            taskQueue.push(idx);
+        int completedCount = config.completedCount;
+        int failedCount = config.failedCount;
+        int consecutiveFailures = 0;
+        bool shouldStop = false;
+        SystemConfig sysConfig = ConfigManager::getInstance().loadSystemConfig();
+        int maxConsecutiveFailures = sysConfig.consecutiveFailureThreshold;
+        size_t groupSize = static_cast<size_t>(std::max(1, sysConfig.translationBatchSize));
+        
+        // 每个模型的线程数即其同时在途的文献组数（批量翻译时一组多篇，否则一篇）。请求由 TranslationEngine 的事件线程异步收发，
+        // 本线程只负责分派文献、保存结果和更新进度
+        size_t modelCount = config.modelConfigs.size();
+        std::vector<std::string> modelNames;
+        std::vector<int> inFlight(modelCount, 0);
+        int totalInFlight = 0;
+        int totalSlots = 0;
+        for (const auto& mwt : config.modelConfigs) {
+            modelNames.push_back(mwt.model.name.empty() ? mwt.model.modelId : mwt.model.name);
+            totalSlots += std::max(1, mwt.threads);
         }
+        auto completions = std::make_shared<AsyncCompletions>();
+        size_t nextPending = 0;
+        size_t nextModel = 0;
         
-        int maxConsecutiveFailures = ConfigManager::getInstance().loadSystemConfig().consecutiveFailureThreshold;
+        Logger::getInstance().info("Dispatching " + std::to_string(pendingIndices.size()) + " literatures to " +
+                                   std::to_string(modelCount) + " models (" + std::to_string(totalSlots) +
+                                   " concurrent requests) for task: " + taskId);
         
-        // 创建工作函数 - 每个worker从共享队列中取任务
-        auto continuousWorker = [&](const ModelConfig& workerModel) {
-            Translator translator(workerModel);
-            std::string modelName = workerModel.name.empty() ? workerModel.modelId : workerModel.name;
+        while (true) {
+            // 检查是否被暂停
+            if (!shouldStop && StorageManager::getInstance().loadTaskConfig(taskId).status == "paused") {
+                shouldStop = true;
+            }
             
-            while (!shouldStop.load()) {
-                // 从队列中取一个任务
-                int index = -1;
-                {
-                    std::lock_guard<std::mutex> lock(queueMutex);
-                    if (taskQueue.empty()) {
-                        return;  // 队列空了，退出
+            // 有空闲名额的模型轮流取出待翻译的文献
+            while (!shouldStop && nextPending < pendingIndices.size()) {
+                size_t model = modelCount;
+                for (size_t i = 0; i < modelCount; i++) {
+                    size_t candidate = (nextModel + i) % modelCount;
+                    if (inFlight[candidate] < std::max(1, config.modelConfigs[candidate].threads)) {
+                        model = candidate;
+                        break;
                     }
-                    index = taskQueue.front();
-                    taskQueue.pop();
                 }
-                
-                // 检查是否被暂停
-                TaskConfig currentConfig = StorageManager::getInstance().loadTaskConfig(taskId);
-                if (currentConfig.status == "paused") {
-                    // 把任务放回队列
-                    std::lock_guard<std::mutex> lock(queueMutex);
-                    taskQueue.push(index);
-                    shouldStop.store(true);
-                    return;
+                if (model == modelCount) {
+                    break;
                 }
+                nextModel = (model + 1) % modelCount;
                 
-                LiteratureData data = StorageManager::getInstance().loadLiteratureData(taskId, index);
-                
-                if (data.status == "completed") {
+                // 取出下一组文献（批量翻译时一组多篇）
+                auto job = std::make_shared<LiteratureGroupJob>();
+                job->model = model;
+                while (nextPending < pendingIndices.size() && job->group.size() < groupSize) {
+                    int index = pendingIndices[nextPending++];
+                    LiteratureData data = StorageManager::getInstance().loadLiteratureData(taskId, index);
+                    if (data.status == "completed") {
+                        continue;
+                    }
+                    
+                    data.status = "translating";
+                    data.translatedByModel = modelNames[model];
+                    StorageManager::getInstance().updateLiteratureStatus(taskId, index, data);
+                    job->group.push_back(data);
+                }
+                if (job->group.empty()) {
                     continue;
                 }
                 
-                data.status = "translating";
-                data.translatedByModel = modelName;
-                StorageManager::getInstance().saveLiteratureData(taskId, index, data);
-                
-                bool success = true;
+                inFlight[model]++;
+                totalInFlight++;
+                translateLiteratureGroupAsync(job, config.modelConfigs[model].model,
+                                              config.translateTitle, config.translateAbstract,
+                                              sysConfig.translationCombined,
+                                              [job, completions]() { completions->push(job); });
+            }
                 
-                // 翻译标题
-                if (config.translateTitle && !data.originalTitle.empty()) {
-                    TranslationResult result = translator.translate(data.originalTitle, "标题");
-                    if (result.success) {
-                        data.translatedTitle = result.translatedText;
-                    } else {
-                        success = false;
-                        data.errorMessage = "Title translation failed: " + result.errorMessage;
-                    }
-                }
+            if (totalInFlight == 0) {
+                break;
+            }
+            
+            // 等待在途的文献完成（超时后重新检查暂停状态）
+            std::queue<std::shared_ptr<LiteratureGroupJob>> finished;
+            {
+                std::unique_lock<std::mutex> lock(completions->mutex);
+                completions->cv.wait_for(lock, std::chrono::seconds(1), [&] { return !completions->jobs.empty(); });
+                finished.swap(completions->jobs);
+            }
+            if (finished.empty()) {
+                continue;
+            }
+            
+            while (!finished.empty()) {
+                std::shared_ptr<LiteratureGroupJob> job = finished.front();
+                finished.pop();
+                inFlight[job->model]--;
+                totalInFlight--;
                 
-                // 翻译摘要
-                if (success && config.translateAbstract && !data.originalAbstract.empty()) {
-                    TranslationResult result = translator.translate(data.originalAbstract, "摘要");
-                    if (result.success) {
-                        data.translatedAbstract = result.translatedText;
+                for (size_t i = 0; i < job->group.size(); i++) {
+                    LiteratureData& data = job->group[i];
+                    if (job->success[i]) {
+                        data.status = "completed";
+                        data.errorMessage = "";
+                        completedCount++;
+                        consecutiveFailures = 0;
                     } else {
-                        success = false;
-                        data.errorMessage = "Abstract translation failed: " + result.errorMessage;
+                        data.status = "failed";
+                        failedCount++;
+                        if (++consecutiveFailures >= maxConsecutiveFailures) {
+                            shouldStop = true;
+                        }
                     }
+                    StorageManager::getInstance().updateLiteratureStatus(taskId, data.index, data);
                 }
+            }
                 
-                if (success) {
-                    data.status = "completed";
-                    data.errorMessage = "";
-                    completedCount.fetch_add(1);
-                    consecutiveFailures.store(0);
-                } else {
-                    data.status = "failed";
-                    failedCount.fetch_add(1);
-                    int failures = consecutiveFailures.fetch_add(1) + 1;
-                    if (failures >= maxConsecutiveFailures) {
-                        shouldStop.store(true);
-                    }
-                }
+            // 更新任务进度
+            TaskConfig latestConfig = StorageManager::getInstance().loadTaskConfig(taskId);
+            if (latestConfig.status == "paused") {
+                shouldStop = true;
+            } else {
+                latestConfig.completedCount = completedCount;
+                latestConfig.failedCount = failedCount;
                 
-                StorageManager::getInstance().saveLiteratureData(taskId, index, data);
+                auto now = std::chrono::system_clock::now();
+                auto time = std::chrono::system_clock::to_time_t(now);
+                std::tm tm = *std::gmtime(&time);
+                std::ostringstream oss;
+                oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
+                latestConfig.updatedAt = oss.str();
                 
-                // 更新任务进度
-                {
-                    std::lock_guard<std::mutex> lock(progressMutex);
-                    TaskConfig latestConfig = StorageManager::getInstance().loadTaskConfig(taskId);
-                    if (latestConfig.status == "paused") {
-                        shouldStop.store(true);
-                    } else {
-                        latestConfig.completedCount = completedCount.load();
-                        latestConfig.failedCount = failedCount.load();
-                        
-                        auto now = std::chrono::system_clock::now();
-                        auto time = std::chrono::system_clock::to_time_t(now);
-                        std::tm tm = *std::gmtime(&time);
-                        std::ostringstream oss;
-                        oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
-                        latestConfig.updatedAt = oss.str();
-                        
-                        StorageManager::getInstance().saveTaskConfig(latestConfig);
-                    }
-                }
-            }
-        };
-        
-        // 为每个模型的每个线程创建worker
-        std::vector<std::future<void>> futures;
-        for (const auto& mwt : config.modelConfigs) {
-            for (int t = 0; t < mwt.threads; t++) {
-                futures.push_back(std::async(std::launch::async, continuousWorker, mwt.model));
+                StorageManager::getInstance().saveTaskConfig(latestConfig);
             }
         }
         
-        Logger::getInstance().info("Started " + std::to_string(futures.size()) + " continuous workers for task: " + taskId);
-        
-        // 等待所有worker完成
-        for (auto& future : futures) {
-            future.wait();
-        }
-        
         // 更新最终状态
         config = StorageManager::getInstance().loadTaskConfig(taskId);
-        config.completedCount = completedCount.load();
-        config.failedCount = failedCount.load();
+        config.completedCount = completedCount;
+        config.failedCount = failedCount;
         
         if (config.status != "paused") {
-            if (shouldStop.load() && consecutiveFailures.load() >= maxConsecutiveFailures) {
+            if (shouldStop && consecutiveFailures >= maxConsecutiveFailures) {
                 config.status = "paused";
                 Logger::getInstance().error("Too many consecutive failures, pausing task: " + taskId);
             } else if (config.completedCount + config.failedCount >= config.totalCount) {
@@ -0,0 +1,78 @@
+#include "thread_pool.h"
+#include "logger.h"
+
+ThreadPool::ThreadPool(size_t numThreads, size_t maxQueue)
+    : maxQueue_(maxQueue), stopping_(false), active_(0) {
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+    for (size_t i = 0; i < numThreads; i++) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+bool ThreadPool::submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return false;
+        }
+        if (maxQueue_ > 0 && jobs_.size() >= maxQueue_) {
+            return false;
+        }
+        jobs_.push(std::move(job));
+    }
+    cv_.notify_one();
+    return true;
+}
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t ThreadPool::pendingCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;  // stopping_ 且队列已清空
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop();
+        }
+        
+        active_.fetch_add(1);
+        try {
+            job();
+        } catch (const std::exception& e) {
+            Logger::getInstance().error("Unhandled exception in worker thread: " + std::string(e.what()));
+        } catch (...) {
+            Logger::getInstance().error("Unhandled unknown exception in worker thread");
+        }
+        active_.fetch_sub(1);
+    }
+}
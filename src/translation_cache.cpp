@@ -0,0 +1,480 @@
+#include "translation_cache.h"
+#include "storage_manager.h"
+#include "logger.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <io.h>
+    #define platform_fseek _fseeki64
+    #define platform_fileno _fileno
+    #define platform_truncate(fd, size) _chsize_s(fd, size)
+#else
+    #include <unistd.h>
+    #define platform_fseek fseeko
+    #define platform_fileno fileno
+    #define platform_truncate(fd, size) ftruncate(fd, size)
+#endif
+
+// 缓存文件的文件头（格式标识与版本）
+static const char CACHE_MAGIC[8] = {'W', 'O', 'S', 'T', 'M', 'C', '0', '1'};
+static const size_t MAGIC_SIZE = sizeof(CACHE_MAGIC);
+
+// 键为 SHA-256 的十六进制字符串
+static const size_t KEY_SIZE = 64;
+
+// 记录头：长度、CRC32、键
+static const size_t RECORD_HEADER_SIZE = 8 + KEY_SIZE;
+
+// 单条译文的长度上限，超过视为文件损坏
+static const uint32_t MAX_TRANSLATION_SIZE = 16 * 1024 * 1024;
+
+// 内存层每条译文在键和译文之外的估算开销（链表节点、哈希表项）
+static const uint64_t MEMORY_ENTRY_OVERHEAD = 96;
+
+static void writeU32(char* out, uint32_t value) {
+    out[0] = static_cast<char>(value & 0xff);
+    out[1] = static_cast<char>((value >> 8) & 0xff);
+    out[2] = static_cast<char>((value >> 16) & 0xff);
+    out[3] = static_cast<char>((value >> 24) & 0xff);
+}
+
+static uint32_t readU32(const char* in) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(in);
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// 校验和覆盖键和译文
+static uint32_t recordChecksum(const char* key, const char* data, size_t size) {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(key), static_cast<uInt>(KEY_SIZE));
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(size));
+    return static_cast<uint32_t>(crc);
+}
+
+static void encodeRecord(std::string& out, const std::string& key, const std::string& translation) {
+    char header[8];
+    writeU32(header, static_cast<uint32_t>(translation.size()));
+    writeU32(header + 4, recordChecksum(key.data(), translation.data(), translation.size()));
+    out.append(header, sizeof(header));
+    out.append(key);
+    out.append(translation);
+}
+
+static bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+TranslationCache& TranslationCache::getInstance() {
+    static TranslationCache instance;
+    return instance;
+}
+
+TranslationCache::TranslationCache()
+    : path_("data/.translation_cache"), enabled_(false), memoryLimit_(0), diskLimit_(0), memoryBytes_(0),
+      file_(nullptr), fileOpened_(false), diskReady_(false), fileBytes_(0),
+      stopping_(false), hits_(0), misses_(0) {
+}
+
+TranslationCache::~TranslationCache() {
+    // 写入线程退出前写完排队的译文
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    writeCv_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    if (file_) {
+        fclose(file_);
+    }
+}
+
+void TranslationCache::configure(bool enabled, int memoryMB, int diskMB) {
+    uint64_t diskLimit = static_cast<uint64_t>(std::max(0, diskMB)) * 1024 * 1024;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        enabled_ = enabled;
+        memoryLimit_ = static_cast<uint64_t>(std::max(0, memoryMB)) * 1024 * 1024;
+        diskLimit_ = diskLimit;
+        trimMemory();
+    }
+    
+    if (enabled && diskLimit > 0) {
+        std::lock_guard<std::mutex> fileLock(fileMutex_);
+        if (!fileOpened_) {
+            fileOpened_ = true;
+            if (openFile()) {
+                writer_ = std::thread(&TranslationCache::writeLoop, this);
+                std::lock_guard<std::mutex> lock(mutex_);
+                diskReady_ = true;
+            } else {
+                Logger::getInstance().error("Translation cache file unavailable, caching in memory only: " + path_);
+            }
+        }
+    }
+    // 上限调小后由写入线程重写文件
+    writeCv_.notify_one();
+}
+
+std::string TranslationCache::makeKey(const ModelConfig& model, const std::string& context, const std::string& text) {
+    // 各字段以 \0 分隔，避免不同字段拼接后相同
+    std::string material;
+    for (const std::string* field : {&model.provider, &model.modelId, &model.systemPrompt}) {
+        material += *field;
+        material += '\0';
+    }
+    material += std::to_string(model.temperature);
+    material += '\0';
+    material += context;
+    material += '\0';
+    material += text;
+    return StorageManager::sha256Hex(material);
+}
+
+bool TranslationCache::lookup(const std::string& key, std::string& translation) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!enabled_) {
+            return false;
+        }
+        
+        auto it = memory_.find(key);
+        if (it != memory_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            translation = it->second->second;
+            hits_++;
+            return true;
+        }
+        if (disk_.count(key) == 0) {
+            misses_++;
+            return false;
+        }
+    }
+    
+    // 读取文件时不持有 mutex_，store() 与其他内存层查询不必等待；
+    // 持有 fileMutex_ 期间索引中的位置不会因写入线程重写文件而失效
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> fileLock(fileMutex_);
+        DiskLocation location = {0, 0};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = disk_.find(key);
+            if (it != disk_.end()) {
+                location = it->second;
+                found = true;
+            }
+        }
+        found = found && file_ && readAt(location, translation);
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (found) {
+        remember(key, translation);
+        hits_++;
+    } else {
+        misses_++;
+    }
+    return found;
+}
+
+void TranslationCache::store(const std::string& key, const std::string& translation) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!enabled_ || translation.size() > MAX_TRANSLATION_SIZE) {
+            return;
+        }
+        
+        remember(key, translation);
+        if (!diskReady_ || diskLimit_ == 0 || disk_.count(key) > 0) {
+            return;
+        }
+        pendingWrites_.emplace_back(key, translation);
+    }
+    writeCv_.notify_one();
+}
+
+TranslationCache::Stats TranslationCache::getStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.memoryEntries = memory_.size();
+    stats.memoryBytes = memoryBytes_;
+    stats.diskEntries = disk_.size();
+    stats.diskBytes = fileBytes_;
+    return stats;
+}
+
+bool TranslationCache::openFile() {
+    // 调用者需要持有 fileMutex_；打开缓存文件（不存在时创建）并扫描重建索引，残缺的末尾记录被截断
+    file_ = fopen(path_.c_str(), "r+b");
+    if (!file_) {
+        file_ = fopen(path_.c_str(), "w+b");
+        if (!file_ || fwrite(CACHE_MAGIC, 1, MAGIC_SIZE, file_) != MAGIC_SIZE || fflush(file_) != 0) {
+            if (file_) {
+                fclose(file_);
+                file_ = nullptr;
+            }
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        fileBytes_ = MAGIC_SIZE;
+        return true;
+    }
+    
+    char magic[MAGIC_SIZE];
+    if (fread(magic, 1, MAGIC_SIZE, file_) != MAGIC_SIZE || memcmp(magic, CACHE_MAGIC, MAGIC_SIZE) != 0) {
+        Logger::getInstance().error("Invalid translation cache file: " + path_);
+        fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    
+    std::unordered_map<std::string, DiskLocation> index;
+    uint64_t offset = MAGIC_SIZE;
+    std::string translation;
+    while (true) {
+        char header[RECORD_HEADER_SIZE];
+        size_t headerRead = fread(header, 1, RECORD_HEADER_SIZE, file_);
+        if (headerRead == 0 && feof(file_)) {
+            break;
+        }
+        
+        uint32_t length = headerRead == RECORD_HEADER_SIZE ? readU32(header) : 0;
+        bool valid = headerRead == RECORD_HEADER_SIZE && length <= MAX_TRANSLATION_SIZE;
+        if (valid) {
+            translation.resize(length);
+            valid = fread(&translation[0], 1, length, file_) == length &&
+                    recordChecksum(header + 8, translation.data(), length) == readU32(header + 4);
+        }
+        if (!valid) {
+            Logger::getInstance().warning("Truncating damaged tail of translation cache at offset " +
+                                          std::to_string(offset));
+            fflush(file_);
+            if (platform_truncate(platform_fileno(file_), offset) != 0) {
+                Logger::getInstance().error("Failed to truncate translation cache: " + path_);
+            }
+            break;
+        }
+        
+        index[std::string(header + 8, KEY_SIZE)] = {offset + RECORD_HEADER_SIZE, length};
+        offset += RECORD_HEADER_SIZE + length;
+    }
+    
+    Logger::getInstance().info("Translation cache loaded: " + std::to_string(index.size()) + " entries, " +
+                               std::to_string(offset) + " bytes");
+    std::lock_guard<std::mutex> lock(mutex_);
+    disk_.swap(index);
+    fileBytes_ = offset;
+    return true;
+}
+
+bool TranslationCache::readAt(const DiskLocation& location, std::string& translation) {
+    // 调用者需要持有 fileMutex_
+    translation.resize(location.length);
+    if (platform_fseek(file_, static_cast<int64_t>(location.offset), SEEK_SET) != 0 ||
+        (location.length > 0 && fread(&translation[0], 1, location.length, file_) != location.length)) {
+        Logger::getInstance().error("Failed to read translation cache: " + path_);
+        translation.clear();
+        return false;
+    }
+    return true;
+}
+
+void TranslationCache::remember(const std::string& key, const std::string& translation) {
+    // 调用者需要持有 mutex_；放入内存层（已存在时更新并移到最前）
+    uint64_t bytes = key.size() + translation.size() + MEMORY_ENTRY_OVERHEAD;
+    if (bytes > memoryLimit_) {
+        return;
+    }
+    
+    auto it = memory_.find(key);
+    if (it != memory_.end()) {
+        memoryBytes_ -= it->second->first.size() + it->second->second.size() + MEMORY_ENTRY_OVERHEAD;
+        it->second->second = translation;
+        lru_.splice(lru_.begin(), lru_, it->second);
+    } else {
+        lru_.emplace_front(key, translation);
+        memory_[key] = lru_.begin();
+    }
+    memoryBytes_ += bytes;
+    trimMemory();
+}
+
+void TranslationCache::trimMemory() {
+    // 调用者需要持有 mutex_；淘汰最久未使用的译文直到不超过上限
+    while (memoryBytes_ > memoryLimit_ && !lru_.empty()) {
+        const auto& oldest = lru_.back();
+        memoryBytes_ -= oldest.first.size() + oldest.second.size() + MEMORY_ENTRY_OVERHEAD;
+        memory_.erase(oldest.first);
+        lru_.pop_back();
+    }
+}
+
+void TranslationCache::writeLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        writeCv_.wait(lock, [this]() {
+            return stopping_ || !pendingWrites_.empty() || (diskReady_ && diskLimit_ > 0 && fileBytes_ > diskLimit_);
+        });
+        if (stopping_ && pendingWrites_.empty()) {
+            break;
+        }
+        
+        std::vector<std::pair<std::string, std::string>> entries;
+        entries.swap(pendingWrites_);
+        uint64_t limit = diskLimit_;
+        lock.unlock();
+        
+        {
+            std::lock_guard<std::mutex> fileLock(fileMutex_);
+            appendRecords(entries);
+            bool overLimit;
+            {
+                std::lock_guard<std::mutex> indexLock(mutex_);
+                overLimit = limit > 0 && fileBytes_ > limit;
+            }
+            if (overLimit && !compact(limit / 4 * 3)) {
+                // 无法重写时停止写入文件（已有译文仍可读取），避免反复重试
+                std::lock_guard<std::mutex> indexLock(mutex_);
+                diskReady_ = false;
+                pendingWrites_.clear();
+            }
+        }
+        
+        lock.lock();
+    }
+}
+
+void TranslationCache::appendRecords(const std::vector<std::pair<std::string, std::string>>& entries) {
+    // 调用者需要持有 fileMutex_，此时可以不加 mutex_ 读取索引；
+    // 只追加不落盘：缓存丢失最后几条记录无碍，残缺的记录在下次打开时截断
+    if (!file_) {
+        return;
+    }
+    std::string records;
+    std::vector<std::pair<std::string, DiskLocation>> added;
+    uint64_t offset = fileBytes_;
+    for (const auto& entry : entries) {
+        if (disk_.count(entry.first) > 0) {
+            continue;
+        }
+        added.emplace_back(entry.first, DiskLocation{offset + records.size() + RECORD_HEADER_SIZE,
+                                                     static_cast<uint32_t>(entry.second.size())});
+        encodeRecord(records, entry.first, entry.second);
+    }
+    if (records.empty()) {
+        return;
+    }
+    
+    if (platform_fseek(file_, static_cast<int64_t>(offset), SEEK_SET) != 0 ||
+        fwrite(records.data(), 1, records.size(), file_) != records.size() || fflush(file_) != 0) {
+        Logger::getInstance().error("Failed to write translation cache: " + path_);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : added) {
+        disk_.insert(entry);
+    }
+    fileBytes_ = offset + records.size();
+}
+
+bool TranslationCache::compact(uint64_t targetBytes) {
+    // 调用者需要持有 fileMutex_，此时可以不加 mutex_ 读取索引（只在最后替换索引时加锁）；
+    // 重写缓存文件，按写入顺序保留最近写入的译文直到不超过 targetBytes
+    struct Entry {
+        uint64_t offset;
+        std::string key;
+        DiskLocation location;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(disk_.size());
+    for (const auto& pair : disk_) {
+        entries.push_back({pair.second.offset, pair.first, pair.second});
+    }
+    uint64_t oldBytes = fileBytes_;
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.offset < b.offset; });
+    
+    size_t first = entries.size();
+    uint64_t keptBytes = MAGIC_SIZE;
+    while (first > 0) {
+        uint64_t recordBytes = RECORD_HEADER_SIZE + entries[first - 1].location.length;
+        if (keptBytes + recordBytes > targetBytes) {
+            break;
+        }
+        keptBytes += recordBytes;
+        first--;
+    }
+    
+    std::string tempPath = path_ + ".compact";
+    std::FILE* out = fopen(tempPath.c_str(), "wb");
+    if (!out) {
+        Logger::getInstance().error("Failed to create compacted translation cache: " + tempPath);
+        return false;
+    }
+    
+    std::unordered_map<std::string, DiskLocation> newIndex;
+    uint64_t offset = MAGIC_SIZE;
+    bool ok = fwrite(CACHE_MAGIC, 1, MAGIC_SIZE, out) == MAGIC_SIZE;
+    std::string translation;
+    std::string record;
+    for (size_t i = first; ok && i < entries.size(); i++) {
+        ok = readAt(entries[i].location, translation);
+        if (ok) {
+            record.clear();
+            encodeRecord(record, entries[i].key, translation);
+            ok = fwrite(record.data(), 1, record.size(), out) == record.size();
+            newIndex[entries[i].key] = {offset + RECORD_HEADER_SIZE, static_cast<uint32_t>(translation.size())};
+            offset += record.size();
+        }
+    }
+    ok = fclose(out) == 0 && ok;
+    
+    if (!ok) {
+        Logger::getInstance().error("Failed to compact translation cache: " + path_);
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    
+    fclose(file_);
+    file_ = nullptr;
+    bool replaced = replaceFile(tempPath, path_);
+    if (!replaced) {
+        Logger::getInstance().error("Failed to replace translation cache: " + path_);
+        std::remove(tempPath.c_str());
+    }
+    file_ = fopen(path_.c_str(), "r+b");
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!file_) {
+            disk_.clear();
+            diskReady_ = false;
+        } else if (replaced) {
+            disk_.swap(newIndex);
+            fileBytes_ = offset;
+        }
+    }
+    if (!file_) {
+        Logger::getInstance().error("Failed to reopen translation cache: " + path_);
+        return false;
+    }
+    if (replaced) {
+        Logger::getInstance().info("Compacted translation cache: " + std::to_string(entries.size()) + " -> " +
+                                   std::to_string(disk_.size()) + " entries, " + std::to_string(oldBytes) + " -> " +
+                                   std::to_string(offset) + " bytes");
+    }
+    return replaced;
+}
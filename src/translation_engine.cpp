@@ -0,0 +1,493 @@
+#include "translation_engine.h"
+#include "translation_cache.h"
+#include "logger.h"
+#include <algorithm>
+
+// 没有网络事件时事件线程最长的等待时间（毫秒）
+static const int EVENT_POLL_TIMEOUT_MS = 1000;
+
+TranslationEngine& TranslationEngine::getInstance() {
+    static TranslationEngine instance;
+    return instance;
+}
+
+TranslationEngine::TranslationEngine() : running_(true) {
+    // 先于引擎构造连接池（curl_global_init），保证其在引擎之后析构
+    CurlPool::getInstance();
+    multi_ = curl_multi_init();
+    thread_ = std::thread(&TranslationEngine::eventLoop, this);
+}
+
+TranslationEngine::~TranslationEngine() {
+    running_.store(false);
+    curl_multi_wakeup(multi_);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    
+    // 尚未完成的请求以失败结束
+    std::vector<Request*> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending.swap(submitted_);
+    }
+    for (Request* request : transfers_) {
+        pending.push_back(request);
+    }
+    for (const auto& pair : retryTimers_) {
+        pending.push_back(pair.second);
+    }
+    for (Request* request : pending) {
+        endTransfer(request);
+        request->result.errorMessage = "Translation engine stopped";
+        complete(request);
+    }
+    
+    curl_multi_cleanup(multi_);
+}
+
+void TranslationEngine::submit(const ModelConfig& model, const std::string& text,
+                               const std::string& context, Callback done) {
+    // 命中译文缓存时不发送请求
+    std::string key = TranslationCache::makeKey(model, context, text);
+    TranslationResult cached;
+    if (TranslationCache::getInstance().lookup(key, cached.translatedText)) {
+        cached.success = true;
+        post(model, cached, std::move(done));
+        return;
+    }
+    requestTranslation(model, text, context, key, ConfigManager::getInstance().loadSystemConfig().maxRetries,
+                       std::move(done));
+}
+
+void TranslationEngine::requestTranslation(const ModelConfig& model, const std::string& text,
+                                           const std::string& context, const std::string& key, int maxRetries,
+                                           Callback done) {
+    submitRequest(model, Translator(model).buildRequestBody(text, context), context, maxRetries,
+        [key, done](const TranslationResult& result) {
+            if (result.success) {
+                TranslationCache::getInstance().store(key, result.translatedText);
+            }
+            done(result);
+        });
+}
+
+void TranslationEngine::submitRequest(const ModelConfig& model, const std::string& body,
+                                      const std::string& context, int maxRetries, Callback done) {
+    Request* request = new Request(model);
+    request->context = context;
+    request->url = request->translator.requestUrl();
+    request->body = body;
+    request->done = std::move(done);
+    request->maxRetries = maxRetries;
+    request->result.success = false;
+    request->result.retryCount = 0;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        submitted_.push_back(request);
+    }
+    curl_multi_wakeup(multi_);
+}
+
+void TranslationEngine::post(const ModelConfig& model, const TranslationResult& result, Callback done) {
+    // 结果已确定的请求同样由事件线程回调，调用者不必区分是否命中缓存
+    Request* request = new Request(model);
+    request->ready = true;
+    request->result = result;
+    request->done = std::move(done);
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        submitted_.push_back(request);
+    }
+    curl_multi_wakeup(multi_);
+}
+
+std::future<TranslationResult> TranslationEngine::submit(const ModelConfig& model, const std::string& text,
+                                                         const std::string& context) {
+    auto promise = std::make_shared<std::promise<TranslationResult>>();
+    std::future<TranslationResult> future = promise->get_future();
+    submit(model, text, context, [promise](const TranslationResult& result) {
+        promise->set_value(result);
+    });
+    return future;
+}
+
+void TranslationEngine::submitBatch(const ModelConfig& model, const std::vector<std::string>& texts,
+                                    const std::string& context, BatchCallback done) {
+    // 各批的回调都在引擎线程中执行；pending 为尚未完成的请求数（含逐条重新翻译的请求）
+    struct BatchState {
+        std::vector<TranslationResult> results;
+        std::atomic<size_t> pending;
+        BatchCallback done;
+    };
+    auto state = std::make_shared<BatchState>();
+    state->results.resize(texts.size());
+    state->done = std::move(done);
+    auto finishOne = [state]() {
+        if (state->pending.fetch_sub(1) == 1) {
+            state->done(state->results);
+        }
+    };
+    
+    // 命中译文缓存的条目直接填入结果，其余的分批翻译
+    TranslationCache& cache = TranslationCache::getInstance();
+    std::vector<size_t> missing;
+    std::vector<size_t> sizes;
+    for (size_t i = 0; i < texts.size(); i++) {
+        if (cache.lookup(TranslationCache::makeKey(model, context, texts[i]), state->results[i].translatedText)) {
+            state->results[i].success = true;
+            continue;
+        }
+        missing.push_back(i);
+        sizes.push_back(texts[i].size());
+    }
+    if (missing.empty()) {
+        post(model, TranslationResult(), [state](const TranslationResult&) {
+            state->done(state->results);
+        });
+        return;
+    }
+    
+    // 配置在调用线程中读取一次，回调中的逐条重新翻译沿用（事件线程不读取配置文件）
+    SystemConfig sysConfig = ConfigManager::getInstance().loadSystemConfig();
+    int maxRetries = sysConfig.maxRetries;
+    std::vector<std::pair<size_t, size_t>> batches =
+        Translator::planBatches(sizes, sysConfig.translationBatchSize, sysConfig.translationBatchTokens);
+    state->pending.store(batches.size());
+    
+    for (const auto& range : batches) {
+        std::vector<size_t> members(missing.begin() + range.first, missing.begin() + range.second);
+        if (members.size() == 1) {
+            size_t index = members[0];
+            requestTranslation(model, texts[index], context, TranslationCache::makeKey(model, context, texts[index]),
+                               maxRetries, [state, index, finishOne](const TranslationResult& result) {
+                    state->results[index] = result;
+                    finishOne();
+                });
+            continue;
+        }
+        
+        std::vector<std::string> batch;
+        for (size_t index : members) {
+            batch.push_back(texts[index]);
+        }
+        std::string body = Translator(model).buildBatchRequestBody(batch, context);
+        submitRequest(model, body, context + " x" + std::to_string(batch.size()), maxRetries,
+            [this, state, model, batch, members, context, maxRetries, finishOne](const TranslationResult& response) {
+                size_t count = batch.size();
+                if (!response.success) {
+                    // 请求本身失败（已重试），整批按失败处理
+                    for (size_t k = 0; k < count; k++) {
+                        state->results[members[k]] = response;
+                    }
+                    finishOne();
+                    return;
+                }
+                
+                std::vector<TranslationResult> parsed(count);
+                size_t valid = Translator::parseBatchOutput(response.translatedText, parsed);
+                if (valid < count) {
+                    Logger::getInstance().warning("Batch translation returned " + std::to_string(count - valid) + "/" +
+                                                  std::to_string(count) + " invalid entries for " + context +
+                                                  ", translating them individually");
+                    state->pending.fetch_add(count - valid);
+                }
+                for (size_t k = 0; k < count; k++) {
+                    size_t index = members[k];
+                    std::string key = TranslationCache::makeKey(model, context, batch[k]);
+                    if (parsed[k].success) {
+                        parsed[k].retryCount = response.retryCount;
+                        state->results[index] = parsed[k];
+                        TranslationCache::getInstance().store(key, parsed[k].translatedText);
+                        continue;
+                    }
+                    requestTranslation(model, batch[k], context, key, maxRetries,
+                        [state, index, finishOne](const TranslationResult& result) {
+                            state->results[index] = result;
+                            finishOne();
+                        });
+                }
+                finishOne();
+            });
+    }
+}
+
+void TranslationEngine::submitCombined(const ModelConfig& model, const std::vector<std::string>& titles,
+                                       const std::vector<std::string>& abstracts, CombinedCallback done) {
+    struct CombinedState {
+        std::vector<TranslationResult> titles;
+        std::vector<TranslationResult> abstracts;
+        std::atomic<size_t> pending;
+        CombinedCallback done;
+    };
+    auto state = std::make_shared<CombinedState>();
+    state->titles.resize(titles.size());
+    state->abstracts.resize(titles.size());
+    state->done = std::move(done);
+    auto finishOne = [state]() {
+        if (state->pending.fetch_sub(1) == 1) {
+            state->done(state->titles, state->abstracts);
+        }
+    };
+    
+    // 标题和摘要分别查译文缓存（与单独翻译共用缓存项）：只命中其一的文献单独翻译另一项，
+    // 都未命中的合并翻译
+    TranslationCache& cache = TranslationCache::getInstance();
+    std::vector<size_t> missing;
+    std::vector<size_t> sizes;
+    std::vector<std::pair<size_t, bool>> singles;  // (文献下标, 是否为标题)
+    for (size_t i = 0; i < titles.size(); i++) {
+        bool titleHit = cache.lookup(TranslationCache::makeKey(model, "标题", titles[i]),
+                                     state->titles[i].translatedText);
+        bool abstractHit = cache.lookup(TranslationCache::makeKey(model, "摘要", abstracts[i]),
+                                        state->abstracts[i].translatedText);
+        state->titles[i].success = titleHit;
+        state->abstracts[i].success = abstractHit;
+        if (!titleHit && !abstractHit) {
+            missing.push_back(i);
+            sizes.push_back(titles[i].size() + abstracts[i].size());
+        } else if (!titleHit || !abstractHit) {
+            singles.emplace_back(i, !titleHit);
+        }
+    }
+    
+    if (missing.empty() && singles.empty()) {
+        post(model, TranslationResult(), [state](const TranslationResult&) {
+            state->done(state->titles, state->abstracts);
+        });
+        return;
+    }
+    
+    // 配置在调用线程中读取一次，回调中的分别翻译沿用（事件线程不读取配置文件）
+    SystemConfig sysConfig = ConfigManager::getInstance().loadSystemConfig();
+    int maxRetries = sysConfig.maxRetries;
+    std::vector<std::pair<size_t, size_t>> batches;
+    if (!missing.empty()) {
+        batches = Translator::planBatches(sizes, sysConfig.translationBatchSize, sysConfig.translationBatchTokens);
+    }
+    state->pending.store(batches.size() + singles.size());
+    
+    // 原文由各批的回调共享，不随回调复制
+    auto titleTexts = std::make_shared<const std::vector<std::string>>(titles);
+    auto abstractTexts = std::make_shared<const std::vector<std::string>>(abstracts);
+    
+    // 分别翻译第 index 篇文献的标题或摘要
+    auto translateSeparately = [this, state, model, titleTexts, abstractTexts, maxRetries, finishOne]
+                               (size_t index, bool title) {
+        const std::string& text = title ? (*titleTexts)[index] : (*abstractTexts)[index];
+        const char* context = title ? "标题" : "摘要";
+        requestTranslation(model, text, context, TranslationCache::makeKey(model, context, text), maxRetries,
+            [state, index, title, finishOne](const TranslationResult& result) {
+                (title ? state->titles : state->abstracts)[index] = result;
+                finishOne();
+            });
+    };
+    for (const auto& single : singles) {
+        translateSeparately(single.first, single.second);
+    }
+    
+    for (const auto& range : batches) {
+        std::vector<size_t> members(missing.begin() + range.first, missing.begin() + range.second);
+        std::vector<std::string> batchTitles;
+        std::vector<std::string> batchAbstracts;
+        for (size_t index : members) {
+            batchTitles.push_back(titles[index]);
+            batchAbstracts.push_back(abstracts[index]);
+        }
+        std::string body = Translator(model).buildCombinedRequestBody(batchTitles, batchAbstracts);
+        submitRequest(model, body, "标题和摘要 x" + std::to_string(members.size()), maxRetries,
+            [state, model, titleTexts, abstractTexts, members, finishOne, translateSeparately]
+            (const TranslationResult& response) {
+                size_t count = members.size();
+                if (!response.success) {
+                    // 请求本身失败（已重试），整批按失败处理
+                    for (size_t k = 0; k < count; k++) {
+                        state->titles[members[k]] = response;
+                        state->abstracts[members[k]] = response;
+                    }
+                    finishOne();
+                    return;
+                }
+                
+                std::vector<TranslationResult> parsedTitles(count);
+                std::vector<TranslationResult> parsedAbstracts(count);
+                size_t valid = Translator::parseCombinedOutput(response.translatedText, parsedTitles, parsedAbstracts);
+                if (valid < count) {
+                    Logger::getInstance().warning("Combined translation returned " + std::to_string(count - valid) +
+                                                  "/" + std::to_string(count) + " invalid entries" +
+                                                  ", translating title and abstract separately");
+                    state->pending.fetch_add(2 * (count - valid));
+                }
+                TranslationCache& cache = TranslationCache::getInstance();
+                for (size_t k = 0; k < count; k++) {
+                    size_t index = members[k];
+                    if (parsedTitles[k].success) {
+                        parsedTitles[k].retryCount = response.retryCount;
+                        parsedAbstracts[k].retryCount = response.retryCount;
+                        state->titles[index] = parsedTitles[k];
+                        state->abstracts[index] = parsedAbstracts[k];
+                        cache.store(TranslationCache::makeKey(model, "标题", (*titleTexts)[index]),
+                                    parsedTitles[k].translatedText);
+                        cache.store(TranslationCache::makeKey(model, "摘要", (*abstractTexts)[index]),
+                                    parsedAbstracts[k].translatedText);
+                        continue;
+                    }
+                    translateSeparately(index, true);
+                    translateSeparately(index, false);
+                }
+                finishOne();
+            });
+    }
+}
+
+void TranslationEngine::eventLoop() {
+    while (running_.load()) {
+        // 发起新提交的请求和到期的重试
+        std::vector<Request*> submitted;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            submitted.swap(submitted_);
+        }
+        for (Request* request : submitted) {
+            if (request->ready) {
+                complete(request);
+            } else {
+                startTransfer(request);
+            }
+        }
+        
+        Clock::time_point now = Clock::now();
+        while (!retryTimers_.empty() && retryTimers_.begin()->first <= now) {
+            Request* request = retryTimers_.begin()->second;
+            retryTimers_.erase(retryTimers_.begin());
+            startTransfer(request);
+        }
+        
+        // 收发数据并处理已完成的传输
+        int stillRunning = 0;
+        curl_multi_perform(multi_, &stillRunning);
+        
+        CURLMsg* message;
+        int queued = 0;
+        while ((message = curl_multi_info_read(multi_, &queued)) != nullptr) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+            Request* request = nullptr;
+            CURLcode code = message->data.result;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &request);
+            if (request) {
+                finishTransfer(request, code);
+            }
+        }
+        
+        // 等待网络事件、新的提交（curl_multi_wakeup）或最早的重试到期
+        int timeoutMs = EVENT_POLL_TIMEOUT_MS;
+        if (!retryTimers_.empty()) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(retryTimers_.begin()->first - Clock::now());
+            timeoutMs = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(timeoutMs, wait.count() + 1)));
+        }
+        curl_multi_poll(multi_, nullptr, 0, timeoutMs, nullptr);
+    }
+}
+
+void TranslationEngine::startTransfer(Request* request) {
+    request->result.retryCount = request->attempt;
+    Logger::getInstance().info("Translation attempt " + std::to_string(request->attempt + 1) +
+                               " for " + request->context);
+    
+    // 句柄取自连接池；加入 multi 后使用 multi 的连接缓存，同一端点的请求复用已有连接
+    request->handle.reset(new CurlPool::Handle(request->url));
+    CURL* curl = request->handle->get();
+    if (!curl) {
+        request->result.errorMessage = "Failed to initialize curl";
+        Logger::getInstance().error(request->result.errorMessage);
+        endTransfer(request);
+        retryOrComplete(request, true, false);
+        return;
+    }
+    
+    request->response.clear();
+    request->headers = request->translator.buildHeaders();
+    Translator::setupTransfer(curl, request->url, request->headers, request->body, &request->response);
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, request);
+    
+    if (curl_multi_add_handle(multi_, curl) != CURLM_OK) {
+        request->result.errorMessage = "Failed to start transfer";
+        Logger::getInstance().error(request->result.errorMessage);
+        endTransfer(request);
+        retryOrComplete(request, true, true);
+        return;
+    }
+    transfers_.insert(request);
+}
+
+void TranslationEngine::finishTransfer(Request* request, CURLcode code) {
+    long httpCode = 0;
+    curl_easy_getinfo(request->handle->get(), CURLINFO_RESPONSE_CODE, &httpCode);
+    
+    bool retryable = true;
+    bool backoff = true;  // 响应格式错误时立即重试，其余错误等待后重试
+    if (code != CURLE_OK) {
+        request->result.errorMessage = curl_easy_strerror(code);
+        Logger::getInstance().warning("Translation curl error: " + request->result.errorMessage);
+    } else {
+        request->handle->recordTransfer();
+        if (request->translator.parseResponse(httpCode, request->response, request->result, retryable)) {
+            Logger::getInstance().info("Translation successful for " + request->context);
+            endTransfer(request);
+            complete(request);
+            return;
+        }
+        backoff = httpCode < 200 || httpCode >= 300;
+    }
+    
+    endTransfer(request);
+    retryOrComplete(request, retryable, backoff);
+}
+
+void TranslationEngine::endTransfer(Request* request) {
+    if (transfers_.erase(request) > 0) {
+        curl_multi_remove_handle(multi_, request->handle->get());
+    }
+    if (request->headers) {
+        curl_slist_free_all(request->headers);
+        request->headers = nullptr;
+    }
+    // 归还句柄
+    request->handle.reset();
+}
+
+void TranslationEngine::retryOrComplete(Request* request, bool retryable, bool backoff) {
+    if (!retryable) {
+        complete(request);
+        return;
+    }
+    if (request->attempt >= request->maxRetries) {
+        Logger::getInstance().error("Translation failed after " + std::to_string(request->maxRetries + 1) +
+                                    " attempts: " + request->result.errorMessage);
+        complete(request);
+        return;
+    }
+    
+    int waitSeconds = backoff ? Translator::retryDelaySeconds(request->attempt) : 0;
+    if (waitSeconds > 0) {
+        Logger::getInstance().info("Waiting " + std::to_string(waitSeconds) + " seconds before retry...");
+    }
+    request->attempt++;
+    retryTimers_.emplace(Clock::now() + std::chrono::seconds(waitSeconds), request);
+}
+
+void TranslationEngine::complete(Request* request) {
+    std::unique_ptr<Request> owned(request);
+    if (!owned->done) {
+        return;
+    }
+    try {
+        owned->done(owned->result);
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Translation callback exception: " + std::string(e.what()));
+    }
+}
@@ -1,15 +1,31 @@
 #include "translator.h"
 #include "logger.h"
+#include "curl_pool.h"
+#include "translation_cache.h"
 #include "openai.hpp"
 #include <thread>
 #include <chrono>
+#include <algorithm>
 #include <curl/curl.h>
 
 Translator::Translator(const ModelConfig& config) : config_(config) {
 }
 
 TranslationResult Translator::translate(const std::string& text, const std::string& context) {
-    return translateWithRetry(text, context, ConfigManager::getInstance().loadSystemConfig().maxRetries);
+    // 先查译文缓存，相同的原文不再请求
+    std::string key = TranslationCache::makeKey(config_, context, text);
+    TranslationResult result;
+    if (TranslationCache::getInstance().lookup(key, result.translatedText)) {
+        result.success = true;
+        return result;
+    }
+    
+    result = translateWithRetry(buildRequestBody(text, context), context,
+                                ConfigManager::getInstance().loadSystemConfig().maxRetries);
+    if (result.success) {
+        TranslationCache::getInstance().store(key, result.translatedText);
+    }
+    return result;
 }
 
 TestConnectionResult Translator::testConnection() {
@@ -20,23 +36,18 @@ TestConnectionResult Translator::testConnection() {
     try {
         Logger::getInstance().info("Testing API connection to: " + config_.url);
         
-        // 使用 curl 直接测试连接，设置超时
-        CURL* curl = curl_easy_init();
+        // 构建请求
+        std::string url = requestUrl();
+        
+        // 使用 curl 直接测试连接，设置超时（句柄取自连接池，结束时归还）
+        CurlPool::Handle handle(url);
+        CURL* curl = handle.get();
         if (!curl) {
             result.errorMessage = "Failed to initialize curl";
             Logger::getInstance().error(result.errorMessage);
             return result;
         }
         
-        // 构建请求
-        std::string url = config_.url;
-        
-        // 根据autoAppendPath决定是否追加路径
-        if (config_.autoAppendPath) {
-            if (url.back() != '/') url += "/";
-            url += "chat/completions";
-        }
-        
         // 构建请求体
         nlohmann::json requestJson;
         requestJson["model"] = config_.modelId;
@@ -55,15 +66,7 @@ TestConnectionResult Translator::testConnection() {
         std::string requestBody = requestJson.dump();
         
         std::string responseData;
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        
-        // Xiaomi使用api-key头，其他使用Authorization Bearer
-        if (config_.provider == "xiaomi") {
-            headers = curl_slist_append(headers, ("api-key: " + config_.apiKey).c_str());
-        } else {
-            headers = curl_slist_append(headers, ("Authorization: Bearer " + config_.apiKey).c_str());
-        }
+        struct curl_slist* headers = buildHeaders();
         
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
         curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
@@ -83,7 +86,6 @@ TestConnectionResult Translator::testConnection() {
         result.httpCode = static_cast<int>(httpCode);
         
         curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
         
         if (res != CURLE_OK) {
             result.errorMessage = curl_easy_strerror(res);
@@ -130,196 +132,340 @@ void Translator::setConfig(const ModelConfig& config) {
     config_ = config;
 }
 
-TranslationResult Translator::translateWithRetry(const std::string& text, 
+std::string Translator::requestUrl() const {
+    std::string url = config_.url;
+    
+    // 根据autoAppendPath决定是否追加路径
+    if (config_.autoAppendPath) {
+        if (url.back() != '/') url += "/";
+        url += "chat/completions";
+    }
+    return url;
+}
+
+std::string Translator::buildRequestBody(const std::string& text, const std::string& context) const {
+    return buildChatRequestBody("请将以下" + context + "翻译为中文：\n\n" + text);
+}
+
+std::string Translator::buildBatchRequestBody(const std::vector<std::string>& texts, const std::string& context) const {
+    std::string count = std::to_string(texts.size());
+    return buildChatRequestBody("以下 JSON 数组包含 " + count + " 条" + context + "，请分别翻译为中文。"
+                                "按原顺序返回由 " + count + " 条译文组成的 JSON 字符串数组，"
+                                "只返回 JSON 数组，不要添加任何解释：\n\n" + nlohmann::json(texts).dump());
+}
+
+std::string Translator::buildCombinedRequestBody(const std::vector<std::string>& titles,
+                                                 const std::vector<std::string>& abstracts) const {
+    nlohmann::json items = nlohmann::json::array();
+    for (size_t i = 0; i < titles.size(); i++) {
+        items.push_back({{"title", titles[i]}, {"abstract", abstracts[i]}});
+    }
+    std::string count = std::to_string(titles.size());
+    return buildChatRequestBody("以下 JSON 数组包含 " + count + " 篇文献的标题（title）和摘要（abstract），"
+                                "请分别翻译为中文。按原顺序返回由 " + count + " 个 {\"title\": 标题译文, "
+                                "\"abstract\": 摘要译文} 对象组成的 JSON 数组，"
+                                "只返回 JSON 数组，不要添加任何解释：\n\n" + items.dump());
+}
+
+std::string Translator::buildChatRequestBody(const std::string& userPrompt) const {
+    // 构建提示词
+    std::string systemPrompt = config_.systemPrompt.empty()
+        ? "你是一个专业的学术文献翻译助手，请将以下英文翻译为中文，保持学术性和准确性。只返回翻译结果，不要添加任何解释。"
+        : config_.systemPrompt;
+    
+    // 使用 nlohmann::json 构建请求体（自动处理转义）
+    nlohmann::json requestJson;
+    requestJson["model"] = config_.modelId;
+    requestJson["messages"] = nlohmann::json::array({
+        {{"role", "system"}, {"content", systemPrompt}},
+        {{"role", "user"}, {"content", userPrompt}}
+    });
+    requestJson["temperature"] = config_.temperature;
+    
+    // 厂商特定参数
+    if (config_.provider == "xiaomi") {
+        requestJson["thinking"] = {{"type", config_.enableThinking ? "enabled" : "disabled"}};
+    } else if (config_.provider == "minimax") {
+        requestJson["reasoning_split"] = true;
+    }
+    
+    return requestJson.dump();
+}
+
+curl_slist* Translator::buildHeaders() const {
+    struct curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, "Content-Type: application/json");
+    
+    // Xiaomi使用api-key头，其他使用Authorization Bearer
+    if (config_.provider == "xiaomi") {
+        headers = curl_slist_append(headers, ("api-key: " + config_.apiKey).c_str());
+    } else {
+        headers = curl_slist_append(headers, ("Authorization: Bearer " + config_.apiKey).c_str());
+    }
+    return headers;
+}
+
+static size_t appendResponse(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    static_cast<std::string*>(userdata)->append(ptr, size * nmemb);
+    return size * nmemb;
+}
+
+void Translator::setupTransfer(CURL* curl, const std::string& url, curl_slist* headers,
+                               const std::string& requestBody, std::string* responseData) {
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, requestBody.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(requestBody.size()));
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 60L);  // 60秒超时
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 15L);  // 15秒连接超时
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, appendResponse);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, responseData);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+}
+
+bool Translator::parseResponse(long httpCode, const std::string& responseData,
+                               TranslationResult& result, bool& retryable) const {
+    retryable = false;
+    
+    // 检查 HTTP 状态码
+    if (httpCode < 200 || httpCode >= 300) {
+        // 尝试解析错误响应
+        try {
+            auto errJson = nlohmann::json::parse(responseData);
+            if (errJson.contains("error") && errJson["error"].contains("message")) {
+                result.errorMessage = errJson["error"]["message"].get<std::string>();
+            } else {
+                result.errorMessage = "HTTP " + std::to_string(httpCode);
+            }
+        } catch (...) {
+            result.errorMessage = "HTTP " + std::to_string(httpCode) + ": " + responseData.substr(0, 100);
+        }
+        
+        Logger::getInstance().warning("Translation HTTP error: " + result.errorMessage);
+        
+        // 判断是否为可重试错误
+        retryable = (httpCode == 429 || httpCode >= 500);
+        return false;
+    }
+    
+    // 解析响应（格式错误时同样重试）
+    retryable = true;
+    try {
+        auto responseJson = nlohmann::json::parse(responseData);
+        
+        if (responseJson.contains("choices") && responseJson["choices"].is_array() &&
+            !responseJson["choices"].empty()) {
+            auto choice = responseJson["choices"][0];
+            if (choice.contains("message") && choice["message"].contains("content")) {
+                result.translatedText = choice["message"]["content"].get<std::string>();
+                
+                // MiniMAX: 即使使用reasoning_split，也做兜底清理<think>标签
+                if (config_.provider == "minimax") {
+                    std::string& text = result.translatedText;
+                    size_t thinkStart = text.find("<think>");
+                    while (thinkStart != std::string::npos) {
+                        size_t thinkEnd = text.find("</think>", thinkStart);
+                        if (thinkEnd != std::string::npos) {
+                            text.erase(thinkStart, thinkEnd - thinkStart + 8);
+                        } else {
+                            // 没有闭合标签，删除到末尾
+                            text.erase(thinkStart);
+                            break;
+                        }
+                        thinkStart = text.find("<think>");
+                    }
+                    // 去除首尾空白
+                    size_t start = text.find_first_not_of(" \t\n\r");
+                    size_t end = text.find_last_not_of(" \t\n\r");
+                    if (start != std::string::npos && end != std::string::npos) {
+                        text = text.substr(start, end - start + 1);
+                    }
+                }
+                
+                result.success = true;
+                return true;
+            }
+        }
+        
+        result.errorMessage = "Invalid API response format";
+        Logger::getInstance().warning("Translation response format error: " + responseData.substr(0, 200));
+    
+    } catch (const std::exception& e) {
+        result.errorMessage = "Failed to parse response: " + std::string(e.what());
+        Logger::getInstance().warning(result.errorMessage);
+    }
+    return false;
+}
+
+int Translator::retryDelaySeconds(int attempt) {
+    return (1 << attempt) * 2;  // 指数退避：2, 4, 8秒
+}
+
+std::vector<std::pair<size_t, size_t>> Translator::planBatches(const std::vector<size_t>& sizes,
+                                                               int maxItems, int tokenBudget) {
+    std::vector<std::pair<size_t, size_t>> batches;
+    size_t maxCount = static_cast<size_t>(std::max(1, maxItems));
+    size_t first = 0;
+    size_t tokens = 0;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        // 英文约 4 个字符计 1 token
+        size_t textTokens = sizes[i] / 4 + 1;
+        if (i > first && (i - first >= maxCount || tokens + textTokens > static_cast<size_t>(tokenBudget))) {
+            batches.emplace_back(first, i);
+            first = i;
+            tokens = 0;
+        }
+        tokens += textTokens;
+    }
+    if (first < sizes.size()) {
+        batches.emplace_back(first, sizes.size());
+    }
+    return batches;
+}
+
+// 从模型输出中取出 JSON 数组：模型可能在数组外加上代码块标记或说明文字，只取第一个 open 到最后一个 close
+static bool extractJson(const std::string& content, char open, char close, nlohmann::json& value) {
+    size_t begin = content.find(open);
+    size_t end = content.rfind(close);
+    if (begin == std::string::npos || end == std::string::npos || end < begin) {
+        return false;
+    }
+    try {
+        value = nlohmann::json::parse(content.substr(begin, end - begin + 1));
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+// 译文须为非空字符串，去除首尾空白后写入 result
+static bool takeTranslation(const nlohmann::json& value, TranslationResult& result) {
+    if (!value.is_string()) {
+        return false;
+    }
+    const std::string& text = value.get_ref<const std::string&>();
+    size_t start = text.find_first_not_of(" \t\n\r");
+    if (start == std::string::npos) {
+        return false;
+    }
+    size_t last = text.find_last_not_of(" \t\n\r");
+    result.translatedText = text.substr(start, last - start + 1);
+    result.success = true;
+    return true;
+}
+
+size_t Translator::parseBatchOutput(const std::string& content, std::vector<TranslationResult>& results) {
+    nlohmann::json items;
+    // 长度不符时无法确定译文与原文的对应关系，全部视为无效
+    if (!extractJson(content, '[', ']', items) || !items.is_array() || items.size() != results.size()) {
+        return 0;
+    }
+    
+    size_t valid = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+        if (takeTranslation(items[i], results[i])) {
+            valid++;
+        }
+    }
+    return valid;
+}
+
+size_t Translator::parseCombinedOutput(const std::string& content, std::vector<TranslationResult>& titles,
+                                       std::vector<TranslationResult>& abstracts) {
+    // 只有一篇文献时模型常直接返回对象（对象在数组之前出现）
+    nlohmann::json items;
+    if (titles.size() == 1 && content.find('{') < content.find('[')) {
+        nlohmann::json item;
+        if (!extractJson(content, '{', '}', item)) {
+            return 0;
+        }
+        items = nlohmann::json::array({item});
+    } else if (!extractJson(content, '[', ']', items) || !items.is_array()) {
+        return 0;
+    }
+    if (items.size() != titles.size()) {
+        return 0;
+    }
+    
+    size_t valid = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+        const nlohmann::json& item = items[i];
+        TranslationResult title;
+        TranslationResult abstract;
+        if (item.is_object() && item.contains("title") && item.contains("abstract") &&
+            takeTranslation(item["title"], title) && takeTranslation(item["abstract"], abstract)) {
+            titles[i] = title;
+            abstracts[i] = abstract;
+            valid++;
+        }
+    }
+    return valid;
+}
+
+TranslationResult Translator::translateWithRetry(const std::string& requestBody,
                                                  const std::string& context,
                                                  int maxRetries) {
     TranslationResult result;
     result.success = false;
     result.retryCount = 0;
     
+    std::string url = requestUrl();
+    
     for (int attempt = 0; attempt <= maxRetries; attempt++) {
+        bool backoff = true;  // 响应格式错误时立即重试，其余错误等待后重试
         try {
             result.retryCount = attempt;
             
             Logger::getInstance().info("Translation attempt " + std::to_string(attempt + 1) + 
                                       " for " + context);
             
-            // 使用 curl 直接调用 API
-            CURL* curl = curl_easy_init();
+            // 使用 curl 直接调用 API：句柄取自连接池，复用到同一端点的已有连接
+            CurlPool::Handle handle(url);
+            CURL* curl = handle.get();
             if (!curl) {
                 result.errorMessage = "Failed to initialize curl";
                 Logger::getInstance().error(result.errorMessage);
                 continue;
             }
             
-            // 构建请求 URL
-            std::string url = config_.url;
-            
-            // 根据autoAppendPath决定是否追加路径
-            if (config_.autoAppendPath) {
-                if (url.back() != '/') url += "/";
-                url += "chat/completions";
-            }
-            
-            // 构建提示词
-            std::string systemPrompt = config_.systemPrompt.empty() 
-                ? "你是一个专业的学术文献翻译助手，请将以下英文翻译为中文，保持学术性和准确性。只返回翻译结果，不要添加任何解释。"
-                : config_.systemPrompt;
-            
-            std::string userPrompt = "请将以下" + context + "翻译为中文：\n\n" + text;
-            
-            // 使用 nlohmann::json 构建请求体（自动处理转义）
-            nlohmann::json requestJson;
-            requestJson["model"] = config_.modelId;
-            requestJson["messages"] = nlohmann::json::array({
-                {{"role", "system"}, {"content", systemPrompt}},
-                {{"role", "user"}, {"content", userPrompt}}
-            });
-            requestJson["temperature"] = config_.temperature;
-            
-            // 厂商特定参数
-            if (config_.provider == "xiaomi") {
-                requestJson["thinking"] = {{"type", config_.enableThinking ? "enabled" : "disabled"}};
-            } else if (config_.provider == "minimax") {
-                requestJson["reasoning_split"] = true;
-            }
-            
-            std::string requestBody = requestJson.dump();
-            
             std::string responseData;
-            struct curl_slist* headers = nullptr;
-            headers = curl_slist_append(headers, "Content-Type: application/json");
-            
-            // Xiaomi使用api-key头，其他使用Authorization Bearer
-            if (config_.provider == "xiaomi") {
-                headers = curl_slist_append(headers, ("api-key: " + config_.apiKey).c_str());
-            } else {
-                headers = curl_slist_append(headers, ("Authorization: Bearer " + config_.apiKey).c_str());
-            }
-            
-            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, requestBody.c_str());
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 60L);  // 60秒超时
-            curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 15L);  // 15秒连接超时
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](char* ptr, size_t size, size_t nmemb, std::string* data) -> size_t {
-                data->append(ptr, size * nmemb);
-                return size * nmemb;
-            });
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseData);
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+            struct curl_slist* headers = buildHeaders();
+            setupTransfer(curl, url, headers, requestBody, &responseData);
             
             CURLcode res = curl_easy_perform(curl);
             long httpCode = 0;
             curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
             
             curl_slist_free_all(headers);
-            curl_easy_cleanup(curl);
             
             if (res != CURLE_OK) {
                 result.errorMessage = curl_easy_strerror(res);
                 Logger::getInstance().warning("Translation curl error: " + result.errorMessage);
-                
-                // 如果还有重试机会，等待后重试
-                if (attempt < maxRetries) {
-                    int waitSeconds = (1 << attempt) * 2;  // 指数退避：2, 4, 8秒
-                    Logger::getInstance().info("Waiting " + std::to_string(waitSeconds) + 
-                                             " seconds before retry...");
-                    std::this_thread::sleep_for(std::chrono::seconds(waitSeconds));
-                }
-                continue;
-            }
-            
-            // 检查 HTTP 状态码
-            if (httpCode < 200 || httpCode >= 300) {
-                // 尝试解析错误响应
-                try {
-                    auto errJson = nlohmann::json::parse(responseData);
-                    if (errJson.contains("error") && errJson["error"].contains("message")) {
-                        result.errorMessage = errJson["error"]["message"].get<std::string>();
-                    } else {
-                        result.errorMessage = "HTTP " + std::to_string(httpCode);
-                    }
-                } catch (...) {
-                    result.errorMessage = "HTTP " + std::to_string(httpCode) + ": " + responseData.substr(0, 100);
-                }
-                
-                Logger::getInstance().warning("Translation HTTP error: " + result.errorMessage);
-                
-                // 判断是否为可重试错误
-                bool isRetryable = (httpCode == 429 || httpCode >= 500);
-                
-                if (isRetryable && attempt < maxRetries) {
-                    int waitSeconds = (1 << attempt) * 2;
-                    Logger::getInstance().info("Waiting " + std::to_string(waitSeconds) + 
-                                             " seconds before retry...");
-                    std::this_thread::sleep_for(std::chrono::seconds(waitSeconds));
-                    continue;
+            } else {
+                handle.recordTransfer();
+                bool retryable = false;
+                if (parseResponse(httpCode, responseData, result, retryable)) {
+                    Logger::getInstance().info("Translation successful for " + context);
+                    return result;
                 }
-                
-                return result;
-            }
-            
-            // 解析响应
-            try {
-                auto responseJson = nlohmann::json::parse(responseData);
-                
-                if (responseJson.contains("choices") && responseJson["choices"].is_array() && 
-                    !responseJson["choices"].empty()) {
-                    auto choice = responseJson["choices"][0];
-                    if (choice.contains("message") && choice["message"].contains("content")) {
-                        result.translatedText = choice["message"]["content"].get<std::string>();
-                        
-                        // MiniMAX: 即使使用reasoning_split，也做兜底清理<think>标签
-                        if (config_.provider == "minimax") {
-                            std::string& text = result.translatedText;
-                            size_t thinkStart = text.find("<think>");
-                            while (thinkStart != std::string::npos) {
-                                size_t thinkEnd = text.find("</think>", thinkStart);
-                                if (thinkEnd != std::string::npos) {
-                                    text.erase(thinkStart, thinkEnd - thinkStart + 8);
-                                } else {
-                                    // 没有闭合标签，删除到末尾
-                                    text.erase(thinkStart);
-                                    break;
-                                }
-                                thinkStart = text.find("<think>");
-                            }
-                            // 去除首尾空白
-                            size_t start = text.find_first_not_of(" \t\n\r");
-                            size_t end = text.find_last_not_of(" \t\n\r");
-                            if (start != std::string::npos && end != std::string::npos) {
-                                text = text.substr(start, end - start + 1);
-                            }
-                        }
-                        
-                        result.success = true;
-                        
-                        Logger::getInstance().info("Translation successful for " + context);
-                        return result;
-                    }
+                if (!retryable) {
+                    return result;
                 }
-                
-                result.errorMessage = "Invalid API response format";
-                Logger::getInstance().warning("Translation response format error: " + responseData.substr(0, 200));
-                
-            } catch (const std::exception& e) {
-                result.errorMessage = "Failed to parse response: " + std::string(e.what());
-                Logger::getInstance().warning(result.errorMessage);
+                backoff = httpCode < 200 || httpCode >= 300;
             }
             
         } catch (const std::exception& e) {
             result.errorMessage = std::string(e.what());
             Logger::getInstance().warning("Translation attempt " + std::to_string(attempt + 1) + 
                                         " exception: " + result.errorMessage);
+        }
             
-            // 如果还有重试机会，等待后重试
-            if (attempt < maxRetries) {
-                int waitSeconds = (1 << attempt) * 2;
-                Logger::getInstance().info("Waiting " + std::to_string(waitSeconds) + 
-                                         " seconds before retry...");
-                std::this_thread::sleep_for(std::chrono::seconds(waitSeconds));
-            }
+        // 如果还有重试机会，等待后重试
+        if (backoff && attempt < maxRetries) {
+            int waitSeconds = retryDelaySeconds(attempt);
+            Logger::getInstance().info("Waiting " + std::to_string(waitSeconds) +
+                                     " seconds before retry...");
+            std::this_thread::sleep_for(std::chrono::seconds(waitSeconds));
         }
     }
     
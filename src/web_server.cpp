@@ -1,10 +1,13 @@
 #include "web_server.h"
+#include "thread_pool.h"
 #include "logger.h"
 #include "task_queue.h"
 #include "config_manager.h"
 #include "html_parser.h"
 #include "exporter.h"
+#include "translation_cache.h"
 #include "nlohmann/json.hpp"
+#include <zlib.h>
 #ifdef EMBED_RESOURCES
 #include "embedded_resources.h"
 #endif
@@ -21,16 +24,34 @@
     #define platform_close_socket closesocket
     #define platform_read(fd, buf, len) recv(fd, (char*)(buf), len, 0)
     #define platform_write(fd, buf, len) send(fd, (const char*)(buf), (int)(len), 0)
+    #include <io.h>
+    #include <fcntl.h>
+    #define platform_open_file(path) _open(path, _O_RDONLY | _O_BINARY)
+    #define platform_read_file _read
+    #define platform_close_file _close
 #else
     #include <sys/socket.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/sendfile.h>
+    #include <sys/uio.h>
+    #include <sys/ioctl.h>
+    #include <linux/sockios.h>
     #include <netinet/in.h>
+    #include <netinet/tcp.h>
     #include <unistd.h>
+    #include <fcntl.h>
+    #include <errno.h>
+    #include <signal.h>
     typedef int socket_t;
     #define INVALID_SOCKET (-1)
     #define SOCKET_ERROR (-1)
     #define platform_close_socket close
     #define platform_read read
     #define platform_write write
+    #define platform_open_file(path) open(path, O_RDONLY | O_CLOEXEC)
+    #define platform_read_file read
+    #define platform_close_file close
 #endif
 
 #include <cstring>
@@ -42,6 +63,7 @@
 #include <vector>
 #include <chrono>
 #include <iomanip>
+#include <deque>
 
 #ifndef _WIN32
 #include <dirent.h>
@@ -49,13 +71,475 @@
 
 using json = nlohmann::json;
 
-WebServer::WebServer(int port) : port_(port), serverSocket_(-1), running_(false), webRoot_("web") {
+// I/O 线程数量（epoll 实例数），连接按轮询方式分配到各个 I/O 线程
+static const size_t IO_THREAD_COUNT = 2;
+
+// 请求头最大长度
+static const size_t MAX_HEADER_SIZE = 65536;
+
+// 路由匹配支持的最大路径段数
+static const size_t MAX_ROUTE_SEGMENTS = 32;
+
+// 服务器繁忙时建议客户端的重试间隔（秒）
+static const int RETRY_AFTER_SECONDS = 2;
+
+// 持久连接空闲超时时间（秒）
+static const int KEEP_ALIVE_TIMEOUT_SECONDS = 15;
+
+// 单个持久连接上允许处理的最大请求数
+static const size_t MAX_REQUESTS_PER_CONNECTION = 100;
+
+// 流式请求体每次交给接收端的数据块大小
+static const size_t STREAM_CHUNK_SIZE = 65536;
+
+// 分块响应每块包含的文献数
+static const size_t STREAM_RECORDS_PER_CHUNK = 50;
+
+// 任务事件的合并周期（毫秒）：周期内同一任务的多次变化只推送最新状态
+static const int EVENT_COALESCE_MS = 250;
+
+// 事件流无事件时的心跳间隔（秒）
+static const int EVENT_HEARTBEAT_SECONDS = 15;
+
+// 事件流客户端允许积压的未发送数据上限，超过时断开由客户端重连
+static const size_t EVENT_BACKLOG_LIMIT = 1024 * 1024;
+
+// 待发送的响应数据块：自有字符串、静态数据或文件
+struct OutputChunk {
+    std::string data;
+    const char* external = nullptr;      // 非自有的静态数据（如嵌入式资源、内存映射文件）
+    std::shared_ptr<const void> owner;   // 持有 external 指向的数据
+    std::shared_ptr<ResponseFile> file;  // 文件数据，使用 sendfile 发送
+    size_t size = 0;
+    size_t offset = 0;                   // 已发送的字节数
+    
+    const char* bytes() const { return external ? external : data.data(); }
+};
+
+// 单个连接的状态，由所属 I/O 线程和处理该连接请求的工作线程共享
+struct Connection {
+    socket_t fd;
+    size_t loopIndex;
+    std::mutex mutex;
+    std::string inBuf;             // 已读取但尚未处理的请求数据
+    std::deque<OutputChunk> outQueue;  // 待发送的响应数据
+    bool busy = false;             // 请求正在工作线程中处理
+    bool closeAfterWrite = false;  // 响应发送完毕后关闭连接
+    bool readClosed = false;       // 对端已关闭写方向
+    bool invalid = false;          // 请求不合法，需要直接关闭连接
+    bool closed = false;
+    bool admitted = false;         // 当前请求已通过准入检查并占用了路由类别的并发名额
+    RouteClass routeClass = RouteClass::Static;
+    size_t requestCount = 0;       // 已在该连接上处理的请求数
+    std::shared_ptr<HttpRequest> streamRequest;  // 正在接收请求体的流式请求，请求体直接交给其 bodySink
+    size_t streamRemaining = 0;    // 流式请求体尚未接收的字节数
+    ResponseProducer producer;     // 正在发送的分块响应的生成器
+    bool producing = false;        // 有工作线程正在为该连接生成响应数据
+    int unsentBytes = 0;           // 上次检查时内核发送队列中尚未发出的字节数
+    bool eventStream = false;      // 事件流连接，不再处理后续请求
+    std::chrono::steady_clock::time_point lastActive = std::chrono::steady_clock::now();
+};
+
+// 大小写不敏感地查找请求头
+static std::string findHeader(const HttpRequest& request, const std::string& name) {
+    for (const auto& header : request.headers) {
+        if (header.first.size() == name.size() &&
+            std::equal(name.begin(), name.end(), header.first.begin(),
+                       [](char a, char b) { return std::tolower((unsigned char)a) == std::tolower((unsigned char)b); })) {
+            return header.second;
+        }
+    }
+    return "";
+}
+
+// 从请求头中解析 Content-Length
+static size_t parseContentLength(const std::string& data, size_t headerEndPos) {
+    size_t contentLength = 0;
+    std::string headers = data.substr(0, headerEndPos + 4);
+    size_t clPos = headers.find("Content-Length:");
+    if (clPos == std::string::npos) {
+        clPos = headers.find("content-length:");
+    }
+    if (clPos != std::string::npos) {
+        size_t valueStart = clPos + 15; // "Content-Length:" 长度
+        size_t valueEnd = headers.find("\r\n", valueStart);
+        std::string clValue = headers.substr(valueStart, valueEnd - valueStart);
+        // 去除空格
+        clValue.erase(0, clValue.find_first_not_of(" \t"));
+        clValue.erase(clValue.find_last_not_of(" \t\r\n") + 1);
+        try {
+            contentLength = std::stoul(clValue);
+        } catch (...) {
+            contentLength = 0;
+        }
+    }
+    return contentLength;
+}
+
+// 判断客户端是否接受指定的内容编码（Accept-Encoding 中 q=0 表示拒绝）
+static bool acceptsEncoding(const HttpRequest& request, const std::string& encoding) {
+    std::string acceptEncoding = findHeader(request, "Accept-Encoding");
+    std::transform(acceptEncoding.begin(), acceptEncoding.end(), acceptEncoding.begin(), ::tolower);
+    
+    size_t pos = 0;
+    while (pos < acceptEncoding.size()) {
+        size_t end = acceptEncoding.find(',', pos);
+        if (end == std::string::npos) {
+            end = acceptEncoding.size();
+        }
+        std::string token = acceptEncoding.substr(pos, end - pos);
+        pos = end + 1;
+        
+        size_t paramPos = token.find(';');
+        std::string name = token.substr(0, paramPos);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (name != encoding && name != "*") {
+            continue;
+        }
+        
+        if (paramPos != std::string::npos) {
+            size_t qPos = token.find("q=", paramPos);
+            if (qPos != std::string::npos && std::atof(token.c_str() + qPos + 2) <= 0.0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+// FNV-1a 64 位哈希，用于生成 ETag
+static uint64_t fnv1a64(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static std::string formatEtag(uint64_t hash) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "\"%016llx\"", static_cast<unsigned long long>(hash));
+    return buf;
+}
+
+// 判断 If-None-Match 是否与 ETag 匹配（支持多个值、弱校验前缀和 *）
+static bool etagMatches(const std::string& ifNoneMatch, const std::string& etag) {
+    if (ifNoneMatch.empty()) {
+        return false;
+    }
+    size_t pos = 0;
+    while (pos < ifNoneMatch.size()) {
+        size_t end = ifNoneMatch.find(',', pos);
+        if (end == std::string::npos) {
+            end = ifNoneMatch.size();
+        }
+        std::string candidate = ifNoneMatch.substr(pos, end - pos);
+        candidate.erase(0, candidate.find_first_not_of(" \t"));
+        candidate.erase(candidate.find_last_not_of(" \t") + 1);
+        if (candidate.compare(0, 2, "W/") == 0) {
+            candidate = candidate.substr(2);
+        }
+        if (candidate == "*" || candidate == etag) {
+            return true;
+        }
+        pos = end + 1;
+    }
+    return false;
+}
+
+static const char* routeClassName(RouteClass routeClass) {
+    switch (routeClass) {
+        case RouteClass::Static: return "static";
+        case RouteClass::Api: return "api";
+        case RouteClass::Upload: return "upload";
+        case RouteClass::Export: return "export";
+        default: break;
+    }
+    return "unknown";
+}
+
+// 按 Accept-Encoding 选择动态压缩的编码，优先 gzip；客户端都不接受时返回 nullptr
+static const char* negotiateEncoding(const HttpRequest& request) {
+    if (acceptsEncoding(request, "gzip")) {
+        return "gzip";
+    }
+    if (acceptsEncoding(request, "deflate")) {
+        return "deflate";
+    }
+    return nullptr;
+}
+
+// 只压缩文本类响应（JSON、HTML、CSV 等），事件流需要逐条送达，不压缩
+static bool isCompressibleType(const std::string& contentType) {
+    if (contentType.compare(0, 17, "text/event-stream") == 0) {
+        return false;
+    }
+    return contentType.compare(0, 5, "text/") == 0 ||
+           contentType.compare(0, 16, "application/json") == 0 ||
+           contentType.compare(0, 22, "application/javascript") == 0;
+}
+
+// 响应体的流式压缩器（zlib），gzip 或 deflate（zlib 封装）格式
+class ResponseCompressor {
+public:
+    ResponseCompressor() : initialized_(false) {
+        memset(&stream_, 0, sizeof(stream_));
+    }
+    
+    ~ResponseCompressor() {
+        if (initialized_) {
+            deflateEnd(&stream_);
+        }
+    }
+    
+    bool init(bool gzip, int level) {
+        int windowBits = gzip ? MAX_WBITS + 16 : MAX_WBITS;
+        initialized_ = deflateInit2(&stream_, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+        return initialized_;
+    }
+    
+    // 压缩一块数据并追加到 out；finish 为 true 时结束压缩流。
+    // 未结束时压缩数据可能暂留在 zlib 内部，out 不一定有新增内容
+    bool compress(const char* data, size_t size, std::string& out, bool finish) {
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream_.avail_in = static_cast<uInt>(size);
+        int flush = finish ? Z_FINISH : Z_NO_FLUSH;
+        size_t step = std::max<size_t>(16384, deflateBound(&stream_, static_cast<uLong>(size)));
+        
+        while (true) {
+            size_t oldSize = out.size();
+            out.resize(oldSize + step);
+            stream_.next_out = reinterpret_cast<Bytef*>(&out[oldSize]);
+            stream_.avail_out = static_cast<uInt>(step);
+            int ret = deflate(&stream_, flush);
+            out.resize(oldSize + step - stream_.avail_out);
+            if (ret == Z_STREAM_ERROR) {
+                return false;
+            }
+            if (finish ? ret == Z_STREAM_END : stream_.avail_out != 0) {
+                return true;
+            }
+        }
+    }
+
+private:
+    ResponseCompressor(const ResponseCompressor&) = delete;
+    ResponseCompressor& operator=(const ResponseCompressor&) = delete;
+    
+    z_stream stream_;
+    bool initialized_;
+};
+
+// 上传 WoS 导出文件：I/O 线程只把收到的数据块排队，由工作线程池打开上传暂存区的文件、写入数据、
+// 计算哈希并校验格式；请求体接收完整后处理器调用 finish() 写完剩余数据。
+// 磁盘较慢时排队的数据最多为一个请求体（受请求体大小上限约束）
+class HtmlUploadSink : public RequestBodySink, public std::enable_shared_from_this<HtmlUploadSink> {
+public:
+    explicit HtmlUploadSink(ThreadPool& pool) : pool_(pool), opened_(false), draining_(false), errorStatus_(400) {}
+    
+    bool write(const char* data, size_t size) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_.empty()) {
+            return false;  // 之前的数据块校验或写入失败
+        }
+        chunks_.emplace_back(data, size);
+        if (!draining_) {
+            // 线程池队列已满时数据留在队列中，由下一块数据或 finish() 写入
+            std::shared_ptr<HtmlUploadSink> self = shared_from_this();
+            draining_ = pool_.submit([self]() { self->drain(); });
+        }
+        return true;
+    }
+    
+    std::string error() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return error_;
+    }
+    
+    int errorStatus() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return errorStatus_;
+    }
+    
+    // 等待工作线程写完已排队的数据并写入剩余数据（在处理器所在的线程中），失败时返回 false
+    bool finish() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idleCv_.wait(lock, [this] { return !draining_; });
+        draining_ = true;
+        lock.unlock();
+        drain();
+        return error().empty();
+    }
+    
+    // finish() 之后访问
+    UploadWriter& writer() { return writer_; }
+    const HTMLStreamValidator& validator() const { return validator_; }
+
+private:
+    void drain() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!chunks_.empty() && error_.empty()) {
+            std::deque<std::string> chunks;
+            chunks.swap(chunks_);
+            lock.unlock();
+            
+            int status = 400;
+            std::string failure;
+            for (const auto& chunk : chunks) {
+                if (!writeChunk(chunk, failure, status)) {
+                    break;
+                }
+            }
+            
+            lock.lock();
+            if (!failure.empty()) {
+                error_ = failure;
+                errorStatus_ = status;
+            }
+        }
+        chunks_.clear();
+        draining_ = false;
+        idleCv_.notify_all();
+    }
+    
+    bool writeChunk(const std::string& chunk, std::string& failure, int& status) {
+        if (!opened_) {
+            opened_ = true;
+            if (!writer_.open()) {
+                failure = "无法创建上传文件";
+                status = 500;
+                return false;
+            }
+        }
+        validator_.feed(chunk.data(), chunk.size());
+        if (validator_.hasBinaryContent()) {
+            failure = "文件包含二进制内容，不是有效的HTML文件";
+            return false;
+        }
+        if (!writer_.write(chunk.data(), chunk.size())) {
+            failure = "写入上传文件失败";
+            return false;
+        }
+        return true;
+    }
+    
+    ThreadPool& pool_;
+    
+    // 以下成员只由正在写入的线程访问（draining_ 保证同一时间只有一个）
+    UploadWriter writer_;
+    HTMLStreamValidator validator_;
+    bool opened_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable idleCv_;
+    std::deque<std::string> chunks_;
+    bool draining_;  // 有线程正在写入或写入任务已提交
+    std::string error_;
+    int errorStatus_;
+};
+
+static json taskInfoToJson(const TaskInfo& task) {
+    json taskJson;
+    taskJson["taskId"] = task.taskId;
+    taskJson["taskName"] = task.taskName;
+    taskJson["fileName"] = task.fileName;
+    taskJson["modelName"] = task.modelName;
+    taskJson["modelCount"] = task.modelCount;
+    taskJson["status"] = static_cast<int>(task.status);
+    taskJson["totalCount"] = task.totalCount;
+    taskJson["completedCount"] = task.completedCount;
+    taskJson["failedCount"] = task.failedCount;
+    taskJson["createdAt"] = task.createdAt;
+    taskJson["updatedAt"] = task.updatedAt;
+    return taskJson;
+}
+
+static json literatureToJson(const LiteratureData& lit) {
+    json litJson;
+    litJson["index"] = lit.index;
+    litJson["recordNumber"] = lit.recordNumber;
+    litJson["totalRecords"] = lit.totalRecords;
+    litJson["sourceFileName"] = lit.sourceFileName;
+    litJson["sourceFileIndex"] = lit.sourceFileIndex;
+    litJson["indexInFile"] = lit.indexInFile;
+    litJson["originalTitle"] = lit.originalTitle;
+    litJson["originalAbstract"] = lit.originalAbstract;
+    litJson["translatedTitle"] = lit.translatedTitle;
+    litJson["translatedAbstract"] = lit.translatedAbstract;
+    litJson["authors"] = lit.authors;
+    litJson["source"] = lit.source;
+    litJson["volume"] = lit.volume;
+    litJson["issue"] = lit.issue;
+    litJson["pages"] = lit.pages;
+    litJson["doi"] = lit.doi;
+    litJson["earlyAccessDate"] = lit.earlyAccessDate;
+    litJson["publishedDate"] = lit.publishedDate;
+    litJson["accessionNumber"] = lit.accessionNumber;
+    litJson["issn"] = lit.issn;
+    litJson["eissn"] = lit.eissn;
+    litJson["status"] = lit.status;
+    litJson["errorMessage"] = lit.errorMessage;
+    litJson["translatedByModel"] = lit.translatedByModel;
+    return litJson;
+}
+
+#ifndef _WIN32
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) {
+        return false;
+    }
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// 按 chunked 编码排队一块数据：长度行 + 数据 + CRLF，数据本身不复制
+static void queueChunk(std::deque<OutputChunk>& outQueue, std::string data) {
+    char sizeLine[24];
+    int length = snprintf(sizeLine, sizeof(sizeLine), "%zx\r\n", data.size());
+    
+    OutputChunk prefix;
+    prefix.data.assign(sizeLine, length);
+    prefix.size = prefix.data.size();
+    outQueue.push_back(std::move(prefix));
+    
+    OutputChunk body;
+    body.data = std::move(data);
+    body.size = body.data.size();
+    outQueue.push_back(std::move(body));
+    
+    OutputChunk suffix;
+    suffix.external = "\r\n";
+    suffix.size = 2;
+    outQueue.push_back(std::move(suffix));
+}
+
+static size_t queuedBytes(const std::deque<OutputChunk>& outQueue) {
+    size_t total = 0;
+    for (const auto& chunk : outQueue) {
+        total += chunk.size - chunk.offset;
+    }
+    return total;
+}
+#endif
+
+WebServer::WebServer(int port)
+    : port_(port), serverSocket_(-1), running_(false), webRoot_("web"), nextLoop_(0),
+      maxRequestBodyBytes_(0), compressionLevel_(0), compressionMinBytes_(0), taskListenerId_(0) {
 }
 
 WebServer::~WebServer() {
     stop();
 }
 
+ResponseFile::~ResponseFile() {
+    if (fd >= 0) {
+        platform_close_file(fd);
+    }
+}
+
 void WebServer::start() {
     if (running_) {
         return;
@@ -64,9 +548,37 @@ void WebServer::start() {
     // 注册默认路由
     registerDefaultRoutes();
     
+    // 路由处理在固定大小的工作线程池中执行，I/O 线程只负责收发数据
+    const SystemConfig& config = ConfigManager::getInstance().getSystemConfig();
+    size_t workerCount = config.httpWorkerThreads > 0
+        ? static_cast<size_t>(config.httpWorkerThreads)
+        : std::max<size_t>(4, std::thread::hardware_concurrency());
+    size_t maxPending = static_cast<size_t>(std::max(0, config.httpMaxPendingRequests));
+    workerPool_.reset(new ThreadPool(workerCount, maxPending));
+    applyHttpLimits(config);
+    
     running_ = true;
     serverThread_ = std::thread(&WebServer::run, this);
-    Logger::getInstance().info("WebServer started on port " + std::to_string(port_));
+#ifndef _WIN32
+    // 任务变化先按任务合并，由推送线程定期发送给事件流客户端
+    taskListenerId_ = TaskQueue::getInstance().addTaskListener([this](const TaskInfo& task) {
+        {
+            std::lock_guard<std::mutex> lock(eventMutex_);
+            if (eventClients_.empty()) {
+                return;
+            }
+        }
+        json data = taskInfoToJson(task);
+        data["deleted"] = task.deleted;
+        std::string payload = data.dump();
+        
+        std::lock_guard<std::mutex> lock(eventMutex_);
+        pendingEvents_[task.taskId] = std::move(payload);
+    });
+    eventThread_ = std::thread(&WebServer::eventLoop, this);
+#endif
+    Logger::getInstance().info("WebServer started on port " + std::to_string(port_) +
+                               " (" + std::to_string(workerCount) + " worker threads)");
 }
 
 void WebServer::stop() {
@@ -82,61 +594,227 @@ void WebServer::stop() {
         serverSocket_ = INVALID_SOCKET;
     }
 #else
-    if (serverSocket_ >= 0) {
-        platform_close_socket(serverSocket_);
-        serverSocket_ = -1;
+    // 唤醒所有 I/O 线程使其退出事件循环
+    for (auto& loop : ioLoops_) {
+        if (loop->wakeFd >= 0) {
+            uint64_t one = 1;
+            ssize_t ignored = write(loop->wakeFd, &one, sizeof(one));
+            (void)ignored;
+        }
     }
 #endif
     
     if (serverThread_.joinable()) {
         serverThread_.join();
     }
+
+#ifndef _WIN32
+    TaskQueue::getInstance().removeTaskListener(taskListenerId_);
+    eventCv_.notify_all();
+    if (eventThread_.joinable()) {
+        eventThread_.join();
+    }
+#endif
+    
+    if (workerPool_) {
+        workerPool_->shutdown();
+    }
     
     Logger::getInstance().info("WebServer stopped");
 }
 
 void WebServer::registerRoute(const std::string& method, 
                               const std::string& path,
-                              RouteHandler handler) {
-    routes_[method][path] = handler;
+                              RouteHandler handler,
+                              RouteClass routeClass) {
+    RouteNode* node = insertRoute(method, path);
+    node->handler = handler;
+    node->routeClass = routeClass;
+}
+
+void WebServer::registerStreamingRoute(const std::string& method,
+                                       const std::string& path,
+                                       BodySinkFactory sinkFactory,
+                                       RouteHandler handler,
+                                       RouteClass routeClass) {
+    RouteNode* node = insertRoute(method, path);
+    node->handler = handler;
+    node->sinkFactory = sinkFactory;
+    node->routeClass = routeClass;
+}
+
+WebServer::RouteNode* WebServer::insertRoute(const std::string& method, const std::string& path) {
+    // 注册时将路由模式编译进前缀树：
+    //   普通段精确匹配；:name 匹配一个或多个路径段（任务ID形如 2024-01-01/0001）；
+    //   :name<int> 只匹配一个纯数字路径段
+    std::unique_ptr<RouteNode>& root = routeTrie_[method];
+    if (!root) {
+        root.reset(new RouteNode());
+    }
+    
+    RouteNode* node = root.get();
+    for (const auto& part : split(path, '/')) {
+        if (part[0] != ':') {
+            auto it = node->children.find(part);
+            if (it == node->children.end()) {
+                it = node->children.emplace(part, std::unique_ptr<RouteNode>(new RouteNode())).first;
+            }
+            node = it->second.get();
+            continue;
+        }
+        
+        std::string paramName = part.substr(1);
+        RouteNode::ParamType paramType = RouteNode::ParamType::Path;
+        size_t typePos = paramName.find('<');
+        if (typePos != std::string::npos) {
+            std::string typeName = paramName.substr(typePos + 1, paramName.size() - typePos - 2);
+            paramName = paramName.substr(0, typePos);
+            if (typeName == "int") {
+                paramType = RouteNode::ParamType::Int;
+            } else {
+                throw std::invalid_argument("Unknown route parameter type: " + path);
+            }
+        }
+        
+        if (!node->paramChild) {
+            node->paramChild.reset(new RouteNode());
+            node->paramName = paramName;
+            node->paramType = paramType;
+        } else if (node->paramName != paramName || node->paramType != paramType) {
+            throw std::invalid_argument("Conflicting route parameter: " + path);
+        }
+        node = node->paramChild.get();
+    }
+    
+    return node;
+}
+
+void WebServer::applyHttpLimits(const SystemConfig& config) {
+    routeLimits_[static_cast<int>(RouteClass::Static)] = config.httpMaxStaticRequests;
+    routeLimits_[static_cast<int>(RouteClass::Api)] = config.httpMaxApiRequests;
+    routeLimits_[static_cast<int>(RouteClass::Upload)] = config.httpMaxUploadRequests;
+    routeLimits_[static_cast<int>(RouteClass::Export)] = config.httpMaxExportRequests;
+    maxRequestBodyBytes_ = static_cast<size_t>(std::max(1, config.httpMaxRequestBodyMB)) * 1024 * 1024;
+    compressionLevel_ = std::min(9, std::max(0, config.httpCompressionLevel));
+    compressionMinBytes_ = static_cast<size_t>(std::max(0, config.httpCompressionMinBytes));
+}
+
+bool WebServer::acquireRouteSlot(RouteClass routeClass) {
+    int index = static_cast<int>(routeClass);
+    int limit = routeLimits_[index].load();
+    int current = routeActive_[index].load();
+    do {
+        // 0 表示不限制
+        if (limit > 0 && current >= limit) {
+            return false;
+        }
+    } while (!routeActive_[index].compare_exchange_weak(current, current + 1));
+    return true;
+}
+
+void WebServer::releaseRouteSlot(RouteClass routeClass) {
+    routeActive_[static_cast<int>(routeClass)].fetch_sub(1);
+}
+
+bool WebServer::admitRequest(Connection& conn, HttpResponse& rejectResponse) {
+    size_t headerEndPos = conn.inBuf.find("\r\n\r\n");
+    
+    // 在接收请求体之前根据请求行确定路由类别，避免为将被拒绝的请求缓存请求体
+    size_t lineEnd = conn.inBuf.find("\r\n");
+    std::string method, target;
+    std::istringstream lineStream(conn.inBuf.substr(0, lineEnd));
+    lineStream >> method >> target;
+    size_t queryPos = target.find('?');
+    if (queryPos != std::string::npos) {
+        target.erase(queryPos);
+    }
+    
+    const RouteNode* node = findRoute(method, target, nullptr);
+    conn.routeClass = node ? node->routeClass : RouteClass::Static;
+    
+    size_t contentLength = parseContentLength(conn.inBuf, headerEndPos);
+    if (contentLength > maxRequestBodyBytes_) {
+        Logger::getInstance().warning("Request body too large: " + method + " " + target);
+        rejectResponse = makeRejectResponse(413);
+        return false;
+    }
+    
+    if (!acquireRouteSlot(conn.routeClass)) {
+        Logger::getInstance().warning(std::string("Too many concurrent ") + routeClassName(conn.routeClass) +
+                                      " requests, rejecting " + method + " " + target);
+        rejectResponse = makeRejectResponse(503);
+        return false;
+    }
+    
+    if (node && node->sinkFactory) {
+        // 流式路由：只解析请求头，请求体在接收过程中交给接收端，不在内存中缓存
+        std::shared_ptr<RequestBodySink> sink;
+        auto request = std::make_shared<HttpRequest>();
+        try {
+            *request = parseRequest(conn.inBuf.substr(0, headerEndPos + 4));
+            sink = node->sinkFactory(*request, rejectResponse);
+        } catch (const std::exception& e) {
+            Logger::getInstance().error("Failed to start streaming request: " + std::string(e.what()));
+            rejectResponse = makeRejectResponse(400, "Invalid request");
+        }
+        if (!sink) {
+            releaseRouteSlot(conn.routeClass);
+            rejectResponse.headers["Connection"] = "close";
+            return false;
+        }
+        request->bodySink = sink;
+        conn.inBuf.erase(0, headerEndPos + 4);
+        conn.streamRequest = request;
+        conn.streamRemaining = contentLength;
+    }
+    
+    conn.admitted = true;
+    return true;
+}
+
+HttpResponse WebServer::makeRejectResponse(int statusCode, const std::string& message) {
+    HttpResponse response;
+    response.statusCode = statusCode;
+    response.headers["Content-Type"] = "application/json; charset=utf-8";
+    response.headers["Connection"] = "close";
+    
+    json error;
+    error["success"] = false;
+    if (!message.empty()) {
+        error["error"] = message;
+    } else if (statusCode == 413) {
+        error["error"] = "Request body too large";
+    } else {
+        error["error"] = "Server busy, please retry later";
+        response.headers["Retry-After"] = std::to_string(RETRY_AFTER_SECONDS);
+    }
+    response.body = error.dump();
+    return response;
 }
 
 void WebServer::serveStatic(const std::string& webRoot) {
     webRoot_ = webRoot;
 }
 
-void WebServer::run() {
-    // 将在任务8中实现完整的HTTP服务器
-    // 这里是简化的占位符
-    
 #ifdef _WIN32
+
+void WebServer::run() {
     // Windows: 初始化 Winsock
     WSADATA wsaData;
     if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
         Logger::getInstance().error("Failed to initialize Winsock");
         return;
     }
-#endif
     
     serverSocket_ = socket(AF_INET, SOCK_STREAM, 0);
-#ifdef _WIN32
     if (serverSocket_ == INVALID_SOCKET) {
-#else
-    if (serverSocket_ < 0) {
-#endif
         Logger::getInstance().error("Failed to create socket");
-#ifdef _WIN32
         WSACleanup();
-#endif
         return;
     }
     
     int opt = 1;
-#ifdef _WIN32
     setsockopt(serverSocket_, SOL_SOCKET, SO_REUSEADDR, (const char*)&opt, sizeof(opt));
-#else
-    setsockopt(serverSocket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-#endif
     
     struct sockaddr_in address;
     address.sin_family = AF_INET;
@@ -146,23 +824,20 @@ void WebServer::run() {
     if (bind(serverSocket_, (struct sockaddr*)&address, sizeof(address)) < 0) {
         Logger::getInstance().error("Failed to bind socket");
         platform_close_socket(serverSocket_);
-#ifdef _WIN32
         WSACleanup();
-#endif
         return;
     }
     
-    if (listen(serverSocket_, 10) < 0) {
+    if (listen(serverSocket_, SOMAXCONN) < 0) {
         Logger::getInstance().error("Failed to listen on socket");
         platform_close_socket(serverSocket_);
-#ifdef _WIN32
         WSACleanup();
-#endif
         return;
     }
     
     Logger::getInstance().info("Server listening on port " + std::to_string(port_));
     
+    // Windows 没有 epoll，退化为阻塞 accept + 工作线程池处理
     while (running_) {
         struct sockaddr_in clientAddr;
         socklen_t clientLen = sizeof(clientAddr);
@@ -172,135 +847,961 @@ void WebServer::run() {
             if (running_) {
                 Logger::getInstance().warning("Failed to accept connection");
             }
-            continue;
+            continue;
+        }
+        
+        if (!workerPool_->submit([this, clientSocket]() { handleClient(clientSocket); })) {
+            platform_close_socket(clientSocket);
+        }
+    }
+}
+
+void WebServer::handleClient(int clientSocket) {
+    // 首先读取请求头（最多64KB应该足够）
+    char buffer[4096];
+    
+    Connection conn;
+    conn.fd = clientSocket;
+    conn.loopIndex = 0;
+    
+    // 读取请求的超时由接收超时实现
+    DWORD timeout = KEEP_ALIVE_TIMEOUT_SECONDS * 1000;
+    setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+    
+    // 阻塞模式下连接在整个生命周期内占用一个工作线程，保持连接会让空闲的浏览器连接耗尽线程池，
+    // 因此每个连接只处理一个请求，响应后关闭（Connection: close）
+    PendingRequest pending;
+    HttpResponse rejectResponse;
+    RequestState state;
+    while ((state = takeRequest(conn, pending, rejectResponse)) == RequestState::Incomplete) {
+        if (conn.invalid) {
+            platform_close_socket(clientSocket);
+            return;
+        }
+        int bytesRead = recv(clientSocket, buffer, sizeof(buffer), 0);
+        if (bytesRead <= 0) {
+            if (conn.admitted) {
+                releaseRouteSlot(conn.routeClass);
+            }
+            platform_close_socket(clientSocket);
+            return;
+        }
+        conn.inBuf.append(buffer, bytesRead);
+    }
+    if (state == RequestState::Rejected) {
+        sendResponse(clientSocket, rejectResponse);
+        platform_close_socket(clientSocket);
+        return;
+    }
+    
+    conn.requestCount++;
+    HttpRequest request = pending.streamed ? std::move(*pending.streamed) : parseRequest(pending.raw);
+    HttpResponse response = routeRequest(request);
+    releaseRouteSlot(pending.routeClass);
+    response.headers["Connection"] = "close";
+    applyKeepAlive(request, response, conn.requestCount);
+    sendResponse(clientSocket, response);
+    
+    platform_close_socket(clientSocket);
+}
+
+void WebServer::sendResponse(int clientSocket, const HttpResponse& response) {
+    std::string header = buildResponseHeader(response);
+    send(clientSocket, header.c_str(), (int)header.length(), 0);
+    
+    if (response.producer) {
+        // 分块响应：逐块生成并发送
+        std::string chunk;
+        bool more = true;
+        while (more) {
+            chunk.clear();
+            more = response.producer(chunk);
+            if (!chunk.empty()) {
+                char sizeLine[24];
+                int length = snprintf(sizeLine, sizeof(sizeLine), "%zx\r\n", chunk.size());
+                if (send(clientSocket, sizeLine, length, 0) <= 0 ||
+                    send(clientSocket, chunk.c_str(), (int)chunk.size(), 0) <= 0 ||
+                    send(clientSocket, "\r\n", 2, 0) <= 0) {
+                    return;
+                }
+            }
+        }
+        send(clientSocket, "0\r\n\r\n", 5, 0);
+    } else if (response.file) {
+        char buffer[65536];
+        size_t remaining = response.file->size;
+        while (remaining > 0) {
+            int bytesRead = platform_read_file(response.file->fd, buffer,
+                                               (unsigned int)std::min(remaining, sizeof(buffer)));
+            if (bytesRead <= 0 || send(clientSocket, buffer, bytesRead, 0) <= 0) {
+                break;
+            }
+            remaining -= bytesRead;
+        }
+    } else if (response.staticBody) {
+        send(clientSocket, response.staticBody, (int)response.staticBodySize, 0);
+    } else if (!response.body.empty()) {
+        send(clientSocket, response.body.c_str(), (int)response.body.length(), 0);
+    }
+}
+
+#else
+
+void WebServer::run() {
+    // sendfile 向已关闭的连接写入时会触发 SIGPIPE
+    signal(SIGPIPE, SIG_IGN);
+    
+    serverSocket_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (serverSocket_ < 0) {
+        Logger::getInstance().error("Failed to create socket");
+        return;
+    }
+    
+    int opt = 1;
+    setsockopt(serverSocket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    
+    struct sockaddr_in address;
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port_);
+    
+    if (bind(serverSocket_, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        Logger::getInstance().error("Failed to bind socket");
+        platform_close_socket(serverSocket_);
+        serverSocket_ = -1;
+        return;
+    }
+    
+    if (listen(serverSocket_, SOMAXCONN) < 0 || !setNonBlocking(serverSocket_)) {
+        Logger::getInstance().error("Failed to listen on socket");
+        platform_close_socket(serverSocket_);
+        serverSocket_ = -1;
+        return;
+    }
+    
+    // 创建 I/O 事件循环
+    for (size_t i = 0; i < IO_THREAD_COUNT; i++) {
+        std::unique_ptr<IoLoop> loop(new IoLoop());
+        loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        loop->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (loop->epollFd < 0 || loop->wakeFd < 0) {
+            Logger::getInstance().error("Failed to create epoll instance");
+            if (loop->epollFd >= 0) close(loop->epollFd);
+            if (loop->wakeFd >= 0) close(loop->wakeFd);
+            break;
+        }
+        
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = loop->wakeFd;
+        epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->wakeFd, &ev);
+        ioLoops_.push_back(std::move(loop));
+    }
+    
+    if (ioLoops_.empty()) {
+        platform_close_socket(serverSocket_);
+        serverSocket_ = -1;
+        return;
+    }
+    
+    // 监听 socket 由第一个 I/O 线程负责
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.fd = serverSocket_;
+    epoll_ctl(ioLoops_[0]->epollFd, EPOLL_CTL_ADD, serverSocket_, &ev);
+    
+    Logger::getInstance().info("Server listening on port " + std::to_string(port_) +
+                               " (" + std::to_string(ioLoops_.size()) + " I/O threads)");
+    
+    for (size_t i = 1; i < ioLoops_.size(); i++) {
+        ioThreads_.emplace_back(&WebServer::ioLoop, this, i);
+    }
+    ioLoop(0);
+    
+    for (auto& thread : ioThreads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    ioThreads_.clear();
+    
+    // 关闭所有剩余连接
+    for (auto& loop : ioLoops_) {
+        std::vector<std::shared_ptr<Connection>> remaining;
+        {
+            std::lock_guard<std::mutex> lock(loop->mutex);
+            for (auto& pair : loop->connections) {
+                remaining.push_back(pair.second);
+            }
+        }
+        for (auto& conn : remaining) {
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            closeConnection(*conn);
+        }
+        close(loop->wakeFd);
+        close(loop->epollFd);
+    }
+    ioLoops_.clear();
+    
+    platform_close_socket(serverSocket_);
+    serverSocket_ = -1;
+}
+
+void WebServer::ioLoop(size_t loopIndex) {
+    IoLoop& loop = *ioLoops_[loopIndex];
+    const int maxEvents = 128;
+    struct epoll_event events[maxEvents];
+    auto lastSweep = std::chrono::steady_clock::now();
+    
+    while (running_) {
+        int n = epoll_wait(loop.epollFd, events, maxEvents, 1000);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            Logger::getInstance().error("epoll_wait failed: " + std::string(strerror(errno)));
+            break;
+        }
+        
+        // 每秒清理一次空闲的持久连接
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSweep >= std::chrono::seconds(1)) {
+            lastSweep = now;
+            closeIdleConnections(loop);
+        }
+        
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            uint32_t flags = events[i].events;
+            
+            if (fd == loop.wakeFd) {
+                uint64_t value;
+                ssize_t ignored = read(loop.wakeFd, &value, sizeof(value));
+                (void)ignored;
+                continue;
+            }
+            
+            if (fd == serverSocket_) {
+                acceptConnections();
+                continue;
+            }
+            
+            std::shared_ptr<Connection> conn;
+            {
+                std::lock_guard<std::mutex> lock(loop.mutex);
+                auto it = loop.connections.find(fd);
+                if (it == loop.connections.end()) continue;
+                conn = it->second;
+            }
+            
+            if (flags & (EPOLLERR | EPOLLHUP)) {
+                std::lock_guard<std::mutex> lock(conn->mutex);
+                closeConnection(*conn);
+                continue;
+            }
+            
+            if (flags & EPOLLIN) {
+                handleReadable(conn);
+            }
+            
+            if (flags & EPOLLOUT) {
+                std::lock_guard<std::mutex> lock(conn->mutex);
+                if (!conn->closed && flushConnection(*conn)) {
+                    conn->lastActive = std::chrono::steady_clock::now();
+                    if (conn->producer && !conn->producing) {
+                        // 已发送完的分块响应继续生成下一块
+                        resumeProducer(conn);
+                    } else if (conn->closeAfterWrite && !conn->busy) {
+                        closeConnection(*conn);
+                    } else if (!conn->busy) {
+                        scheduleNextRequest(conn);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void WebServer::acceptConnections() {
+    // 边缘触发：一次性接受所有挂起的连接
+    while (running_) {
+        struct sockaddr_in clientAddr;
+        socklen_t clientLen = sizeof(clientAddr);
+        int clientSocket = accept4(serverSocket_, (struct sockaddr*)&clientAddr, &clientLen,
+                                   SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientSocket < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                Logger::getInstance().warning("Failed to accept connection: " + std::string(strerror(errno)));
+            }
+            return;
+        }
+        
+        int opt = 1;
+        setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+        
+        auto conn = std::make_shared<Connection>();
+        conn->fd = clientSocket;
+        conn->loopIndex = nextLoop_.fetch_add(1) % ioLoops_.size();
+        
+        IoLoop& loop = *ioLoops_[conn->loopIndex];
+        {
+            std::lock_guard<std::mutex> lock(loop.mutex);
+            loop.connections[clientSocket] = conn;
+        }
+        
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = clientSocket;
+        if (epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, clientSocket, &ev) < 0) {
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            closeConnection(*conn);
+        }
+    }
+}
+
+void WebServer::handleReadable(const std::shared_ptr<Connection>& conn) {
+    std::lock_guard<std::mutex> lock(conn->mutex);
+    if (conn->closed) {
+        return;
+    }
+    
+    // 边缘触发：读取直到 EAGAIN
+    char buffer[16384];
+    while (true) {
+        ssize_t bytesRead = read(conn->fd, buffer, sizeof(buffer));
+        if (bytesRead > 0) {
+            // 已决定关闭的连接不再缓存后续数据（例如被拒绝请求的请求体）
+            if (!conn->closeAfterWrite) {
+                conn->inBuf.append(buffer, bytesRead);
+                // 流式请求体按块交给接收端，不在缓冲区中堆积
+                if (conn->streamRequest && !conn->busy && conn->inBuf.size() >= STREAM_CHUNK_SIZE) {
+                    scheduleNextRequest(conn);
+                    if (conn->closed) {
+                        return;
+                    }
+                }
+            }
+            continue;
+        }
+        if (bytesRead == 0) {
+            conn->readClosed = true;
+            break;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        closeConnection(*conn);
+        return;
+    }
+    conn->lastActive = std::chrono::steady_clock::now();
+    
+    if (conn->eventStream) {
+        // 事件流连接上不再有请求，客户端关闭即断开
+        conn->inBuf.clear();
+        if (conn->readClosed) {
+            closeConnection(*conn);
+        }
+        return;
+    }
+    
+    // 同一连接上的请求按顺序逐个处理，流水线请求在前一个响应写出后再调度
+    if (!conn->busy) {
+        scheduleNextRequest(conn);
+    }
+}
+
+void WebServer::scheduleNextRequest(const std::shared_ptr<Connection>& conn) {
+    // 调用者需要持有 conn->mutex
+    if (conn->closed || conn->busy || conn->closeAfterWrite) {
+        return;
+    }
+    
+    PendingRequest pending;
+    HttpResponse rejectResponse;
+    RequestState state = takeRequest(*conn, pending, rejectResponse);
+    if (state == RequestState::Rejected) {
+        rejectRequest(*conn, rejectResponse);
+        return;
+    }
+    
+    if (state == RequestState::Ready) {
+        RouteClass routeClass = pending.routeClass;
+        conn->busy = true;
+        std::shared_ptr<Connection> self = conn;
+        bool submitted = workerPool_->submit([this, self, pending = std::move(pending)]() mutable {
+            dispatchRequest(self, std::move(pending));
+        });
+        if (!submitted) {
+            // 工作线程池等待队列已满
+            releaseRouteSlot(routeClass);
+            conn->busy = false;
+            Logger::getInstance().warning("Worker queue full, rejecting request");
+            HttpResponse busyResponse = makeRejectResponse(503);
+            rejectRequest(*conn, busyResponse);
+        }
+        return;
+    }
+    
+    if (conn->invalid) {
+        closeConnection(*conn);
+    } else if (conn->readClosed && conn->outQueue.empty()) {
+        // 对端已关闭且没有待处理的请求和待发送的数据
+        closeConnection(*conn);
+    }
+}
+
+void WebServer::rejectRequest(Connection& conn, HttpResponse& response) {
+    // 调用者需要持有 conn.mutex；剩余的请求数据不再读取，响应发送后关闭连接
+    conn.inBuf.clear();
+    queueResponse(conn, response);
+    conn.closeAfterWrite = true;
+    if (flushConnection(conn)) {
+        closeConnection(conn);
+    }
+}
+
+void WebServer::closeIdleConnections(IoLoop& loop) {
+    std::vector<std::shared_ptr<Connection>> candidates;
+    {
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        for (auto& pair : loop.connections) {
+            candidates.push_back(pair.second);
+        }
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    auto deadline = now - std::chrono::seconds(KEEP_ALIVE_TIMEOUT_SECONDS);
+    for (auto& conn : candidates) {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        if (conn->closed) {
+            continue;
+        }
+        
+        // 响应仍在发送时以发送进度判断是否空闲：内核发送缓冲区可能容纳数 MB 数据，
+        // 期间不会触发 EPOLLOUT，只要其中未发出的数据在减少就说明对端仍在接收
+        if (!conn->outQueue.empty() || conn->producer) {
+            int unsent = 0;
+            if (ioctl(conn->fd, SIOCOUTQ, &unsent) == 0 && unsent != conn->unsentBytes) {
+                conn->unsentBytes = unsent;
+                conn->lastActive = now;
+            }
+        }
+        
+        if (conn->producer && !conn->producing && conn->outQueue.empty()) {
+            // 暂停中的分块响应此前因工作线程池繁忙未能继续，重试
+            resumeProducer(conn);
+            continue;
+        }
+        bool working = conn->producing || (conn->busy && !conn->producer);
+        if (!working && conn->lastActive < deadline) {
+            closeConnection(*conn);
+        }
+    }
+}
+
+void WebServer::queueResponse(Connection& conn, HttpResponse& response) {
+    // 调用者需要持有 conn.mutex；响应头和响应体分块排队，响应体不做复制
+    OutputChunk header;
+    header.data = buildResponseHeader(response);
+    header.size = header.data.size();
+    conn.outQueue.push_back(std::move(header));
+    
+    if (response.producer) {
+        // 分块响应的响应体由 produceResponseChunks 逐块排队
+        conn.producer = std::move(response.producer);
+        return;
+    }
+    if (response.eventStream) {
+        // 事件流的后续事件由 eventLoop 逐块排队
+        if (!response.body.empty()) {
+            queueChunk(conn.outQueue, std::move(response.body));
+        }
+        return;
+    }
+    
+    OutputChunk body;
+    if (response.file) {
+        body.file = response.file;
+        body.size = response.file->size;
+    } else if (response.staticBody) {
+        body.external = response.staticBody;
+        body.owner = response.staticBodyOwner;
+        body.size = response.staticBodySize;
+    } else {
+        body.data = std::move(response.body);
+        body.size = body.data.size();
+    }
+    if (body.size > 0 && response.statusCode != 304) {
+        conn.outQueue.push_back(std::move(body));
+    }
+}
+
+bool WebServer::flushConnection(Connection& conn) {
+    while (!conn.outQueue.empty()) {
+        OutputChunk& front = conn.outQueue.front();
+        ssize_t written;
+        if (front.file) {
+            off_t fileOffset = static_cast<off_t>(front.offset);
+            written = sendfile(conn.fd, front.file->fd, &fileOffset, front.size - front.offset);
+            if (written == 0) {
+                // 文件在发送过程中被截断
+                closeConnection(conn);
+                return false;
+            }
+        } else {
+            // 连续的内存块合并为一次系统调用发送
+            struct iovec iov[16];
+            size_t iovCount = 0;
+            for (auto it = conn.outQueue.begin(); it != conn.outQueue.end() && iovCount < 16 && !it->file; ++it) {
+                iov[iovCount].iov_base = const_cast<char*>(it->bytes() + it->offset);
+                iov[iovCount].iov_len = it->size - it->offset;
+                iovCount++;
+            }
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = iovCount;
+            written = sendmsg(conn.fd, &msg, MSG_NOSIGNAL);
+        }
+        
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return false;  // 等待 EPOLLOUT 继续发送
+            }
+            closeConnection(conn);
+            return false;
+        }
+        
+        size_t remaining = static_cast<size_t>(written);
+        while (remaining > 0 && !conn.outQueue.empty()) {
+            OutputChunk& chunk = conn.outQueue.front();
+            size_t consumed = std::min(remaining, chunk.size - chunk.offset);
+            chunk.offset += consumed;
+            remaining -= consumed;
+            if (chunk.offset == chunk.size) {
+                conn.outQueue.pop_front();
+            }
+        }
+    }
+    
+    return true;
+}
+
+void WebServer::closeConnection(Connection& conn) {
+    // 调用者需要持有 conn.mutex
+    if (conn.closed) {
+        return;
+    }
+    conn.closed = true;
+    
+    // 请求体未接收完整就断开时归还已占用的并发名额
+    if (conn.admitted) {
+        releaseRouteSlot(conn.routeClass);
+        conn.admitted = false;
+    }
+    conn.streamRequest.reset();
+    
+    if (conn.loopIndex < ioLoops_.size()) {
+        IoLoop& loop = *ioLoops_[conn.loopIndex];
+        epoll_ctl(loop.epollFd, EPOLL_CTL_DEL, conn.fd, nullptr);
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        auto it = loop.connections.find(conn.fd);
+        if (it != loop.connections.end() && it->second.get() == &conn) {
+            loop.connections.erase(it);
+        }
+    }
+    platform_close_socket(conn.fd);
+}
+
+#endif
+
+WebServer::RequestState WebServer::takeRequest(Connection& conn, PendingRequest& pending,
+                                               HttpResponse& rejectResponse) {
+    // 调用者需要持有 conn.mutex
+    // 请求头接收完整后先做准入检查，超出并发限制或请求体过大时直接拒绝
+    if (!conn.admitted && conn.inBuf.find("\r\n\r\n") != std::string::npos) {
+        if (!admitRequest(conn, rejectResponse)) {
+            return RequestState::Rejected;
+        }
+    }
+    
+    if (conn.streamRequest) {
+        size_t length = std::min(conn.inBuf.size(), conn.streamRemaining);
+        if (length > 0) {
+            RequestBodySink& sink = *conn.streamRequest->bodySink;
+            if (!sink.write(conn.inBuf.data(), length)) {
+                Logger::getInstance().warning("Streaming request rejected: " + sink.error());
+                rejectResponse = makeRejectResponse(sink.errorStatus(), sink.error());
+                releaseRouteSlot(conn.routeClass);
+                conn.admitted = false;
+                conn.streamRequest.reset();
+                return RequestState::Rejected;
+            }
+            conn.inBuf.erase(0, length);
+            conn.streamRemaining -= length;
+        }
+        if (conn.streamRemaining > 0) {
+            return RequestState::Incomplete;  // 请求体尚未接收完整
+        }
+        pending.streamed = std::move(conn.streamRequest);
+    } else if (!extractRequest(conn, pending.raw)) {
+        return RequestState::Incomplete;
+    }
+    
+    pending.routeClass = conn.routeClass;
+    conn.admitted = false;
+    return RequestState::Ready;
+}
+
+bool WebServer::extractRequest(Connection& conn, std::string& requestStr) {
+    size_t headerEndPos = conn.inBuf.find("\r\n\r\n");
+    if (headerEndPos == std::string::npos) {
+        // 防止无限增长，限制头部大小
+        if (conn.inBuf.size() > MAX_HEADER_SIZE) {
+            Logger::getInstance().error("Request header too large");
+            conn.invalid = true;
+        }
+        return false;
+    }
+    
+    // 解析Content-Length
+    size_t contentLength = parseContentLength(conn.inBuf, headerEndPos);
+    
+    size_t requestSize = headerEndPos + 4 + contentLength;
+    if (conn.inBuf.size() < requestSize) {
+        return false;  // 请求体尚未接收完整
+    }
+    
+    requestStr = conn.inBuf.substr(0, requestSize);
+    conn.inBuf.erase(0, requestSize);
+    return true;
+}
+    
+#ifndef _WIN32
+void WebServer::dispatchRequest(const std::shared_ptr<Connection>& conn, PendingRequest pending) {
+    size_t requestCount;
+    {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        requestCount = ++conn->requestCount;
+    }
+    
+    HttpResponse response;
+    bool keepAlive = false;
+    try {
+        HttpRequest request = pending.streamed ? std::move(*pending.streamed) : parseRequest(pending.raw);
+        pending.raw.clear();
+        pending.raw.shrink_to_fit();
+    
+        Logger::getInstance().info("Request: " + request.method + " " + request.path + " (body: " + std::to_string(request.body.size()) + " bytes)");
+        
+        response = routeRequest(request);
+        keepAlive = applyKeepAlive(request, response, requestCount);
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Request handling failed: " + std::string(e.what()));
+        response = HttpResponse();
+        response.statusCode = 500;
+        response.headers["Content-Type"] = "application/json; charset=utf-8";
+        response.headers["Connection"] = "close";
+        response.body = json{{"error", "Internal server error"}}.dump();
+    }
+    if (response.producer) {
+        // 分块响应在全部发送（生成器销毁）前继续占用路由类别的并发名额
+        RouteClass routeClass = pending.routeClass;
+        std::shared_ptr<void> slot(nullptr, [this, routeClass](void*) { releaseRouteSlot(routeClass); });
+        response.producer = [producer = std::move(response.producer), slot](std::string& chunk) {
+            return producer(chunk);
+        };
+    } else {
+        releaseRouteSlot(pending.routeClass);
+    }
+    
+    std::unique_lock<std::mutex> lock(conn->mutex);
+    if (conn->closed) {
+        return;
+    }
+    queueResponse(*conn, response);
+    conn->lastActive = std::chrono::steady_clock::now();
+    if (!keepAlive) {
+        conn->closeAfterWrite = true;
+    }
+    
+    if (conn->producer) {
+        // 响应头已排队，由当前工作线程继续生成响应体
+        conn->producing = true;
+        lock.unlock();
+        produceResponseChunks(conn);
+        return;
+    }
+    if (response.eventStream) {
+        // 连接保持 busy，不再调度后续请求，也不会因空闲被关闭
+        conn->eventStream = true;
+        flushConnection(*conn);
+        if (!conn->closed) {
+            addEventClient(conn);
+        }
+        return;
+    }
+    completeResponse(conn);
+}
+
+void WebServer::completeResponse(const std::shared_ptr<Connection>& conn) {
+    // 调用者需要持有 conn->mutex；当前请求的响应已全部排队
+    conn->busy = false;
+    bool flushed = flushConnection(*conn);
+    if (conn->closed) {
+        return;
+    }
+    if (conn->closeAfterWrite) {
+        if (flushed) {
+            closeConnection(*conn);
+        }
+        return;
+    }
+    
+    // 处理已缓冲的流水线请求
+    scheduleNextRequest(conn);
+}
+
+void WebServer::produceResponseChunks(const std::shared_ptr<Connection>& conn) {
+    // 在工作线程中执行，conn->producing 保证同一时刻只有一个线程调用生成器；
+    // 数据未能立即发送完时暂停，由 I/O 线程发送完毕后恢复，待发送数据始终只有一块左右
+    while (true) {
+        std::string chunk;
+        bool more;
+        try {
+            more = conn->producer(chunk);
+        } catch (const std::exception& e) {
+            // 响应头已发出，只能断开连接，客户端据此得知响应不完整
+            Logger::getInstance().error("Streaming response failed: " + std::string(e.what()));
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            conn->producer = nullptr;
+            conn->producing = false;
+            closeConnection(*conn);
+            return;
+        }
+        
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        if (conn->closed) {
+            conn->producer = nullptr;
+            conn->producing = false;
+            return;
+        }
+        if (!chunk.empty()) {
+            queueChunk(conn->outQueue, std::move(chunk));
+        }
+        if (!more) {
+            OutputChunk last;
+            last.external = "0\r\n\r\n";
+            last.size = 5;
+            conn->outQueue.push_back(std::move(last));
+            conn->producer = nullptr;
+            conn->producing = false;
+            completeResponse(conn);
+            return;
+        }
+        if (!flushConnection(*conn)) {
+            // 发送缓冲区已满，等待 EPOLLOUT
+            conn->producing = false;
+            if (conn->closed) {
+                conn->producer = nullptr;
+            }
+            return;
+        }
+    }
+}
+
+void WebServer::resumeProducer(const std::shared_ptr<Connection>& conn) {
+    // 调用者需要持有 conn->mutex
+    conn->producing = true;
+    std::shared_ptr<Connection> self = conn;
+    if (!workerPool_->submit([this, self]() { produceResponseChunks(self); })) {
+        // 工作线程池繁忙，由空闲检查稍后重试
+        conn->producing = false;
+    }
+}
+
+void WebServer::addEventClient(const std::shared_ptr<Connection>& conn) {
+    std::lock_guard<std::mutex> lock(eventMutex_);
+    eventClients_.push_back(conn);
+}
+
+void WebServer::eventLoop() {
+    // 每个周期把合并后的任务变化发送给所有事件流客户端；长时间没有事件时发送注释行作为心跳，
+    // 以便及时发现已断开的客户端，并避免中间代理因空闲关闭连接
+    auto lastSent = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(eventMutex_);
+    while (running_) {
+        eventCv_.wait_for(lock, std::chrono::milliseconds(EVENT_COALESCE_MS));
+        if (!running_) {
+            break;
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        if (eventClients_.empty()) {
+            pendingEvents_.clear();
+            lastSent = now;
+            continue;
+        }
+        if (pendingEvents_.empty() && now - lastSent < std::chrono::seconds(EVENT_HEARTBEAT_SECONDS)) {
+            continue;
+        }
+        
+        std::string payload;
+        for (const auto& pair : pendingEvents_) {
+            payload += "event: task\ndata: " + pair.second + "\n\n";
+        }
+        pendingEvents_.clear();
+        if (payload.empty()) {
+            payload = ": ping\n\n";
+        }
+        lastSent = now;
+        std::vector<std::weak_ptr<Connection>> clients = eventClients_;
+        lock.unlock();
+        
+        for (const auto& client : clients) {
+            std::shared_ptr<Connection> conn = client.lock();
+            if (!conn) {
+                continue;
+            }
+            std::lock_guard<std::mutex> connLock(conn->mutex);
+            if (conn->closed) {
+                continue;
+            }
+            if (queuedBytes(conn->outQueue) > EVENT_BACKLOG_LIMIT) {
+                // 客户端接收过慢，断开后由 EventSource 重连并重新获取快照
+                closeConnection(*conn);
+                continue;
+            }
+            queueChunk(conn->outQueue, payload);
+            if (flushConnection(*conn)) {
+                conn->lastActive = now;
+            }
         }
         
-        // 在新线程中处理客户端请求
-        std::thread(&WebServer::handleClient, this, clientSocket).detach();
+        // 已关闭的连接随 I/O 线程释放，此处移除失效的引用
+        lock.lock();
+        eventClients_.erase(std::remove_if(eventClients_.begin(), eventClients_.end(),
+                                           [](const std::weak_ptr<Connection>& client) {
+                                               return client.expired();
+                                           }),
+                            eventClients_.end());
     }
 }
+#endif
 
-void WebServer::handleClient(int clientSocket) {
-    // 首先读取请求头（最多64KB应该足够）
-    std::string headerData;
-    char buffer[4096];
-    size_t headerEndPos = std::string::npos;
+bool WebServer::applyKeepAlive(const HttpRequest& request, HttpResponse& response, size_t requestCount) {
+    std::string connection = findHeader(request, "Connection");
+    std::transform(connection.begin(), connection.end(), connection.begin(), ::tolower);
+    
+    // HTTP/1.1 默认保持连接，HTTP/1.0 需要显式声明 keep-alive
+    bool keepAlive;
+    if (request.version == "HTTP/1.0") {
+        keepAlive = connection.find("keep-alive") != std::string::npos;
+    } else {
+        keepAlive = connection.find("close") == std::string::npos;
+    }
     
-    // 读取直到找到请求头结束标记 \r\n\r\n
-    while (headerEndPos == std::string::npos) {
-#ifdef _WIN32
-        int bytesRead = recv(clientSocket, buffer, sizeof(buffer), 0);
-#else
-        ssize_t bytesRead = read(clientSocket, buffer, sizeof(buffer));
-#endif
-        if (bytesRead <= 0) {
-            platform_close_socket(clientSocket);
-            return;
-        }
-        headerData.append(buffer, bytesRead);
-        headerEndPos = headerData.find("\r\n\r\n");
-        
-        // 防止无限循环，限制头部大小
-        if (headerData.size() > 65536) {
-            Logger::getInstance().error("Request header too large");
-            platform_close_socket(clientSocket);
-            return;
-        }
+    if (requestCount >= MAX_REQUESTS_PER_CONNECTION) {
+        keepAlive = false;
     }
     
-    // 分离头部和已读取的body部分
-    std::string headers = headerData.substr(0, headerEndPos + 4);
-    std::string partialBody = headerData.substr(headerEndPos + 4);
+    // 处理器显式要求关闭连接时以其为准
+    auto it = response.headers.find("Connection");
+    if (it != response.headers.end() && it->second == "close") {
+        keepAlive = false;
+    }
     
-    // 解析Content-Length
-    size_t contentLength = 0;
-    size_t clPos = headers.find("Content-Length:");
-    if (clPos == std::string::npos) {
-        clPos = headers.find("content-length:");
+    if (keepAlive) {
+        response.headers["Connection"] = "keep-alive";
+        response.headers["Keep-Alive"] = "timeout=" + std::to_string(KEEP_ALIVE_TIMEOUT_SECONDS) +
+                                         ", max=" + std::to_string(MAX_REQUESTS_PER_CONNECTION - requestCount);
+    } else {
+        response.headers["Connection"] = "close";
+        response.headers.erase("Keep-Alive");
     }
-    if (clPos != std::string::npos) {
-        size_t valueStart = clPos + 15; // "Content-Length:" 长度
-        size_t valueEnd = headers.find("\r\n", valueStart);
-        std::string clValue = headers.substr(valueStart, valueEnd - valueStart);
-        // 去除空格
-        clValue.erase(0, clValue.find_first_not_of(" \t"));
-        clValue.erase(clValue.find_last_not_of(" \t\r\n") + 1);
-        contentLength = std::stoul(clValue);
+    return keepAlive;
+}
+
+HttpResponse WebServer::routeRequest(HttpRequest& request) {
+    HttpResponse response;
+    
+    // 尝试匹配路由
+    const RouteNode* route = findRoute(request.method, request.path, &request.params);
+    if (route) {
+        response = route->handler(request);
+    } else {
+        // 如果没有匹配的路由，尝试静态文件服务
+        response = serveStaticFile(request);
     }
     
-    // 读取剩余的body
-    std::string body = partialBody;
-    while (body.size() < contentLength) {
-#ifdef _WIN32
-        int bytesRead = recv(clientSocket, buffer, sizeof(buffer), 0);
-#else
-        ssize_t bytesRead = read(clientSocket, buffer, sizeof(buffer));
-#endif
-        if (bytesRead <= 0) {
-            break;
+    // HTTP/1.0 不支持分块传输，一次性生成完整响应体
+    if (response.producer && request.version == "HTTP/1.0") {
+        std::string chunk;
+        bool more = true;
+        while (more) {
+            chunk.clear();
+            more = response.producer(chunk);
+            response.body += chunk;
         }
-        body.append(buffer, bytesRead);
+        response.producer = nullptr;
     }
     
-    // 构建完整请求字符串
-    std::string requestStr = headers + body;
-    HttpRequest request = parseRequest(requestStr);
+    compressResponse(request, response);
     
-    Logger::getInstance().info("Request: " + request.method + " " + request.path + " (body: " + std::to_string(request.body.size()) + " bytes)");
+    return response;
+}
+
+void WebServer::compressResponse(const HttpRequest& request, HttpResponse& response) {
+    // 静态文件与嵌入式资源走零拷贝/预压缩路径；带 ETag 的响应压缩后需要不同的 ETag，不做处理
+    int level = compressionLevel_;
+    if (level <= 0 || response.statusCode < 200 || response.statusCode == 204 || response.statusCode == 304 ||
+        response.file || response.staticBody || response.eventStream ||
+        response.headers.count("Content-Encoding") || response.headers.count("ETag")) {
+        return;
+    }
+    auto typeIt = response.headers.find("Content-Type");
+    if (typeIt == response.headers.end() || !isCompressibleType(typeIt->second)) {
+        return;
+    }
+    if (!response.producer && response.body.size() < compressionMinBytes_) {
+        return;
+    }
     
-    HttpResponse response;
+    response.headers["Vary"] = "Accept-Encoding";
+    const char* encoding = negotiateEncoding(request);
+    if (!encoding) {
+        return;
+    }
+    bool gzip = strcmp(encoding, "gzip") == 0;
     
-    // 尝试匹配路由
-    bool routeFound = false;
-    auto methodRoutes = routes_.find(request.method);
-    if (methodRoutes != routes_.end()) {
-        auto handler = methodRoutes->second.find(request.path);
-        if (handler != methodRoutes->second.end()) {
-            response = handler->second(request);
-            routeFound = true;
-        } else {
-            // 尝试匹配带参数的路由（如 /api/tasks/:id）
-            // 按模式长度降序排序，让更具体的路由优先匹配
-            std::vector<std::pair<std::string, RouteHandler>> sortedRoutes(
-                methodRoutes->second.begin(), methodRoutes->second.end());
-            std::sort(sortedRoutes.begin(), sortedRoutes.end(),
-                [](const auto& a, const auto& b) {
-                    // 计算固定部分数量（非参数部分）
-                    auto countFixed = [](const std::string& pattern) {
-                        int count = 0;
-                        size_t pos = 0;
-                        while ((pos = pattern.find('/', pos)) != std::string::npos) {
-                            count++;
-                            pos++;
-                        }
-                        return count;
-                    };
-                    return countFixed(a.first) > countFixed(b.first);
-                });
-            
-            for (const auto& route : sortedRoutes) {
-                if (matchRoute(route.first, request.path, request.params)) {
-                    response = route.second(request);
-                    routeFound = true;
-                    break;
-                }
-            }
+    if (response.producer) {
+        // 分块响应逐块压缩后再交给分块编码，不缓存完整响应体
+        auto compressor = std::make_shared<ResponseCompressor>();
+        if (!compressor->init(gzip, level)) {
+            return;
         }
+        response.producer = [producer = std::move(response.producer), compressor](std::string& chunk) {
+            std::string plain;
+            bool more = producer(plain);
+            if (!compressor->compress(plain.data(), plain.size(), chunk, !more)) {
+                throw std::runtime_error("Response compression failed");
+            }
+            return more;
+        };
+        response.headers["Content-Encoding"] = encoding;
+        return;
     }
     
-    // 如果没有匹配的路由，尝试静态文件服务
-    if (!routeFound) {
-        response = serveStaticFile(request.path);
+    ResponseCompressor compressor;
+    std::string compressed;
+    if (!compressor.init(gzip, level) ||
+        !compressor.compress(response.body.data(), response.body.size(), compressed, true)) {
+        Logger::getInstance().warning("Response compression failed for " + request.path);
+        return;
+    }
+    if (compressed.size() < response.body.size()) {
+        response.body = std::move(compressed);
+        response.headers["Content-Encoding"] = encoding;
     }
-    
-    std::string responseStr = buildResponse(response);
-#ifdef _WIN32
-    send(clientSocket, responseStr.c_str(), (int)responseStr.length(), 0);
-#else
-    write(clientSocket, responseStr.c_str(), responseStr.length());
-#endif
-    
-    platform_close_socket(clientSocket);
 }
 
 HttpRequest WebServer::parseRequest(const std::string& requestStr) {
@@ -311,7 +1812,7 @@ HttpRequest WebServer::parseRequest(const std::string& requestStr) {
     // 解析请求行
     if (std::getline(stream, line)) {
         std::istringstream lineStream(line);
-        lineStream >> request.method >> request.path;
+        lineStream >> request.method >> request.path >> request.version;
         
         // 解析查询参数
         size_t queryPos = request.path.find('?');
@@ -341,17 +1842,18 @@ HttpRequest WebServer::parseRequest(const std::string& requestStr) {
         }
     }
     
-    // 解析请求体 - 根据Content-Length读取
+    // 解析请求体 - 根据Content-Length读取（流式路由只传入请求头，此时没有请求体）
     if (contentLength > 0) {
-        std::vector<char> buffer(contentLength);
-        stream.read(buffer.data(), contentLength);
-        request.body = std::string(buffer.begin(), buffer.begin() + stream.gcount());
+        std::streamoff bodyPos = stream.tellg();
+        if (bodyPos >= 0 && static_cast<size_t>(bodyPos) < requestStr.size()) {
+            request.body = requestStr.substr(static_cast<size_t>(bodyPos), contentLength);
+        }
     }
     
     return request;
 }
 
-std::string WebServer::buildResponse(const HttpResponse& response) {
+std::string WebServer::buildResponseHeader(const HttpResponse& response) {
     std::ostringstream oss;
     
     // 状态行
@@ -359,10 +1861,15 @@ std::string WebServer::buildResponse(const HttpResponse& response) {
     switch (response.statusCode) {
         case 200: oss << "OK"; break;
         case 201: oss << "Created"; break;
+        case 206: oss << "Partial Content"; break;
+        case 304: oss << "Not Modified"; break;
         case 400: oss << "Bad Request"; break;
         case 401: oss << "Unauthorized"; break;
         case 404: oss << "Not Found"; break;
+        case 413: oss << "Payload Too Large"; break;
+        case 416: oss << "Range Not Satisfiable"; break;
         case 500: oss << "Internal Server Error"; break;
+        case 503: oss << "Service Unavailable"; break;
         default: oss << "Unknown"; break;
     }
     oss << "\r\n";
@@ -372,17 +1879,70 @@ std::string WebServer::buildResponse(const HttpResponse& response) {
         oss << header.first << ": " << header.second << "\r\n";
     }
     
-    // Content-Length
-    oss << "Content-Length: " << response.body.length() << "\r\n";
+    // Content-Length（304 响应不带响应体，分块响应和事件流的长度未知）
+    if (response.producer || response.eventStream) {
+        oss << "Transfer-Encoding: chunked\r\n";
+    } else if (response.statusCode != 304) {
+        size_t contentLength = response.body.length();
+        if (response.file) {
+            contentLength = response.file->size;
+        } else if (response.staticBody) {
+            contentLength = response.staticBodySize;
+        }
+        oss << "Content-Length: " << contentLength << "\r\n";
+    }
     oss << "\r\n";
     
-    // 响应体
-    oss << response.body;
-    
     return oss.str();
 }
 
 void WebServer::registerDefaultRoutes() {
+    // 流式上传 WoS 导出文件（请求体为原始 HTML，无需 JSON 转义），返回上传ID供创建任务使用
+    registerStreamingRoute("POST", "/api/uploads",
+        [this](const HttpRequest&, HttpResponse&) -> std::shared_ptr<RequestBodySink> {
+            // 上传文件在工作线程中打开和写入，过期上传文件由任务调度线程定期清理
+            return std::make_shared<HtmlUploadSink>(*workerPool_);
+        },
+        [](const HttpRequest& req) -> HttpResponse {
+            HttpResponse res;
+            res.headers["Content-Type"] = "application/json; charset=utf-8";
+            
+            auto* sink = static_cast<HtmlUploadSink*>(req.bodySink.get());
+            auto it = req.params.find("fileName");
+            std::string fileName = it != req.params.end() ? it->second : "";
+            
+            json response;
+            if (!sink->finish()) {
+                response["success"] = false;
+                response["error"] = sink->error();
+                res.statusCode = sink->errorStatus();
+            } else if (sink->writer().size() == 0) {
+                response["success"] = false;
+                response["error"] = "上传文件为空";
+                res.statusCode = 400;
+            } else if (!sink->validator().isValid()) {
+                response["success"] = false;
+                response["error"] = "不是有效的 Web of Science 导出文件";
+                res.statusCode = 400;
+            } else {
+                std::string uploadId = sink->writer().commit();
+                if (uploadId.empty()) {
+                    response["success"] = false;
+                    response["error"] = "保存上传文件失败";
+                    res.statusCode = 500;
+                } else {
+                    Logger::getInstance().info("File uploaded: " + fileName + " -> " + uploadId);
+                    response["success"] = true;
+                    response["uploadId"] = uploadId;
+                    response["fileName"] = fileName;
+                    response["size"] = sink->writer().size();
+                    res.statusCode = 201;
+                }
+            }
+            res.body = response.dump();
+            return res;
+        });
+    
     // 任务相关API
     registerRoute("POST", "/api/tasks", [](const HttpRequest& req) -> HttpResponse {
         HttpResponse res;
@@ -440,8 +2000,36 @@ void WebServer::registerDefaultRoutes() {
             
             std::string taskId;
             
-            // 检查是否为多文件上传
-            if (reqBody.contains("fileNames") && reqBody.contains("htmlContents")) {
+            // 检查是否为已通过 /api/uploads 上传的文件
+            if (reqBody.contains("uploadIds")) {
+                std::vector<std::string> uploadIds = reqBody["uploadIds"].get<std::vector<std::string>>();
+                std::vector<std::string> fileNames;
+                if (reqBody.contains("fileNames")) {
+                    fileNames = reqBody["fileNames"].get<std::vector<std::string>>();
+                } else {
+                    fileNames.push_back(reqBody.value("fileName", ""));
+                }
+                
+                if (uploadIds.empty() || fileNames.size() != uploadIds.size()) {
+                    throw std::runtime_error("文件名和上传ID数量不匹配");
+                }
+                for (const auto& uploadId : uploadIds) {
+                    if (!StorageManager::getInstance().hasUpload(uploadId)) {
+                        throw std::runtime_error("上传文件不存在或已过期，请重新上传");
+                    }
+                }
+                
+                config.fileName = fileNames[0];
+                if (fileNames.size() > 1) {
+                    config.fileNames = fileNames;
+                }
+                
+                Logger::getInstance().info("Creating task from " + std::to_string(uploadIds.size()) + " uploaded files");
+                taskId = TaskQueue::getInstance().createTaskFromUploads(fileNames, uploadIds, config);
+                if (taskId.empty()) {
+                    throw std::runtime_error("创建任务失败");
+                }
+            } else if (reqBody.contains("fileNames") && reqBody.contains("htmlContents")) {
                 // 多文件上传
                 std::vector<std::string> fileNames = reqBody["fileNames"].get<std::vector<std::string>>();
                 std::vector<std::string> htmlContents = reqBody["htmlContents"].get<std::vector<std::string>>();
@@ -484,7 +2072,7 @@ void WebServer::registerDefaultRoutes() {
         }
         
         return res;
-    });
+    }, RouteClass::Upload);
     
     registerRoute("GET", "/api/tasks", [](const HttpRequest& req) -> HttpResponse {
         HttpResponse res;
@@ -495,19 +2083,7 @@ void WebServer::registerDefaultRoutes() {
             
             json response = json::array();
             for (const auto& task : tasks) {
-                json taskJson;
-                taskJson["taskId"] = task.taskId;
-                taskJson["taskName"] = task.taskName;
-                taskJson["fileName"] = task.fileName;
-                taskJson["modelName"] = task.modelName;
-                taskJson["modelCount"] = task.modelCount;
-                taskJson["status"] = static_cast<int>(task.status);
-                taskJson["totalCount"] = task.totalCount;
-                taskJson["completedCount"] = task.completedCount;
-                taskJson["failedCount"] = task.failedCount;
-                taskJson["createdAt"] = task.createdAt;
-                taskJson["updatedAt"] = task.updatedAt;
-                response.push_back(taskJson);
+                response.push_back(taskInfoToJson(task));
             }
             
             res.body = response.dump();
@@ -522,6 +2098,26 @@ void WebServer::registerDefaultRoutes() {
         
         return res;
     });
+
+#ifndef _WIN32
+    // 任务变化事件流（Server-Sent Events）：连接后先推送全部任务的快照（snapshot 事件），
+    // 之后推送发生变化的任务（task 事件，已删除的任务带 deleted 标志）
+    registerRoute("GET", "/api/events", [](const HttpRequest&) -> HttpResponse {
+        HttpResponse res;
+        res.headers["Content-Type"] = "text/event-stream; charset=utf-8";
+        res.headers["Cache-Control"] = "no-cache";
+        res.headers["X-Accel-Buffering"] = "no";
+        res.eventStream = true;
+        
+        json snapshot = json::array();
+        for (const auto& task : TaskQueue::getInstance().listTasks()) {
+            snapshot.push_back(taskInfoToJson(task));
+        }
+        res.body = "retry: 3000\nevent: snapshot\ndata: " + snapshot.dump() + "\n\n";
+        
+        return res;
+    });
+#endif
     
     registerRoute("GET", "/api/tasks/:id", [](const HttpRequest& req) -> HttpResponse {
         HttpResponse res;
@@ -561,39 +2157,29 @@ void WebServer::registerDefaultRoutes() {
         
         try {
             std::string taskId = req.params.at("id");
-            auto literatures = TaskQueue::getInstance().getTaskLiteratures(taskId);
-            
-            json response = json::array();
-            for (const auto& lit : literatures) {
-                json litJson;
-                litJson["index"] = lit.index;
-                litJson["recordNumber"] = lit.recordNumber;
-                litJson["totalRecords"] = lit.totalRecords;
-                litJson["sourceFileName"] = lit.sourceFileName;
-                litJson["sourceFileIndex"] = lit.sourceFileIndex;
-                litJson["indexInFile"] = lit.indexInFile;
-                litJson["originalTitle"] = lit.originalTitle;
-                litJson["originalAbstract"] = lit.originalAbstract;
-                litJson["translatedTitle"] = lit.translatedTitle;
-                litJson["translatedAbstract"] = lit.translatedAbstract;
-                litJson["authors"] = lit.authors;
-                litJson["source"] = lit.source;
-                litJson["volume"] = lit.volume;
-                litJson["issue"] = lit.issue;
-                litJson["pages"] = lit.pages;
-                litJson["doi"] = lit.doi;
-                litJson["earlyAccessDate"] = lit.earlyAccessDate;
-                litJson["publishedDate"] = lit.publishedDate;
-                litJson["accessionNumber"] = lit.accessionNumber;
-                litJson["issn"] = lit.issn;
-                litJson["eissn"] = lit.eissn;
-                litJson["status"] = lit.status;
-                litJson["errorMessage"] = lit.errorMessage;
-                litJson["translatedByModel"] = lit.translatedByModel;
-                response.push_back(litJson);
-            }
+            // 与 getTaskLiteratures 相同：任务不存在或索引无法读取时返回空数组（200），不返回 404
+            std::vector<int> indices = StorageManager::getInstance().loadIndexJson(taskId);
             
-            res.body = response.dump();
+            // 逐块读取文献并输出，不在内存中构建完整的 JSON 数组
+            res.producer = [taskId, indices, position = size_t(0)](std::string& chunk) mutable {
+                if (position == 0) {
+                    chunk = "[";
+                }
+                size_t end = std::min(indices.size(), position + STREAM_RECORDS_PER_CHUNK);
+                std::vector<int> batch(indices.begin() + position, indices.begin() + end);
+                for (const auto& lit : StorageManager::getInstance().loadLiteratureDataBatch(taskId, batch)) {
+                    if (position > 0) {
+                        chunk += ",";
+                    }
+                    chunk += literatureToJson(lit).dump();
+                    position++;
+                }
+                if (position < indices.size()) {
+                    return true;
+                }
+                chunk += "]";
+                return false;
+            };
             
         } catch (const std::exception& e) {
             json error;
@@ -606,7 +2192,7 @@ void WebServer::registerDefaultRoutes() {
         return res;
     });
     
-    registerRoute("GET", "/api/tasks/:id/literature/:index", [](const HttpRequest& req) -> HttpResponse {
+    registerRoute("GET", "/api/tasks/:id/literature/:index<int>", [](const HttpRequest& req) -> HttpResponse {
         HttpResponse res;
         res.headers["Content-Type"] = "application/json; charset=utf-8";
         
@@ -658,14 +2244,13 @@ void WebServer::registerDefaultRoutes() {
         return res;
     });
     
-    registerRoute("GET", "/api/tasks/:id/original.html", [](const HttpRequest& req) -> HttpResponse {
+    registerRoute("GET", "/api/tasks/:id/original.html", [this](const HttpRequest& req) -> HttpResponse {
         HttpResponse res;
         res.headers["Content-Type"] = "text/html; charset=utf-8";
         
         try {
             std::string taskId = req.params.at("id");
-            std::string html = TaskQueue::getInstance().getOriginalHtml(taskId);
-            res.body = html;
+            sendMappedFile(req, res, StorageManager::getInstance().mapOriginalHtml(taskId));
             
         } catch (const std::exception& e) {
             res.statusCode = 404;
@@ -673,16 +2258,15 @@ void WebServer::registerDefaultRoutes() {
         }
         
         return res;
-    });
+    }, RouteClass::Export);
     
-    registerRoute("GET", "/api/tasks/:id/translated.html", [](const HttpRequest& req) -> HttpResponse {
+    registerRoute("GET", "/api/tasks/:id/translated.html", [this](const HttpRequest& req) -> HttpResponse {
         HttpResponse res;
         res.headers["Content-Type"] = "text/html; charset=utf-8";
         
         try {
             std::string taskId = req.params.at("id");
-            std::string html = TaskQueue::getInstance().getTranslatedHtml(taskId);
-            res.body = html;
+            sendMappedFile(req, res, StorageManager::getInstance().mapTranslatedHtml(taskId));
             
         } catch (const std::exception& e) {
             res.statusCode = 404;
@@ -690,7 +2274,7 @@ void WebServer::registerDefaultRoutes() {
         }
         
         return res;
-    });
+    }, RouteClass::Export);
     
     registerRoute("PUT", "/api/tasks/:id/pause", [](const HttpRequest& req) -> HttpResponse {
         HttpResponse res;
@@ -808,20 +2392,21 @@ void WebServer::registerDefaultRoutes() {
             }
             
             // 重置失败的文献为pending
-            std::vector<int> indices = storage.loadIndexJson(taskId);
-            int resetCount = 0;
-            for (int idx : indices) {
-                LiteratureData lit = storage.loadLiteratureData(taskId, idx);
+            std::vector<LiteratureData> resetLiteratures;
+            for (auto& lit : storage.loadAllLiteratureData(taskId)) {
                 if (lit.status == "failed") {
                     lit.status = "pending";
                     lit.errorMessage = "";
                     lit.translatedTitle = "";
                     lit.translatedAbstract = "";
                     lit.translatedByModel = "";
-                    storage.saveLiteratureData(taskId, idx, lit);
-                    resetCount++;
+                    resetLiteratures.push_back(std::move(lit));
                 }
             }
+            int resetCount = static_cast<int>(resetLiteratures.size());
+            if (!resetLiteratures.empty()) {
+                storage.saveLiteratureBatch(taskId, resetLiteratures);
+            }
             
             // 更新任务状态
             config.failedCount = 0;
@@ -901,16 +2486,15 @@ void WebServer::registerDefaultRoutes() {
             }
             
             // 重置所有文献为pending
-            std::vector<int> indices = storage.loadIndexJson(taskId);
-            for (int idx : indices) {
-                LiteratureData lit = storage.loadLiteratureData(taskId, idx);
+            std::vector<LiteratureData> literatures = storage.loadAllLiteratureData(taskId);
+            for (auto& lit : literatures) {
                 lit.status = "pending";
                 lit.errorMessage = "";
                 lit.translatedTitle = "";
                 lit.translatedAbstract = "";
                 lit.translatedByModel = "";
-                storage.saveLiteratureData(taskId, idx, lit);
             }
+            storage.saveLiteratureBatch(taskId, literatures);
             
             // 更新任务状态
             config.completedCount = 0;
@@ -928,10 +2512,10 @@ void WebServer::registerDefaultRoutes() {
             
             json response;
             response["success"] = true;
-            response["resetCount"] = (int)indices.size();
+            response["resetCount"] = (int)literatures.size();
             res.body = response.dump();
             
-            Logger::getInstance().info("Reset entire task: " + taskId + ", reset " + std::to_string(indices.size()) + " items");
+            Logger::getInstance().info("Reset entire task: " + taskId + ", reset " + std::to_string(literatures.size()) + " items");
             
         } catch (const std::exception& e) {
             json error;
@@ -962,17 +2546,14 @@ void WebServer::registerDefaultRoutes() {
                 recordNumbers = reqBody["indices"].get<std::vector<int>>();
             }
             
-            // 获取所有文献
-            auto allLiteratures = TaskQueue::getInstance().getTaskLiteratures(taskId);
-            
-            // 筛选要导出的文献
-            std::vector<LiteratureData> literaturesToExport;
+            // 筛选要导出的文献（只记录索引，导出时再逐篇读取）
+            std::vector<int> exportIndices;
             if (recordNumbers.empty()) {
-                literaturesToExport = allLiteratures;
+                exportIndices = StorageManager::getInstance().loadIndexJson(taskId);
             } else {
-                for (const auto& lit : allLiteratures) {
+                for (const auto& lit : StorageManager::getInstance().loadAllLiteratureData(taskId)) {
                     if (std::find(recordNumbers.begin(), recordNumbers.end(), lit.recordNumber) != recordNumbers.end()) {
-                        literaturesToExport.push_back(lit);
+                        exportIndices.push_back(lit.index);
                     }
                 }
             }
@@ -1002,9 +2583,7 @@ void WebServer::registerDefaultRoutes() {
                 throw std::runtime_error("Unsupported format: " + format);
             }
             
-            // 导出
             auto taskInfo = TaskQueue::getInstance().getTaskInfo(taskId);
-            std::string content = Exporter::exportLiteratures(literaturesToExport, exportFormat, taskInfo.fileName);
             
             // 生成文件名
             std::string fileName = taskInfo.fileName;
@@ -1016,7 +2595,25 @@ void WebServer::registerDefaultRoutes() {
             
             res.headers["Content-Type"] = contentType;
             res.headers["Content-Disposition"] = "attachment; filename=\"" + fileName + "\"";
-            res.body = content;
+            
+            // 导出内容按块生成并发送
+            size_t total = exportIndices.size();
+            res.producer = [taskId, exportIndices, exportFormat, total, position = size_t(0)](std::string& chunk) mutable {
+                if (position == 0) {
+                    chunk = Exporter::beginExport(exportFormat, total);
+                }
+                size_t end = std::min(total, position + STREAM_RECORDS_PER_CHUNK);
+                std::vector<int> batch(exportIndices.begin() + position, exportIndices.begin() + end);
+                for (const auto& lit : StorageManager::getInstance().loadLiteratureDataBatch(taskId, batch)) {
+                    chunk += Exporter::exportRecord(exportFormat, lit, position, total);
+                    position++;
+                }
+                if (position < total) {
+                    return true;
+                }
+                chunk += Exporter::endExport(exportFormat, total);
+                return false;
+            };
             
         } catch (const std::exception& e) {
             res.headers["Content-Type"] = "application/json; charset=utf-8";
@@ -1028,7 +2625,7 @@ void WebServer::registerDefaultRoutes() {
         }
         
         return res;
-    });
+    }, RouteClass::Export);
     
     // HTML转JSON API
     registerRoute("POST", "/api/convert", [](const HttpRequest& req) -> HttpResponse {
@@ -1095,7 +2692,7 @@ void WebServer::registerDefaultRoutes() {
         }
         
         return res;
-    });
+    }, RouteClass::Upload);
     
     // 登出API
     registerRoute("POST", "/api/settings/logout", [this](const HttpRequest& req) -> HttpResponse {
@@ -1322,12 +2919,42 @@ void WebServer::registerDefaultRoutes() {
             response["maxModelsPerTask"] = config.maxModelsPerTask;
             response["maxRetries"] = config.maxRetries;
             response["consecutiveFailureThreshold"] = config.consecutiveFailureThreshold;
+            response["translationBatchSize"] = config.translationBatchSize;
+            response["translationBatchTokens"] = config.translationBatchTokens;
+            response["translationCombined"] = config.translationCombined;
+            response["translationCacheEnabled"] = config.translationCacheEnabled;
+            response["translationCacheMemoryMB"] = config.translationCacheMemoryMB;
+            response["translationCacheDiskMB"] = config.translationCacheDiskMB;
+            // 译文缓存统计（只读）
+            TranslationCache::Stats cacheStats = TranslationCache::getInstance().getStats();
+            response["translationCacheStats"] = {
+                {"hits", cacheStats.hits},
+                {"misses", cacheStats.misses},
+                {"memoryEntries", cacheStats.memoryEntries},
+                {"memoryBytes", cacheStats.memoryBytes},
+                {"diskEntries", cacheStats.diskEntries},
+                {"diskBytes", cacheStats.diskBytes}
+            };
             response["serverPort"] = config.serverPort;
             response["logLevel"] = config.logLevel;
             // 日志管理配置
             response["logManageMode"] = static_cast<int>(config.logManageMode);
             response["logRetentionDays"] = config.logRetentionDays;
             response["logArchiveIntervalDays"] = config.logArchiveIntervalDays;
+            // HTTP 服务器配置
+            response["httpWorkerThreads"] = config.httpWorkerThreads;
+            response["httpMaxPendingRequests"] = config.httpMaxPendingRequests;
+            response["httpMaxStaticRequests"] = config.httpMaxStaticRequests;
+            response["httpMaxApiRequests"] = config.httpMaxApiRequests;
+            response["httpMaxUploadRequests"] = config.httpMaxUploadRequests;
+            response["httpMaxExportRequests"] = config.httpMaxExportRequests;
+            response["httpMaxRequestBodyMB"] = config.httpMaxRequestBodyMB;
+            response["httpCompressionLevel"] = config.httpCompressionLevel;
+            response["httpCompressionMinBytes"] = config.httpCompressionMinBytes;
+            response["storageDurability"] = config.storageDurability;
+            response["storageSyncIntervalMs"] = config.storageSyncIntervalMs;
+            response["storageCompression"] = config.storageCompression;
+            response["storageEncoding"] = config.storageEncoding;
             // 不返回密码
             
             res.body = response.dump();
@@ -1382,6 +3009,26 @@ void WebServer::registerDefaultRoutes() {
             if (reqBody.contains("consecutiveFailureThreshold")) {
                 config.consecutiveFailureThreshold = reqBody["consecutiveFailureThreshold"];
             }
+            if (reqBody.contains("translationBatchSize")) {
+                config.translationBatchSize = reqBody["translationBatchSize"];
+            }
+            if (reqBody.contains("translationBatchTokens")) {
+                config.translationBatchTokens = reqBody["translationBatchTokens"];
+            }
+            if (reqBody.contains("translationCombined")) {
+                config.translationCombined = reqBody["translationCombined"];
+            }
+            if (reqBody.contains("translationCacheEnabled")) {
+                config.translationCacheEnabled = reqBody["translationCacheEnabled"];
+            }
+            if (reqBody.contains("translationCacheMemoryMB")) {
+                config.translationCacheMemoryMB = reqBody["translationCacheMemoryMB"];
+            }
+            if (reqBody.contains("translationCacheDiskMB")) {
+                config.translationCacheDiskMB = reqBody["translationCacheDiskMB"];
+            }
+            TranslationCache::getInstance().configure(config.translationCacheEnabled, config.translationCacheMemoryMB,
+                                                      config.translationCacheDiskMB);
             if (reqBody.contains("logLevel")) {
                 config.logLevel = reqBody["logLevel"];
             }
@@ -1409,6 +3056,51 @@ void WebServer::registerDefaultRoutes() {
                 Logger::getInstance().setLogArchiveIntervalDays(config.logArchiveIntervalDays);
             }
             
+            // HTTP 服务器配置（线程数和等待队列长度重启后生效，其余立即生效）
+            if (reqBody.contains("httpWorkerThreads")) {
+                config.httpWorkerThreads = reqBody["httpWorkerThreads"];
+            }
+            if (reqBody.contains("httpMaxPendingRequests")) {
+                config.httpMaxPendingRequests = reqBody["httpMaxPendingRequests"];
+            }
+            if (reqBody.contains("httpMaxStaticRequests")) {
+                config.httpMaxStaticRequests = reqBody["httpMaxStaticRequests"];
+            }
+            if (reqBody.contains("httpMaxApiRequests")) {
+                config.httpMaxApiRequests = reqBody["httpMaxApiRequests"];
+            }
+            if (reqBody.contains("httpMaxUploadRequests")) {
+                config.httpMaxUploadRequests = reqBody["httpMaxUploadRequests"];
+            }
+            if (reqBody.contains("httpMaxExportRequests")) {
+                config.httpMaxExportRequests = reqBody["httpMaxExportRequests"];
+            }
+            if (reqBody.contains("httpMaxRequestBodyMB")) {
+                config.httpMaxRequestBodyMB = reqBody["httpMaxRequestBodyMB"];
+            }
+            if (reqBody.contains("httpCompressionLevel")) {
+                config.httpCompressionLevel = reqBody["httpCompressionLevel"];
+            }
+            if (reqBody.contains("httpCompressionMinBytes")) {
+                config.httpCompressionMinBytes = reqBody["httpCompressionMinBytes"];
+            }
+            applyHttpLimits(config);
+            if (reqBody.contains("storageDurability")) {
+                config.storageDurability = reqBody["storageDurability"];
+            }
+            if (reqBody.contains("storageSyncIntervalMs")) {
+                config.storageSyncIntervalMs = reqBody["storageSyncIntervalMs"];
+            }
+            if (reqBody.contains("storageCompression")) {
+                config.storageCompression = reqBody["storageCompression"];
+            }
+            if (reqBody.contains("storageEncoding")) {
+                config.storageEncoding = reqBody["storageEncoding"];
+            }
+            StorageManager::getInstance().setDurability(config.storageDurability, config.storageSyncIntervalMs);
+            StorageManager::getInstance().setCompression(config.storageCompression);
+            StorageManager::getInstance().setEncoding(config.storageEncoding);
+            
             // 如果要修改密码
             if (reqBody.contains("oldPassword") && reqBody.contains("newPassword")) {
                 std::string oldPassword = reqBody["oldPassword"];
@@ -1782,76 +3474,92 @@ void WebServer::registerDefaultRoutes() {
     });
 }
 
-bool WebServer::matchRoute(const std::string& pattern, const std::string& path, 
-                           std::map<std::string, std::string>& params) {
-    std::vector<std::string> patternParts = split(pattern, '/');
-    std::vector<std::string> pathParts = split(path, '/');
-    
-    // 如果模式部分数量大于路径部分数量，肯定不匹配
-    if (patternParts.size() > pathParts.size()) {
-        return false;
-    }
-    
-    // 找出参数位置和参数后面的固定部分数量
-    int paramIndex = -1;
-    for (size_t i = 0; i < patternParts.size(); i++) {
-        if (!patternParts[i].empty() && patternParts[i][0] == ':') {
-            paramIndex = static_cast<int>(i);
-            break;
-        }
+const WebServer::RouteNode* WebServer::findRoute(const std::string& method, const std::string& path,
+                                                 std::map<std::string, std::string>* params) {
+    auto root = routeTrie_.find(method);
+    if (root == routeTrie_.end()) {
+        return nullptr;
     }
     
-    // 如果没有参数，部分数量必须相等且完全匹配
-    if (paramIndex < 0) {
-        if (patternParts.size() != pathParts.size()) {
-            return false;
+    // 将路径切分为段（只记录位置，不复制字符串）
+    std::string_view segments[MAX_ROUTE_SEGMENTS];
+    size_t count = 0;
+    size_t pos = 0;
+    while (pos < path.size()) {
+        size_t next = path.find('/', pos);
+        if (next == std::string::npos) {
+            next = path.size();
         }
-        for (size_t i = 0; i < patternParts.size(); i++) {
-            if (patternParts[i] != pathParts[i]) {
-                return false;
+        if (next > pos) {
+            if (count == MAX_ROUTE_SEGMENTS) {
+                return nullptr;
             }
+            segments[count++] = std::string_view(path.data() + pos, next - pos);
         }
-        return true;
+        pos = next + 1;
     }
     
-    // 计算参数后面有多少个固定部分
-    size_t suffixCount = patternParts.size() - paramIndex - 1;
+    RouteCapture captures[MAX_ROUTE_SEGMENTS];
+    size_t captureCount = 0;
+    const RouteNode* node = matchRouteNode(*root->second, segments, count, 0, captures, captureCount);
+    if (!node) {
+        return nullptr;
+    }
     
-    // 路径部分数量必须至少等于：参数前的部分 + 1(参数本身至少1个) + 后缀部分
-    if (pathParts.size() < static_cast<size_t>(paramIndex) + 1 + suffixCount) {
-        return false;
+    // 多段参数的值为原路径中对应的连续区间
+    for (size_t i = 0; params && i < captureCount; i++) {
+        const char* begin = segments[captures[i].first].data();
+        const char* end = segments[captures[i].last - 1].data() + segments[captures[i].last - 1].size();
+        (*params)[*captures[i].name] = std::string(begin, end);
+    }
+    return node;
+}
+
+const WebServer::RouteNode* WebServer::matchRouteNode(const RouteNode& node, const std::string_view* segments,
+                                                      size_t count, size_t pos,
+                                                      RouteCapture* captures, size_t& captureCount) {
+    if (pos == count) {
+        return node.handler ? &node : nullptr;
     }
     
-    // 匹配参数前的固定部分
-    for (int i = 0; i < paramIndex; i++) {
-        if (patternParts[i] != pathParts[i]) {
-            return false;
+    // 固定段优先于参数
+    auto it = node.children.find(segments[pos]);
+    if (it != node.children.end()) {
+        const RouteNode* found = matchRouteNode(*it->second, segments, count, pos + 1, captures, captureCount);
+        if (found) {
+            return found;
         }
     }
     
-    // 匹配参数后的固定部分（从后往前）
-    for (size_t i = 0; i < suffixCount; i++) {
-        size_t patternIdx = patternParts.size() - 1 - i;
-        size_t pathIdx = pathParts.size() - 1 - i;
-        if (patternParts[patternIdx] != pathParts[pathIdx]) {
-            return false;
-        }
+    if (!node.paramChild) {
+        return nullptr;
     }
     
-    // 提取参数值（中间的所有部分）
-    std::string paramName = patternParts[paramIndex].substr(1);
-    size_t paramEndIdx = pathParts.size() - suffixCount;
-    std::string paramValue;
-    for (size_t i = paramIndex; i < paramEndIdx; i++) {
-        if (i > static_cast<size_t>(paramIndex)) paramValue += "/";
-        paramValue += pathParts[i];
+    size_t maxSpan = 1;
+    if (node.paramType == RouteNode::ParamType::Int) {
+        const std::string_view& segment = segments[pos];
+        if (!std::all_of(segment.begin(), segment.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            return nullptr;
+        }
+    } else {
+        maxSpan = count - pos;
     }
-    params[paramName] = paramValue;
     
-    return true;
+    // 参数尽量少占用路径段，使后面更具体的固定段能够匹配
+    for (size_t span = 1; span <= maxSpan; span++) {
+        captures[captureCount] = RouteCapture{&node.paramName, pos, pos + span};
+        captureCount++;
+        const RouteNode* found = matchRouteNode(*node.paramChild, segments, count, pos + span, captures, captureCount);
+        if (found) {
+            return found;
+        }
+        captureCount--;
+    }
+    return nullptr;
 }
 
-HttpResponse WebServer::serveStaticFile(const std::string& path) {
+HttpResponse WebServer::serveStaticFile(const HttpRequest& request) {
+    const std::string& path = request.path;
     HttpResponse response;
     
     // 安全检查：防止目录遍历攻击
@@ -1863,22 +3571,22 @@ HttpResponse WebServer::serveStaticFile(const std::string& path) {
     
     // 首先尝试从嵌入式资源获取
 #ifdef EMBED_RESOURCES
-    const EmbeddedResource* embedded = getEmbeddedResource(path);
+    // 可压缩的资源在构建时已预压缩为 gzip，客户端支持时直接发送压缩版本
+    const EmbeddedResource* embedded = getEmbeddedResource(path, acceptsEncoding(request, "gzip"));
+    
     if (embedded) {
-        response.body = std::string(reinterpret_cast<const char*>(embedded->data), embedded->size);
+        // 直接引用静态数组，不复制
         response.headers["Content-Type"] = embedded->mimeType;
-        return response;
-    }
-    
-    // 尝试 /index.html
-    if (path == "/" || path.back() == '/') {
-        std::string indexPath = path + "index.html";
-        embedded = getEmbeddedResource(indexPath);
-        if (embedded) {
-            response.body = std::string(reinterpret_cast<const char*>(embedded->data), embedded->size);
-            response.headers["Content-Type"] = embedded->mimeType;
+        response.headers["Vary"] = "Accept-Encoding";
+        if (embedded->contentEncoding) {
+            response.headers["Content-Encoding"] = embedded->contentEncoding;
+        }
+        if (applyCacheHeaders(request, response, embedded->etag)) {
             return response;
         }
+        response.staticBody = reinterpret_cast<const char*>(embedded->data);
+        response.staticBodySize = embedded->size;
+        return response;
     }
 #endif
     
@@ -1892,26 +3600,201 @@ HttpResponse WebServer::serveStaticFile(const std::string& path) {
         filePath += "/index.html";
     }
     
-    // 读取文件
-    std::ifstream file(filePath, std::ios::binary);
-    if (!file.is_open()) {
+    int fd = platform_open_file(filePath.c_str());
+    if (fd < 0) {
         response.statusCode = 404;
         response.body = "404 Not Found";
         return response;
     }
+    auto file = std::make_shared<ResponseFile>();
+    file->fd = fd;
     
-    // 读取文件内容
-    std::ostringstream oss;
-    oss << file.rdbuf();
-    response.body = oss.str();
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        response.statusCode = 404;
+        response.body = "404 Not Found";
+        return response;
+    }
+    file->size = static_cast<size_t>(st.st_size);
     
     // 设置Content-Type
     std::string ext = getFileExtension(filePath);
     response.headers["Content-Type"] = getMimeType(ext);
     
+    if (applyCacheHeaders(request, response, getFileEtag(filePath, st))) {
+        return response;
+    }
+    
+    // 文件内容由 sendfile 直接发送
+    response.file = file;
     return response;
 }
 
+std::string WebServer::getFileEtag(const std::string& filePath, const struct stat& st) {
+    {
+        std::lock_guard<std::mutex> lock(fileEtagMutex_);
+        auto it = fileEtags_.find(filePath);
+        if (it != fileEtags_.end() && it->second.mtime == st.st_mtime &&
+            it->second.size == static_cast<size_t>(st.st_size)) {
+            return it->second.etag;
+        }
+    }
+    
+    // 文件首次访问或已修改时重新计算内容哈希
+    uint64_t hash = 14695981039346656037ULL;
+    std::ifstream file(filePath, std::ios::binary);
+    char buffer[65536];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        hash = fnv1a64(buffer, static_cast<size_t>(file.gcount()), hash);
+    }
+    
+    FileEtag entry;
+    entry.mtime = st.st_mtime;
+    entry.size = static_cast<size_t>(st.st_size);
+    entry.etag = formatEtag(hash);
+    
+    std::lock_guard<std::mutex> lock(fileEtagMutex_);
+    fileEtags_[filePath] = entry;
+    return entry.etag;
+}
+
+bool WebServer::applyCacheHeaders(const HttpRequest& request, HttpResponse& response, const std::string& etag) {
+    // 页面和脚本每次都向服务器校验，其他资源（图片、字体等）允许缓存一天
+    const std::string& contentType = response.headers["Content-Type"];
+    if (contentType.find("html") != std::string::npos ||
+        contentType.find("javascript") != std::string::npos ||
+        contentType.find("css") != std::string::npos) {
+        response.headers["Cache-Control"] = "no-cache";
+    } else {
+        response.headers["Cache-Control"] = "public, max-age=86400";
+    }
+    response.headers["ETag"] = etag;
+    
+    if (etagMatches(findHeader(request, "If-None-Match"), etag)) {
+        response.statusCode = 304;
+        response.body.clear();
+        return true;
+    }
+    return false;
+}
+
+// 处理单个字节范围的 Range 请求（bytes=a-b、bytes=a-、bytes=-n），截取 staticBody 响应体：
+// 范围有效时改为 206，起点超出内容长度时返回 416；多个范围、无法解析或 If-Range 与 ETag
+// 不一致（文件已变化）时忽略 Range，发送完整内容
+static void applyByteRange(const HttpRequest& request, HttpResponse& response, const std::string& etag) {
+    response.headers["Accept-Ranges"] = "bytes";
+    
+    std::string range = findHeader(request, "Range");
+    if (range.compare(0, 6, "bytes=") != 0 || range.find(',') != std::string::npos) {
+        return;
+    }
+    std::string ifRange = findHeader(request, "If-Range");
+    if (!ifRange.empty() && ifRange != etag) {
+        return;
+    }
+    
+    std::string spec = range.substr(6);
+    spec.erase(0, spec.find_first_not_of(" \t"));
+    spec.erase(spec.find_last_not_of(" \t") + 1);
+    size_t dash = spec.find('-');
+    if (dash == std::string::npos) {
+        return;
+    }
+    std::string first = spec.substr(0, dash);
+    std::string last = spec.substr(dash + 1);
+    auto isNumber = [](const std::string& s) {
+        return !s.empty() && s.size() <= 19 && s.find_first_not_of("0123456789") == std::string::npos;
+    };
+    
+    uint64_t total = response.staticBodySize;
+    uint64_t start;
+    uint64_t end;
+    if (first.empty()) {
+        // 后缀范围：最后 n 个字节
+        if (!isNumber(last)) {
+            return;
+        }
+        uint64_t suffix = std::stoull(last);
+        start = suffix >= total ? 0 : total - suffix;
+        end = total == 0 ? 0 : total - 1;
+        if (suffix == 0) {
+            start = total;
+        }
+    } else {
+        if (!isNumber(first) || (!last.empty() && !isNumber(last))) {
+            return;
+        }
+        start = std::stoull(first);
+        end = last.empty() ? start : std::stoull(last);
+        if (end < start) {
+            return;
+        }
+        if (last.empty() || end >= total) {
+            end = total == 0 ? 0 : total - 1;
+        }
+    }
+    
+    if (start >= total) {
+        response.statusCode = 416;
+        response.headers["Content-Range"] = "bytes */" + std::to_string(total);
+        response.staticBody = nullptr;
+        response.staticBodySize = 0;
+        response.staticBodyOwner.reset();
+        return;
+    }
+    response.statusCode = 206;
+    response.headers["Content-Range"] = "bytes " + std::to_string(start) + "-" + std::to_string(end) +
+                                        "/" + std::to_string(total);
+    response.staticBody += start;
+    response.staticBodySize = static_cast<size_t>(end - start + 1);
+}
+
+void WebServer::sendMappedFile(const HttpRequest& request, HttpResponse& response,
+                               const std::shared_ptr<MappedFile>& mapped) {
+    if (!mapped) {
+        response.statusCode = 404;
+        response.body = "404 Not Found";
+        return;
+    }
+    
+    // 压缩保存的文件：客户端接受该编码时直接发送压缩数据，否则解压后发送
+    bool passThrough = true;
+    if (!mapped->encoding().empty()) {
+        response.headers["Vary"] = "Accept-Encoding";
+        passThrough = acceptsEncoding(request, mapped->encoding());
+    }
+    
+    // ETag 由修改时间和大小得出，文件以 rename 替换后随之变化，用于 If-None-Match 和断点续传的 If-Range；
+    // 压缩数据与解压后的内容是不同的表示，ETag 也不同
+    int64_t version[3] = { mapped->mtime(), static_cast<int64_t>(mapped->size()), passThrough ? 0 : 1 };
+    std::string etag = formatEtag(fnv1a64(version, sizeof(version)));
+    if (applyCacheHeaders(request, response, etag)) {
+        return;
+    }
+    
+    if (!passThrough) {
+        auto content = std::make_shared<std::string>();
+        if (!StorageManager::decodeMappedFile(*mapped, *content)) {
+            response.statusCode = 500;
+            response.body = "500 Internal Server Error";
+            return;
+        }
+        response.staticBody = content->data();
+        response.staticBodySize = content->size();
+        response.staticBodyOwner = content;
+    } else {
+        // 响应体直接指向映射的内容，由 I/O 线程从映射区发送，不复制到 body
+        response.staticBody = mapped->size() > 0 ? mapped->data() : "";
+        response.staticBodySize = mapped->size();
+        response.staticBodyOwner = mapped;
+        if (!mapped->encoding().empty()) {
+            // 压缩数据不支持按范围续传（浏览器不续传带内容编码的下载）
+            response.headers["Content-Encoding"] = mapped->encoding();
+            return;
+        }
+    }
+    applyByteRange(request, response, etag);
+}
+
 void WebServer::parseQueryString(const std::string& query, 
                                  std::map<std::string, std::string>& params) {
     std::istringstream stream(query);
@@ -178,6 +178,29 @@ function getTaskStatusDisplay(status) {
     return TaskStatus[status] || TaskStatus[5];
 }
 
+// 订阅任务变化事件（Server-Sent Events）：连接后收到全部任务的快照，之后收到变化的任务。
+// 浏览器或服务器不支持事件流时调用 onUnavailable，由页面回退为定时轮询
+function subscribeTaskEvents(onSnapshot, onTask, onUnavailable) {
+    if (!window.EventSource) {
+        onUnavailable();
+        return null;
+    }
+    const source = new EventSource('/api/events');
+    source.addEventListener('snapshot', function(event) {
+        onSnapshot(JSON.parse(event.data));
+    });
+    source.addEventListener('task', function(event) {
+        onTask(JSON.parse(event.data));
+    });
+    source.onerror = function() {
+        // 连接断开时 EventSource 会自动重连；连接被拒绝（如 404）时不再重连
+        if (source.readyState === EventSource.CLOSED) {
+            onUnavailable();
+        }
+    };
+    return source;
+}
+
 // 验证HTML文件
 function validateHtmlFile(file) {
     // 检查文件扩展名
@@ -1,5 +1,6 @@
 let tasks = [];
 let refreshInterval = null;
+let taskEvents = null;
 let currentLayout = localStorage.getItem('queueLayout') || 'list';
 let currentDateFilter = null;
 let currentSearchQuery = '';
@@ -13,14 +14,22 @@ document.addEventListener('DOMContentLoaded', function() {
     calendarMonth = today.getMonth();
     currentDateFilter = formatDate(today);
     updateCalendarLabel();
-    loadTasks();
     setupEventListeners();
     updateLayoutButtons();
-    refreshInterval = setInterval(loadTasks, 3000);
+    // 任务进度由服务器推送，不支持事件流时回退为每 3 秒轮询
+    taskEvents = subscribeTaskEvents(function(snapshot) {
+        tasks = snapshot;
+        if (calendarOpen) renderCalendar();
+        renderTasks();
+    }, applyTaskUpdate, function() {
+        loadTasks();
+        if (!refreshInterval) refreshInterval = setInterval(loadTasks, 3000);
+    });
 });
 
 window.addEventListener('beforeunload', function() {
     if (refreshInterval) clearInterval(refreshInterval);
+    if (taskEvents) taskEvents.close();
 });
 
 function formatDate(d) {
@@ -257,6 +266,23 @@ async function loadTasks() {
     }
 }
 
+// 合并服务器推送的单个任务变化
+function applyTaskUpdate(task) {
+    var index = tasks.findIndex(function(t) { return t.taskId === task.taskId; });
+    if (task.deleted) {
+        if (index < 0) return;
+        tasks.splice(index, 1);
+    } else if (index >= 0) {
+        tasks[index] = task;
+    } else {
+        // 新任务按创建时间倒序插入
+        var position = tasks.findIndex(function(t) { return t.createdAt < task.createdAt; });
+        tasks.splice(position < 0 ? tasks.length : position, 0, task);
+    }
+    if (calendarOpen) renderCalendar();
+    renderTasks();
+}
+
 function renderTasks() {
     var taskList = document.getElementById('taskList');
     var filterInfo = document.getElementById('filterInfo');
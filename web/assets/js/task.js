@@ -3,6 +3,8 @@ let task = null;
 let literatures = [];
 let selectedIds = new Set();
 let refreshInterval = null;
+let taskEvents = null;
+let reloadTimer = null;
 let currentView = 'list';
 let currentLitIndex = 0;
 let showEnglish = false;
@@ -19,11 +21,26 @@ document.addEventListener('DOMContentLoaded', function() {
     loadTask();
     setupEventListeners();
     setupKeyboardNavigation();
-    refreshInterval = setInterval(loadTask, 2000);
+    // 仅在当前任务发生变化时重新加载（最多每 2 秒一次），不支持事件流时回退为每 2 秒轮询
+    taskEvents = subscribeTaskEvents(function(snapshot) {
+        // 重连后的快照：断线期间任务有变化时重新加载
+        var current = snapshot.find(function(t) { return t.taskId === taskId; });
+        if (task && current && current.updatedAt !== task.updatedAt) loadTask();
+    }, function(changed) {
+        if (changed.taskId === taskId && !reloadTimer) {
+            reloadTimer = setTimeout(function() {
+                reloadTimer = null;
+                loadTask();
+            }, 2000);
+        }
+    }, function() {
+        if (!refreshInterval) refreshInterval = setInterval(loadTask, 2000);
+    });
 });
 
 window.addEventListener('beforeunload', function() {
     if (refreshInterval) clearInterval(refreshInterval);
+    if (taskEvents) taskEvents.close();
 });
 
 function setupEventListeners() {
@@ -127,6 +144,7 @@ async function loadTask() {
         updateSelection();
     } catch (error) {
         if (refreshInterval) clearInterval(refreshInterval);
+        if (taskEvents) taskEvents.close();
         document.getElementById('literatureContent').innerHTML = '<div class="p-8 text-center text-red-500">加载失败: ' + error.message + '</div>';
     }
 }
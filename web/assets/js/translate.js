@@ -213,7 +213,8 @@ async function handleMultipleFiles(files) {
                 continue;
             }
             const count = estimateLiteratureCount(content);
-            selectedFiles.push({ file, content, count });
+            // 文件内容在创建任务时以原始数据上传，这里不再保留
+            selectedFiles.push({ file, count });
         } catch (error) {
             showToast('读取 ' + file.name + ' 失败: ' + error.message, 'error');
         }
@@ -258,6 +259,25 @@ function removeFile(index) {
     updateCreateButton();
 }
 
+// 以原始 HTML 流式上传文件，返回上传ID
+async function uploadFile(file) {
+    const headers = { 'Content-Type': 'text/html; charset=utf-8' };
+    const token = getSessionToken();
+    if (token) {
+        headers['X-Session-Token'] = token;
+    }
+    const response = await fetch(API_BASE + '/api/uploads?fileName=' + encodeURIComponent(file.name), {
+        method: 'POST',
+        headers,
+        body: file
+    });
+    const result = await response.json();
+    if (!response.ok || !result.success) {
+        throw new Error(file.name + ': ' + (result.error || '上传失败'));
+    }
+    return result.uploadId;
+}
+
 async function createTranslationTask() {
     if (selectedFiles.length === 0) {
         showToast('请先上传文件', 'warning');
@@ -275,7 +295,7 @@ async function createTranslationTask() {
     }
 
     try {
-        showLoading('正在创建任务...');
+        showLoading('正在上传文件并创建任务...');
 
         // 构建模型配置数组
         const modelConfigs = selectedModels.map(m => ({
@@ -312,12 +332,16 @@ async function createTranslationTask() {
             modelConfigs
         };
 
+        const uploadIds = [];
+        for (const item of selectedFiles) {
+            uploadIds.push(await uploadFile(item.file));
+        }
+        requestData.uploadIds = uploadIds;
+
         if (selectedFiles.length === 1) {
             requestData.fileName = selectedFiles[0].file.name;
-            requestData.htmlContent = selectedFiles[0].content;
         } else {
             requestData.fileNames = selectedFiles.map(f => f.file.name);
-            requestData.htmlContents = selectedFiles.map(f => f.content);
         }
 
         const result = await apiCall('POST', '/api/tasks', requestData);